@@ -44,7 +44,6 @@ public:
          }
     
     // 然后打乱顺序
-        std::random_device rd;
         std::mt19937_64 rng(42);  // 使用固定种子保证可重复
         std::shuffle(data. begin(), data.end(), rng);
             
@@ -74,9 +73,8 @@ public:
             data[i] = i + 1;
         }
         
-        // 打乱前一半数据
-        std::random_device rd;
-        std::mt19937 rng(rd());
+        // 打乱前一半数据（固定种子，与 generate_and_save_random 一致）
+        std::mt19937_64 rng(42);
         std::shuffle(data.begin(), data.begin() + size / 2, rng);
         
         save_to_file(data, filename);
@@ -0,0 +1,186 @@
+#pragma once
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace data {
+
+/**
+ * trace 中一条操作的类型
+ */
+enum class TraceOp : uint8_t { Lookup = 0, Range = 1, Insert = 2, Erase = 3 };
+
+/**
+ * 查询 trace 文件头（64 字节）
+ * 文件格式（按列存放，纯点查 trace 只有 key 一列，回放时顺序读）：
+ *   header
+ *   uint64 key[count]
+ *   uint64 end[count]   flags & has_range_ends 时存在，Range 操作的上界（含）
+ *   uint8  op[count]    flags & has_ops 时存在；没有时全部为 Lookup
+ * open() 只校验文件头和长度，不认识的操作类型由回放方跳过
+ */
+struct QueryTraceHeader {
+    char signature[8];      // "qtrace"
+    uint32_t version;       // 1
+    uint32_t flags;
+    uint64_t count;
+    uint64_t reserved[5];
+};
+
+/**
+ * 以 mmap 方式读取的查询 trace，write() 把任意负载写成同样格式的文件
+ * 打开时按顺序访问提示内核预读，回放直接在映射上流式进行，不拷贝
+ */
+class QueryTrace {
+public:
+    static constexpr uint32_t has_range_ends = 1;
+    static constexpr uint32_t has_ops = 2;
+
+    QueryTrace() = default;
+    ~QueryTrace() { close(); }
+
+    QueryTrace(const QueryTrace&) = delete;
+    QueryTrace& operator=(const QueryTrace&) = delete;
+
+    /**
+     * 写出 trace；ends / ops 为空时不写对应的列
+     */
+    static bool write(const std::string& path, const uint64_t* keys, size_t count,
+                      const uint64_t* ends = nullptr, const TraceOp* ops = nullptr) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Error: Cannot create file " << path << std::endl;
+            return false;
+        }
+
+        QueryTraceHeader header = {};
+        const char signature[8] = {'q', 't', 'r', 'a', 'c', 'e', 0, 0};
+        std::copy(signature, signature + 8, header.signature);
+        header.version = 1;
+        header.flags = (ends ? has_range_ends : 0) | (ops ? has_ops : 0);
+        header.count = count;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(keys), count * sizeof(uint64_t));
+        if (ends) file.write(reinterpret_cast<const char*>(ends), count * sizeof(uint64_t));
+        if (ops) file.write(reinterpret_cast<const char*>(ops), count * sizeof(TraceOp));
+        return file.good();
+    }
+
+    /**
+     * 映射 trace 文件，格式不符时返回 false
+     */
+    bool open(const std::string& path) {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(QueryTraceHeader)) {
+            ::close(fd);
+            return false;
+        }
+
+        void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+
+        m_base = static_cast<const char*>(p);
+        m_bytes = st.st_size;
+
+        if (!valid()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (m_base) munmap(const_cast<char*>(m_base), m_bytes);
+        m_base = nullptr;
+        m_bytes = 0;
+    }
+
+    size_t size() const { return m_base ? header().count : 0; }
+    bool has_ranges() const { return m_base && (header().flags & has_range_ends); }
+    bool has_op_tags() const { return m_base && (header().flags & has_ops); }
+
+    const uint64_t* keys() const {
+        return reinterpret_cast<const uint64_t*>(m_base + sizeof(QueryTraceHeader));
+    }
+
+    /// Range 操作的上界，没有这一列时为 nullptr
+    const uint64_t* ends() const {
+        return has_ranges() ? keys() + size() : nullptr;
+    }
+
+    /// 操作类型列，没有这一列时为 nullptr
+    const TraceOp* ops() const {
+        if (!has_op_tags()) return nullptr;
+        return reinterpret_cast<const TraceOp*>(keys() + size() * (has_ranges() ? 2 : 1));
+    }
+
+    TraceOp op(size_t i) const {
+        const TraceOp* o = ops();
+        return o ? o[i] : TraceOp::Lookup;
+    }
+
+    static const char* op_name(TraceOp op) {
+        switch (op) {
+            case TraceOp::Lookup: return "lookup";
+            case TraceOp::Range:  return "range";
+            case TraceOp::Insert: return "insert";
+            case TraceOp::Erase:  return "erase";
+        }
+        return "?";
+    }
+
+private:
+    const QueryTraceHeader& header() const {
+        return *reinterpret_cast<const QueryTraceHeader*>(m_base);
+    }
+
+    bool valid() const {
+        const QueryTraceHeader& h = header();
+        const char signature[8] = {'q', 't', 'r', 'a', 'c', 'e', 0, 0};
+        if (!std::equal(signature, signature + 8, h.signature) || h.version != 1) return false;
+
+        size_t per_op = sizeof(uint64_t)
+                      + ((h.flags & has_range_ends) ? sizeof(uint64_t) : 0)
+                      + ((h.flags & has_ops) ? sizeof(TraceOp) : 0);
+        if (h.count > (m_bytes - sizeof(QueryTraceHeader)) / per_op) return false;
+        return sizeof(QueryTraceHeader) + h.count * per_op == m_bytes;
+    }
+
+    const char* m_base = nullptr;
+    size_t m_bytes = 0;
+};
+
+/**
+ * 全局选项 --trace=<file> / --record=<file>（见 SOSDDataLoader::generate_queries）
+ *   replay: 非空时查询负载改为 trace 中的点查 key，不再随机生成
+ *   record: 非空时把生成的查询负载写成 trace（多次生成时保留最后一次）
+ */
+class TraceConfig {
+public:
+    static std::string& replay_path() {
+        static std::string path;
+        return path;
+    }
+
+    static std::string& record_path() {
+        static std::string path;
+        return path;
+    }
+};
+
+} // namespace data
@@ -5,22 +5,43 @@
 #include <fstream>
 #include <iostream>
 #include <random>
+#include <algorithm>
+#include <utility>
+#include "../utils/HugePageAllocator.hpp"
+#include "../utils/RadixSort.hpp"
+#include "QueryTrace.hpp"
 
 namespace data {
 
+/**
+ * key / 查询缓冲区，页大小由 utils::PageConfig 决定
+ */
+using KeyVector = utils::huge_vector<uint64_t>;
+
 /**
  * SOSD 数据集加载器
  * 支持加载 SOSD 项目的二进制数据文件
  */
 class SOSDDataLoader {
 public:
+    /**
+     * 数据集名 -> 文件路径（data/<name>_uint64）
+     */
+    static std::string dataset_path(const std::string& dataset_name) {
+        std::string data_file = "data/" + dataset_name;
+        if (data_file.find("_uint64") == std::string::npos) {
+            data_file += "_uint64";
+        }
+        return data_file;
+    }
+    
     /**
      * 从二进制文件加载 uint64 数据
      * @param filename 文件名（不含路径）
      * @param max_size 最大加载数量，0 表示加载全部
      * @return 数据向量
      */
-    static std::vector<uint64_t> load_binary_file(
+    static KeyVector load_binary_file(
         const std::string& filename, 
         size_t max_size = 0
     ) {
@@ -40,14 +61,36 @@ public:
             num_elements = max_size;
         }
         
-        std::vector<uint64_t> data(num_elements);
+        KeyVector data(num_elements);
         file.read(reinterpret_cast<char*>(data.data()), num_elements * sizeof(uint64_t));
         file.close();
         
-        std::cout << "    Loaded " << data.size() << " keys from " << filename << std::endl;
+        std::cout << "    Loaded " << data.size() << " keys from " << filename
+                  << " (" << utils::PageRegistry::instance().backing(data.data()) << " pages)" << std::endl;
         return data;
     }
     
+    /**
+     * 生成 bulk_load 所需的有序、去重 (key, key) 对
+     * 排序和去重使用并行基数排序（utils::ParallelRadixSort），去重时直接写出键值对
+     * @param data 源数据（可以无序、有重复）
+     * @return 按 key 排序的键值对
+     */
+    static std::vector<std::pair<uint64_t, uint64_t>> to_sorted_pairs(
+        const KeyVector& data
+    ) {
+        std::vector<uint64_t> sorted(data.begin(), data.end());
+        if (!std::is_sorted(sorted.begin(), sorted.end())) {
+            utils::ParallelRadixSort::sort(sorted.data(), sorted.size());
+        }
+        
+        std::vector<std::pair<uint64_t, uint64_t>> pairs(sorted.size());
+        size_t unique = utils::ParallelRadixSort::unique(sorted.data(), sorted.size(),
+            [&pairs](size_t i, uint64_t key) { pairs[i] = {key, key}; });
+        pairs.resize(unique);
+        return pairs;
+    }
+    
     /**
      * 从已加载的数据中生成查询负载
      * @param data 源数据
@@ -55,12 +98,19 @@ public:
      * @param seed 随机种子
      * @return 查询向量
      */
-    static std::vector<uint64_t> generate_queries(
-        const std::vector<uint64_t>& data,
+    static KeyVector generate_queries(
+        const KeyVector& data,
         size_t num_queries,
         uint64_t seed = 42
     ) {
-        std::vector<uint64_t> queries(num_queries);
+        if (!TraceConfig::replay_path().empty()) {
+            KeyVector replayed = load_trace_queries(TraceConfig::replay_path(), num_queries);
+            if (!replayed.empty()) return replayed;
+            std::cerr << "    Warning: no lookups replayed from " << TraceConfig::replay_path()
+                      << ", generating queries instead" << std::endl;
+        }
+        
+        KeyVector queries(num_queries);
         std::mt19937_64 rng(seed);
         
         for (size_t i = 0; i < num_queries; ++i) {
@@ -68,14 +118,73 @@ public:
             queries[i] = data[idx];
         }
         
+        if (!TraceConfig::record_path().empty() &&
+            QueryTrace::write(TraceConfig::record_path(), queries.data(), queries.size())) {
+            std::cout << "    Recorded " << queries.size() << " queries -> " << TraceConfig::record_path() << std::endl;
+        }
+        
         return queries;
     }
     
     /**
-     * 生成范围查询负载（预留）
+     * 按顺序取 trace 中前 num_queries 个点查（Lookup）的 key
+     * @param path trace 文件
+     * @param num_queries 最大数量，trace 中不够时返回全部点查
+     * @return 查询向量，trace 无法打开时为空
+     */
+    static KeyVector load_trace_queries(
+        const std::string& path,
+        size_t num_queries
+    ) {
+        QueryTrace trace;
+        if (!trace.open(path)) {
+            std::cerr << "Error: Cannot open trace " << path << std::endl;
+            return {};
+        }
+        
+        KeyVector queries;
+        queries.reserve(std::min(num_queries, trace.size()));
+        for (size_t i = 0; i < trace.size() && queries.size() < num_queries; ++i) {
+            if (trace.op(i) == TraceOp::Lookup) queries.push_back(trace.keys()[i]);
+        }
+        
+        std::cout << "    Replaying " << queries.size() << " lookups from " << path << std::endl;
+        return queries;
+    }
+    
+    /**
+     * 生成插入批次：在数据的 [min, max] 范围内均匀随机取 key
+     * @param data 源数据
+     * @param batch_size 批次大小
+     * @param seed 随机种子
+     * @return (key, key) 对，未排序，可能与已有 key 重复
+     */
+    static std::vector<std::pair<uint64_t, uint64_t>> generate_insert_batch(
+        const KeyVector& data,
+        size_t batch_size,
+        uint64_t seed = 42
+    ) {
+        std::vector<std::pair<uint64_t, uint64_t>> batch(batch_size);
+        if (data.empty()) return batch;
+        
+        auto minmax = std::minmax_element(data.begin(), data.end());
+        std::uniform_int_distribution<uint64_t> dist(*minmax.first, *minmax.second);
+        std::mt19937_64 rng(seed);
+        
+        for (size_t i = 0; i < batch_size; ++i) {
+            uint64_t key = dist(rng);
+            batch[i] = {key, key};
+        }
+        
+        return batch;
+    }
+    
+    /**
+     * 生成范围查询负载：起点为有序 data 中随机选取的 key，终点为其后第 range_size 个 key
+     * （不超过最后一个）；record_query_trace() 用它生成 trace 中的范围查询
      */
     static std::vector<std::pair<uint64_t, uint64_t>> generate_range_queries(
-        const std::vector<uint64_t>& data,
+        const KeyVector& data,
         size_t num_queries,
         size_t range_size,
         uint64_t seed = 42
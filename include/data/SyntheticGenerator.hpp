@@ -0,0 +1,284 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <thread>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include "../utils/Parallel.hpp"
+#include "../utils/Timer.hpp"
+
+namespace data {
+
+/**
+ * 基于计数器的随机数（与 SplitMix64 相同的混合函数）
+ * 第 i 个元素的第 k 个随机数只由 (seed, stream, i, k) 决定，
+ * 所以任意区间都能独立生成（可定位），多线程分段生成的结果与单线程完全一致
+ */
+class CounterRNG {
+public:
+    explicit CounterRNG(uint64_t seed, uint64_t stream = 0)
+        : m_key(mix(seed ^ mix(stream + 0x632BE59BD9B4E019ULL))) {}
+
+    uint64_t at(uint64_t i, unsigned k = 0) const {
+        uint64_t x = i * 0x9E3779B97F4A7C15ULL + (k + 1) * 0xD1B54A32D192ED03ULL;
+        return mix(mix(x ^ m_key) + m_key);
+    }
+
+    /// (0, 1) 内的均匀分布
+    double uniform(uint64_t i, unsigned k = 0) const {
+        return ((at(i, k) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+    }
+
+    /// 标准正态分布（Box-Muller，使用第 k 和 k + 1 个随机数）
+    double normal(uint64_t i, unsigned k = 0) const {
+        return std::sqrt(-2.0 * std::log(uniform(i, k))) * std::cos(6.283185307179586 * uniform(i, k + 1));
+    }
+
+private:
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 30; x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27; x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    uint64_t m_key;
+};
+
+/**
+ * 多线程、可复现的合成数据集生成器
+ *
+ * 分布（固定参数）：
+ *   uniform    [0, 2^64) 上均匀分布（稀疏，几乎没有重复）
+ *   normal     均值 2^63、标准差 2^60 的正态分布（8 个标准差外截断到 [0, 2^64)）
+ *   lognormal  exp(N(0, 2)) * 2^44（与 SOSD lognormal 相同的形状，放大以减少重复）
+ *   clustered  4096 个均匀分布的簇中心，簇内为标准差 2^40 的正态分布
+ *   zipf       相邻 key 的间隔服从 [1, 2^20] 上指数 1.5 的幂律（Zipf 型），输出有序
+ *   sosd       分段密度：每 2^16 个 key 一段，段内平均间隔为 256 * exp(2.5 * N(0, 1))，
+ *              并有 1/8 的段在段首跳过一大段空白，模拟真实数据集分段线性的 CDF，输出有序
+ *
+ * uniform / normal / lognormal / clustered 的第 i 个 key 只依赖 i，输出无序；
+ * zipf / sosd 是间隔的前缀和，第 i 个 key 依赖前面所有间隔：
+ * 每块先并行求各线程那段的间隔和，再按前缀和并行写出。
+ *
+ * save() 按块生成并写文件，一个线程写上一块的同时其余线程生成下一块，内存占用与 key 总数无关。
+ */
+class SyntheticGenerator {
+public:
+    enum class Distribution { Uniform, Normal, Lognormal, Clustered, ZipfGap, SOSDLike };
+
+    /// 命令行类型名 -> Distribution，无法识别返回 false
+    static bool parse(const std::string& s, Distribution& out) {
+        if (s == "uniform")   { out = Distribution::Uniform;   return true; }
+        if (s == "normal")    { out = Distribution::Normal;    return true; }
+        if (s == "lognormal") { out = Distribution::Lognormal; return true; }
+        if (s == "clustered") { out = Distribution::Clustered; return true; }
+        if (s == "zipf")      { out = Distribution::ZipfGap;   return true; }
+        if (s == "sosd")      { out = Distribution::SOSDLike;  return true; }
+        return false;
+    }
+
+    static const char* name(Distribution d) {
+        switch (d) {
+            case Distribution::Uniform:   return "uniform";
+            case Distribution::Normal:    return "normal";
+            case Distribution::Lognormal: return "lognormal";
+            case Distribution::Clustered: return "clustered";
+            case Distribution::ZipfGap:   return "zipf";
+            case Distribution::SOSDLike:  return "sosd";
+        }
+        return "?";
+    }
+
+    /// 输出是否有序（间隔前缀和类分布）
+    static bool sorted_output(Distribution d) {
+        return d == Distribution::ZipfGap || d == Distribution::SOSDLike;
+    }
+
+    SyntheticGenerator(Distribution dist, size_t total, uint64_t seed = 42, unsigned threads = 0)
+        : m_dist(dist), m_total(total), m_threads(threads ? threads : utils::hardware_threads()),
+          m_rng(seed, 0), m_segment_rng(seed, 1),
+          m_max_gap(std::max<uint64_t>(1, (uint64_t(1) << 63) / std::max<size_t>(total, 1))) {}
+
+    /**
+     * 生成第 [first, first + count) 个 key 写到 out
+     * 有序分布从上一次 fill 的结尾继续时直接接上，否则先并行求 [0, first) 的间隔和
+     */
+    void fill(size_t first, size_t count, uint64_t* out) {
+        if (count == 0) return;
+        unsigned threads = static_cast<unsigned>(std::min<size_t>(m_threads, std::max<size_t>(1, count / 4096)));
+
+        if (!sorted_output(m_dist)) {
+            utils::run_parallel(threads, [&](unsigned t) {
+                size_t lo = utils::chunk_begin(count, threads, t), hi = utils::chunk_begin(count, threads, t + 1);
+                for (size_t i = lo; i < hi; ++i) out[i] = key_at(first + i);
+            });
+            return;
+        }
+
+        uint64_t base = (first == m_next) ? m_last : gap_sum(0, first);
+
+        // 先把间隔写到 out 并求各段之和，再原地做前缀和
+        std::vector<uint64_t> offsets(threads + 1, 0);
+        utils::run_parallel(threads, [&](unsigned t) {
+            size_t lo = utils::chunk_begin(count, threads, t), hi = utils::chunk_begin(count, threads, t + 1);
+            SegmentCache cache;
+            uint64_t sum = 0;
+            for (size_t i = lo; i < hi; ++i) {
+                out[i] = gap_at(first + i, cache);
+                sum += out[i];
+            }
+            offsets[t + 1] = sum;
+        });
+        for (unsigned t = 0; t < threads; ++t) offsets[t + 1] += offsets[t];
+
+        utils::run_parallel(threads, [&](unsigned t) {
+            size_t lo = utils::chunk_begin(count, threads, t), hi = utils::chunk_begin(count, threads, t + 1);
+            uint64_t key = base + offsets[t];
+            for (size_t i = lo; i < hi; ++i) {
+                key += out[i];
+                out[i] = key;
+            }
+        });
+
+        m_next = first + count;
+        m_last = base + offsets[threads];
+    }
+
+    /**
+     * 按块生成全部 key 并写入二进制文件，返回是否成功
+     */
+    bool save(const std::string& filename, size_t chunk_keys = size_t(1) << 24) {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file) {
+            std::cerr << "Error: Cannot create file " << filename << std::endl;
+            return false;
+        }
+
+        utils::Timer timer;
+        std::vector<uint64_t> buffers[2] = {std::vector<uint64_t>(std::min(chunk_keys, m_total)),
+                                            std::vector<uint64_t>(std::min(chunk_keys, m_total))};
+        std::thread writer;
+        double gen_ms = 0.0;
+        int current = 0;
+
+        for (size_t first = 0; first < m_total; first += chunk_keys) {
+            size_t count = std::min(chunk_keys, m_total - first);
+
+            utils::Timer gen_timer;
+            fill(first, count, buffers[current].data());
+            gen_ms += gen_timer.elapsed_ms();
+
+            // 上一块写完之前不能再写文件
+            if (writer.joinable()) writer.join();
+            writer = std::thread([&file, &buffers, current, count] {
+                file.write(reinterpret_cast<const char*>(buffers[current].data()), count * sizeof(uint64_t));
+            });
+            current ^= 1;
+        }
+        if (writer.joinable()) writer.join();
+        file.close();
+
+        double total_ms = timer.elapsed_ms();
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "    Generated " << name(m_dist) << " dataset (" << m_total << " keys, "
+                  << m_threads << " threads) -> " << filename << std::endl;
+        std::cout << "    Generation: " << gen_ms << " ms, total with writing: " << total_ms << " ms ("
+                  << (total_ms > 0 ? m_total / (total_ms * 1000.0) : 0.0) << " M keys/s)" << std::endl;
+        return file.good();
+    }
+
+private:
+    static constexpr unsigned clusters = 4096;
+    static constexpr size_t segment_shift = 16;
+
+    /// 无序分布的第 i 个 key
+    uint64_t key_at(uint64_t i) const {
+        switch (m_dist) {
+            case Distribution::Uniform:
+                return m_rng.at(i);
+            case Distribution::Normal:
+                return to_key(9223372036854775808.0 + 1152921504606846976.0 * m_rng.normal(i));
+            case Distribution::Lognormal:
+                return to_key(std::exp(2.0 * m_rng.normal(i)) * 17592186044416.0);
+            case Distribution::Clustered: {
+                uint64_t center = m_segment_rng.at(m_rng.at(i, 2) % clusters);
+                int64_t offset = static_cast<int64_t>(1099511627776.0 * m_rng.normal(i));
+                return center + static_cast<uint64_t>(offset);
+            }
+            default:
+                return 0;
+        }
+    }
+
+    /// sosd 分布当前段的平均间隔，连续生成时每段只算一次
+    struct SegmentCache {
+        uint64_t segment = UINT64_MAX;
+        double mean = 0.0;
+    };
+
+    /// 有序分布中第 i 个 key 与前一个 key 的间隔（第 0 个为与 0 的距离），至少为 1
+    uint64_t gap_at(uint64_t i, SegmentCache& cache) const {
+        if (m_dist == Distribution::ZipfGap) {
+            // [1, 2^20] 上指数 1.5 的截断幂律，逆变换采样：(1 - u * (1 - g_max^(1-s)))^(1/(1-s))
+            const double tail = 1.0 - 1.0 / 1024.0;    // 1 - (2^20)^(-0.5)
+            double g = std::pow(1.0 - m_rng.uniform(i) * tail, -2.0);
+            return std::min<uint64_t>(m_max_gap, static_cast<uint64_t>(g));
+        }
+
+        uint64_t segment = i >> segment_shift;
+        if (segment != cache.segment) {
+            cache.segment = segment;
+            cache.mean = std::min(256.0 * std::exp(2.5 * m_segment_rng.normal(segment)),
+                                  static_cast<double>(m_max_gap) / 2);
+        }
+        uint64_t gap = 1 + static_cast<uint64_t>(m_rng.uniform(i) * 2.0 * cache.mean);
+        if ((i & ((size_t(1) << segment_shift) - 1)) == 0 && m_segment_rng.uniform(segment, 2) < 0.125) {
+            gap += static_cast<uint64_t>(m_segment_rng.uniform(segment, 3) * cache.mean * 65536.0);
+        }
+        return std::min(m_max_gap, gap);
+    }
+
+    uint64_t gap_sum(size_t first, size_t last) const {
+        unsigned threads = static_cast<unsigned>(std::min<size_t>(m_threads, std::max<size_t>(1, (last - first) / 4096)));
+        std::vector<uint64_t> sums(threads, 0);
+        utils::run_parallel(threads, [&](unsigned t) {
+            size_t n = last - first;
+            size_t lo = utils::chunk_begin(n, threads, t), hi = utils::chunk_begin(n, threads, t + 1);
+            SegmentCache cache;
+            uint64_t sum = 0;
+            for (size_t i = lo; i < hi; ++i) sum += gap_at(first + i, cache);
+            sums[t] = sum;
+        });
+        uint64_t sum = 0;
+        for (uint64_t s : sums) sum += s;
+        return sum;
+    }
+
+    /// 截断到 [0, 2^64) 后转为整数
+    static uint64_t to_key(double x) {
+        if (!(x > 0.0)) return 0;
+        if (x >= 18446744073709549568.0) return UINT64_MAX;
+        return static_cast<uint64_t>(x);
+    }
+
+    Distribution m_dist;
+    size_t m_total;
+    unsigned m_threads;
+    CounterRNG m_rng;
+    CounterRNG m_segment_rng;
+
+    /// 单个间隔的上限，保证 total 个间隔之和不超过 2^63
+    uint64_t m_max_gap;
+
+    /// 有序分布：上一次 fill 结束的位置和最后一个 key
+    size_t m_next = 0;
+    uint64_t m_last = 0;
+};
+
+} // namespace data
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cstddef>
+#include <type_traits>
+
+namespace structures {
+
+template<typename Index, typename = void>
+struct has_model_bytes : std::false_type {};
+
+template<typename Index>
+struct has_model_bytes<Index, std::void_t<decltype(std::declval<const Index&>().model_bytes())>>
+    : std::true_type {};
+
+/**
+ * 非 B+ 树索引的统计信息（静态搜索树、学习索引等）
+ * 结构需要提供 size() / height() / memory_bytes()，
+ * 学习索引额外提供 model_bytes()（不含 key / value 数组）
+ */
+struct IndexStatistics {
+    std::string name;
+    size_t total_keys;
+    size_t height;
+    size_t memory_bytes;
+    size_t model_bytes = 0;
+    
+    /**
+     * 从索引中收集统计信息
+     */
+    template<typename Index>
+    static IndexStatistics collect(const Index& index, const std::string& name) {
+        IndexStatistics stat;
+        stat.name = name;
+        stat.total_keys = index.size();
+        stat.height = index.height();
+        stat.memory_bytes = index.memory_bytes();
+        if constexpr (has_model_bytes<Index>::value) {
+            stat.model_bytes = index.model_bytes();
+        }
+        return stat;
+    }
+    
+    double bytes_per_key() const {
+        return total_keys ? static_cast<double>(memory_bytes) / total_keys : 0.0;
+    }
+    
+    /**
+     * 打印统计信息
+     */
+    void print() const {
+        std::cout << "\n  ════════════════════════════════════════════════════" << std::endl;
+        std::cout << "  Index Statistics: " << name << std::endl;
+        std::cout << "  ════════════════════════════════════════════════════" << std::endl;
+        
+        auto print_stat = [](const std::string& label, auto value, const std::string& note = "") {
+            std::cout << "    " << std::left << std::setw(30) << label
+                      << std::right << std::setw(15) << value;
+            if (!note.empty()) {
+                std::cout << " " << note;
+            }
+            std::cout << std::endl;
+        };
+        
+        print_stat("Total Keys:", total_keys);
+        print_stat("Height:", height, "levels");
+        print_stat("Memory:", memory_bytes / 1024, "KB");
+        if (model_bytes > 0) {
+            print_stat("Model Size:", model_bytes, "bytes");
+        }
+        std::cout << std::fixed << std::setprecision(2);
+        print_stat("Bytes per Key:", bytes_per_key());
+        std::cout << "  ════════════════════════════════════════════════════" << std::endl;
+    }
+};
+
+} // namespace structures
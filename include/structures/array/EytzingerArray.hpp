@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+#include "../../utils/PrefetchUtils.hpp"
+
+/**
+ * Eytzinger（BFS）布局的有序数组
+ *
+ * - key 按完全二叉树的层序存放：b[k] 的孩子是 b[2k] 和 b[2k+1]（1 起始）
+ * - 查找无分支：k = 2k + (b[k] < x)，结束后去掉末尾的 1 得到 lower_bound
+ * - 第 k 个节点 4 层以下的 16 个后代连续存放在 b[16k .. 16k+15]，
+ *   每一步用 do_prefetch 提前取这 16 个 key（uint64 为 2 条 cache line）
+ *
+ * 只读结构，find() 返回指向 value 的指针，未命中返回 end()（nullptr）。
+ */
+
+namespace structures {
+namespace array {
+
+template<typename Key = uint64_t, typename Value = uint64_t, bool Prefetch = true>
+class EytzingerArray {
+public:
+    using key_type = Key;
+    using data_type = Value;
+    using pair_type = std::pair<Key, Value>;
+    using size_type = size_t;
+    using const_iterator = const data_type*;
+
+    /// 只能通过 bulk_load() 构建
+    static constexpr bool bulk_load_only = true;
+
+    /// 预取提前的层数
+    static constexpr size_t prefetch_levels = 4;
+
+private:
+    /// 64 字节对齐，保证 b[16k] 落在 cache line 起点
+    template<typename T>
+    struct aligned_allocator {
+        using value_type = T;
+
+        aligned_allocator() = default;
+        template<typename U>
+        aligned_allocator(const aligned_allocator<U>&) {}
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(64)));
+        }
+        void deallocate(T* p, size_t) {
+            ::operator delete(p, std::align_val_t(64));
+        }
+
+        template<typename U>
+        bool operator==(const aligned_allocator<U>&) const { return true; }
+        template<typename U>
+        bool operator!=(const aligned_allocator<U>&) const { return false; }
+    };
+
+public:
+    /**
+     * 从有序、无重复的 (key, value) 序列构建（中序遍历填充，一次遍历）
+     */
+    template<typename Iterator>
+    void bulk_load(Iterator ibegin, Iterator iend) {
+        m_size = iend - ibegin;
+        m_keys.assign(m_size + 1, key_type());
+        m_data.assign(m_size + 1, data_type());
+
+        Iterator it = ibegin;
+        build(1, it);
+    }
+
+    /**
+     * 返回第一个 >= key 的下标（1 起始），不存在返回 0
+     */
+    size_t lower_bound_pos(const key_type& key) const {
+        const key_type* b = m_keys.data();
+        size_t k = 1;
+
+        while (k <= m_size) {
+            if (Prefetch) {
+                do_prefetch(b + k * 16);
+                do_prefetch(b + k * 16 + 8);
+            }
+            k = 2 * k + (b[k] < key);
+        }
+
+        // 最后一次向左走之后的节点：去掉末尾连续的 1 和一个 0
+        k >>= __builtin_ffsll(~k);
+        return k;
+    }
+
+    const_iterator find(const key_type& key) const {
+        size_t k = lower_bound_pos(key);
+        if (k == 0 || m_keys[k] != key) return end();
+        return &m_data[k];
+    }
+
+    const_iterator end() const { return nullptr; }
+
+    bool exists(const key_type& key) const {
+        return find(key) != end();
+    }
+
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /// 完全二叉树的层数
+    size_t height() const {
+        size_t h = 0;
+        for (size_t n = m_size; n > 0; n >>= 1) h++;
+        return h;
+    }
+
+    size_t memory_bytes() const {
+        return m_keys.size() * sizeof(key_type) + m_data.size() * sizeof(data_type);
+    }
+
+private:
+    template<typename Iterator>
+    void build(size_t k, Iterator& it) {
+        if (k > m_size) return;
+        build(2 * k, it);
+        m_keys[k] = it->first;
+        m_data[k] = it->second;
+        ++it;
+        build(2 * k + 1, it);
+    }
+
+    std::vector<key_type, aligned_allocator<key_type>> m_keys;
+    std::vector<data_type> m_data;
+    size_t m_size = 0;
+};
+
+using Eytzinger64 = EytzingerArray<uint64_t, uint64_t, true>;
+using Eytzinger64NoPrefetch = EytzingerArray<uint64_t, uint64_t, false>;
+
+} // namespace array
+} // namespace structures
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 有序数组 + std::lower_bound
+ * 最朴素的只读基线，用来衡量其他布局的收益
+ */
+
+namespace structures {
+namespace array {
+
+template<typename Key = uint64_t, typename Value = uint64_t>
+class SortedArray {
+public:
+    using key_type = Key;
+    using data_type = Value;
+    using pair_type = std::pair<Key, Value>;
+    using size_type = size_t;
+    using const_iterator = const data_type*;
+
+    /// 只能通过 bulk_load() 构建
+    static constexpr bool bulk_load_only = true;
+
+    /**
+     * 从有序、无重复的 (key, value) 序列构建
+     */
+    template<typename Iterator>
+    void bulk_load(Iterator ibegin, Iterator iend) {
+        size_t n = iend - ibegin;
+        m_keys.resize(n);
+        m_data.resize(n);
+
+        size_t i = 0;
+        for (Iterator it = ibegin; it != iend; ++it, ++i) {
+            m_keys[i] = it->first;
+            m_data[i] = it->second;
+        }
+    }
+
+    const_iterator find(const key_type& key) const {
+        auto it = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+        if (it == m_keys.end() || *it != key) return end();
+        return &m_data[it - m_keys.begin()];
+    }
+
+    const_iterator end() const { return nullptr; }
+
+    bool exists(const key_type& key) const {
+        return find(key) != end();
+    }
+
+    size_type size() const { return m_keys.size(); }
+    bool empty() const { return m_keys.empty(); }
+
+    /// 二分查找的比较层数
+    size_t height() const {
+        size_t h = 0;
+        for (size_t n = m_keys.size(); n > 0; n >>= 1) h++;
+        return h;
+    }
+
+    size_t memory_bytes() const {
+        return m_keys.size() * sizeof(key_type) + m_data.size() * sizeof(data_type);
+    }
+
+private:
+    std::vector<key_type> m_keys;
+    std::vector<data_type> m_data;
+};
+
+using SortedArray64 = SortedArray<uint64_t, uint64_t>;
+
+} // namespace array
+} // namespace structures
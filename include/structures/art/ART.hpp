@@ -0,0 +1,532 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * Adaptive Radix Tree（ART），固定 64 位整数 key
+ *
+ * - key 按大端字节序逐字节下降，最多 8 层
+ * - 四种内部节点：Node4 / Node16 / Node48 / Node256，满了自动升级
+ * - 路径压缩：节点头部保存完整的公共前缀（key 只有 8 字节，悲观前缀即可）
+ * - 延迟展开：只剩一个 key 的子树直接存叶子（指针最低位打标记）
+ * - Node16 用 SSE2 一次比较 16 个字节
+ *
+ * 两种构建方式：insert() 逐个插入；bulk_load() 从有序序列自顶向下一次构建，
+ * 每个节点直接按孩子数选用最小的节点类型。
+ *
+ * 查找接口与 btree_map 一致：find() 返回指向 value 的指针，未命中返回 end()（nullptr）。
+ */
+
+namespace structures {
+namespace art {
+
+template<typename Value = uint64_t>
+class ART {
+public:
+    using key_type = uint64_t;
+    using data_type = Value;
+    using pair_type = std::pair<uint64_t, Value>;
+    using size_type = size_t;
+    using const_iterator = const data_type*;
+
+    enum node_type : uint8_t { NODE4 = 0, NODE16 = 1, NODE48 = 2, NODE256 = 3 };
+
+private:
+    static constexpr unsigned key_bytes = 8;
+
+    struct node {
+        node_type type;
+        uint8_t prefix_len;
+        uint16_t count;
+        uint8_t prefix[key_bytes];
+    };
+
+    struct node4 : node {
+        uint8_t keys[4];
+        node* children[4];
+    };
+
+    struct node16 : node {
+        uint8_t keys[16];
+        node* children[16];
+    };
+
+    struct node48 : node {
+        /// 0 表示空，否则为 children 下标 + 1
+        uint8_t child_index[256];
+        node* children[48];
+    };
+
+    struct node256 : node {
+        node* children[256];
+    };
+
+    struct leaf {
+        key_type key;
+        data_type value;
+    };
+
+public:
+    ART() = default;
+
+    ART(const ART&) = delete;
+    ART& operator=(const ART&) = delete;
+
+    ~ART() {
+        clear();
+    }
+
+    void clear() {
+        free_recursive(m_root);
+        m_root = nullptr;
+        m_size = 0;
+        m_memory_bytes = 0;
+        std::fill(m_node_count, m_node_count + 4, 0);
+    }
+
+    // ==================== 构建 ====================
+
+    /**
+     * 插入 (key, value)，key 已存在时不覆盖，返回 false
+     */
+    bool insert(const pair_type& kv) {
+        bool inserted = insert_recursive(&m_root, kv.first, kv.second, 0);
+        if (inserted) m_size++;
+        return inserted;
+    }
+
+    /**
+     * 从有序、无重复的 (key, value) 序列一次构建
+     */
+    template<typename Iterator>
+    void bulk_load(Iterator ibegin, Iterator iend) {
+        clear();
+        if (ibegin == iend) return;
+        m_root = build_recursive(ibegin, iend, 0);
+        m_size = iend - ibegin;
+    }
+
+    // ==================== 查找 ====================
+
+    const_iterator find(const key_type& key) const {
+        const node* n = m_root;
+        unsigned depth = 0;
+
+        while (n) {
+            if (is_leaf(n)) {
+                const leaf* l = as_leaf(n);
+                return l->key == key ? &l->value : end();
+            }
+
+            for (unsigned i = 0; i < n->prefix_len; ++i) {
+                if (n->prefix[i] != key_byte(key, depth + i)) return end();
+            }
+            depth += n->prefix_len;
+
+            node* const* child = find_child(n, key_byte(key, depth));
+            if (!child) return end();
+
+            n = *child;
+            depth++;
+        }
+
+        return end();
+    }
+
+    const_iterator end() const { return nullptr; }
+
+    bool exists(const key_type& key) const {
+        return find(key) != end();
+    }
+
+    // ==================== 统计 ====================
+
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /// 从根到最深叶子经过的内部节点数
+    size_t height() const {
+        return height_recursive(m_root);
+    }
+
+    /// 所有内部节点和叶子占用的字节数
+    size_t memory_bytes() const { return m_memory_bytes; }
+
+    size_t node_count(node_type type) const { return m_node_count[type]; }
+
+private:
+    // ==================== 指针标记 ====================
+
+    static bool is_leaf(const node* n) {
+        return reinterpret_cast<uintptr_t>(n) & 1;
+    }
+
+    static const leaf* as_leaf(const node* n) {
+        return reinterpret_cast<const leaf*>(reinterpret_cast<uintptr_t>(n) & ~uintptr_t(1));
+    }
+
+    static leaf* as_leaf(node* n) {
+        return reinterpret_cast<leaf*>(reinterpret_cast<uintptr_t>(n) & ~uintptr_t(1));
+    }
+
+    static node* tag_leaf(leaf* l) {
+        return reinterpret_cast<node*>(reinterpret_cast<uintptr_t>(l) | 1);
+    }
+
+    static uint8_t key_byte(key_type key, unsigned depth) {
+        return static_cast<uint8_t>(key >> (8 * (key_bytes - 1 - depth)));
+    }
+
+    // ==================== 分配 ====================
+
+    node* make_leaf(key_type key, const data_type& value) {
+        leaf* l = new leaf{key, value};
+        m_memory_bytes += sizeof(leaf);
+        return tag_leaf(l);
+    }
+
+    template<typename NodeT>
+    NodeT* alloc_node(node_type type) {
+        NodeT* n = new NodeT();
+        n->type = type;
+        n->prefix_len = 0;
+        n->count = 0;
+        m_memory_bytes += sizeof(NodeT);
+        m_node_count[type]++;
+        return n;
+    }
+
+    void free_node(node* n) {
+        switch (n->type) {
+            case NODE4:   m_memory_bytes -= sizeof(node4);   delete static_cast<node4*>(n);   break;
+            case NODE16:  m_memory_bytes -= sizeof(node16);  delete static_cast<node16*>(n);  break;
+            case NODE48:  m_memory_bytes -= sizeof(node48);  delete static_cast<node48*>(n);  break;
+            case NODE256: m_memory_bytes -= sizeof(node256); delete static_cast<node256*>(n); break;
+        }
+    }
+
+    void free_recursive(node* n) {
+        if (!n) return;
+        if (is_leaf(n)) {
+            delete as_leaf(n);
+            return;
+        }
+
+        switch (n->type) {
+            case NODE4: {
+                node4* p = static_cast<node4*>(n);
+                for (unsigned i = 0; i < p->count; ++i) free_recursive(p->children[i]);
+                break;
+            }
+            case NODE16: {
+                node16* p = static_cast<node16*>(n);
+                for (unsigned i = 0; i < p->count; ++i) free_recursive(p->children[i]);
+                break;
+            }
+            case NODE48: {
+                node48* p = static_cast<node48*>(n);
+                for (unsigned i = 0; i < p->count; ++i) free_recursive(p->children[i]);
+                break;
+            }
+            case NODE256: {
+                node256* p = static_cast<node256*>(n);
+                for (unsigned i = 0; i < 256; ++i) free_recursive(p->children[i]);
+                break;
+            }
+        }
+        free_node(n);
+    }
+
+    // ==================== 节点内查找 ====================
+
+    static node* const* find_child(const node* n, uint8_t byte) {
+        switch (n->type) {
+            case NODE4: {
+                const node4* p = static_cast<const node4*>(n);
+                for (unsigned i = 0; i < p->count; ++i) {
+                    if (p->keys[i] == byte) return &p->children[i];
+                }
+                return nullptr;
+            }
+            case NODE16: {
+                const node16* p = static_cast<const node16*>(n);
+#ifdef __SSE2__
+                __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(byte)),
+                                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(p->keys)));
+                unsigned mask = _mm_movemask_epi8(cmp) & ((1u << p->count) - 1);
+                return mask ? &p->children[__builtin_ctz(mask)] : nullptr;
+#else
+                for (unsigned i = 0; i < p->count; ++i) {
+                    if (p->keys[i] == byte) return &p->children[i];
+                }
+                return nullptr;
+#endif
+            }
+            case NODE48: {
+                const node48* p = static_cast<const node48*>(n);
+                uint8_t idx = p->child_index[byte];
+                return idx ? &p->children[idx - 1] : nullptr;
+            }
+            case NODE256: {
+                const node256* p = static_cast<const node256*>(n);
+                return p->children[byte] ? &p->children[byte] : nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    static node** find_child(node* n, uint8_t byte) {
+        return const_cast<node**>(find_child(static_cast<const node*>(n), byte));
+    }
+
+    // ==================== 插入 ====================
+
+    /**
+     * 在 *ref 处加入一个孩子；节点满时升级为更大的节点类型并替换 *ref
+     */
+    void add_child(node** ref, uint8_t byte, node* child) {
+        node* n = *ref;
+
+        switch (n->type) {
+            case NODE4: {
+                node4* p = static_cast<node4*>(n);
+                if (p->count < 4) {
+                    insert_sorted(p->keys, p->children, p->count, byte, child);
+                    return;
+                }
+                node16* bigger = alloc_node<node16>(NODE16);
+                copy_header(bigger, p);
+                std::copy(p->keys, p->keys + 4, bigger->keys);
+                std::copy(p->children, p->children + 4, bigger->children);
+                bigger->count = 4;
+                m_node_count[NODE4]--;
+                free_node(p);
+                *ref = bigger;
+                insert_sorted(bigger->keys, bigger->children, bigger->count, byte, child);
+                return;
+            }
+            case NODE16: {
+                node16* p = static_cast<node16*>(n);
+                if (p->count < 16) {
+                    insert_sorted(p->keys, p->children, p->count, byte, child);
+                    return;
+                }
+                node48* bigger = alloc_node<node48>(NODE48);
+                copy_header(bigger, p);
+                for (unsigned i = 0; i < 16; ++i) {
+                    bigger->children[i] = p->children[i];
+                    bigger->child_index[p->keys[i]] = static_cast<uint8_t>(i + 1);
+                }
+                bigger->count = 16;
+                m_node_count[NODE16]--;
+                free_node(p);
+                *ref = bigger;
+                n = bigger;
+            }
+            // fall through
+            case NODE48: {
+                node48* p = static_cast<node48*>(n);
+                if (p->count < 48) {
+                    p->children[p->count] = child;
+                    p->child_index[byte] = static_cast<uint8_t>(p->count + 1);
+                    p->count++;
+                    return;
+                }
+                node256* bigger = alloc_node<node256>(NODE256);
+                copy_header(bigger, p);
+                for (unsigned b = 0; b < 256; ++b) {
+                    if (p->child_index[b]) bigger->children[b] = p->children[p->child_index[b] - 1];
+                }
+                bigger->count = 48;
+                m_node_count[NODE48]--;
+                free_node(p);
+                *ref = bigger;
+                n = bigger;
+            }
+            // fall through
+            case NODE256: {
+                node256* p = static_cast<node256*>(n);
+                p->children[byte] = child;
+                p->count++;
+                return;
+            }
+        }
+    }
+
+    static void insert_sorted(uint8_t* keys, node** children, uint16_t& count,
+                              uint8_t byte, node* child) {
+        unsigned pos = 0;
+        while (pos < count && keys[pos] < byte) ++pos;
+        std::copy_backward(keys + pos, keys + count, keys + count + 1);
+        std::copy_backward(children + pos, children + count, children + count + 1);
+        keys[pos] = byte;
+        children[pos] = child;
+        count++;
+    }
+
+    static void copy_header(node* dst, const node* src) {
+        dst->prefix_len = src->prefix_len;
+        std::memcpy(dst->prefix, src->prefix, key_bytes);
+    }
+
+    bool insert_recursive(node** ref, key_type key, const data_type& value, unsigned depth) {
+        node* n = *ref;
+
+        if (!n) {
+            *ref = make_leaf(key, value);
+            return true;
+        }
+
+        if (is_leaf(n)) {
+            key_type other = as_leaf(n)->key;
+            if (other == key) return false;
+
+            // 叶子分裂：新 Node4 的前缀是两个 key 从 depth 起的公共字节
+            node4* split = alloc_node<node4>(NODE4);
+            unsigned p = 0;
+            while (depth + p < key_bytes - 1 && key_byte(key, depth + p) == key_byte(other, depth + p)) {
+                split->prefix[p] = key_byte(key, depth + p);
+                ++p;
+            }
+            split->prefix_len = static_cast<uint8_t>(p);
+
+            insert_sorted(split->keys, split->children, split->count, key_byte(other, depth + p), n);
+            insert_sorted(split->keys, split->children, split->count, key_byte(key, depth + p),
+                          make_leaf(key, value));
+            *ref = split;
+            return true;
+        }
+
+        // 前缀不匹配：在不匹配处插入新 Node4
+        unsigned p = 0;
+        while (p < n->prefix_len && n->prefix[p] == key_byte(key, depth + p)) ++p;
+
+        if (p < n->prefix_len) {
+            node4* split = alloc_node<node4>(NODE4);
+            split->prefix_len = static_cast<uint8_t>(p);
+            std::memcpy(split->prefix, n->prefix, p);
+
+            uint8_t old_byte = n->prefix[p];
+            n->prefix_len = static_cast<uint8_t>(n->prefix_len - p - 1);
+            std::memmove(n->prefix, n->prefix + p + 1, n->prefix_len);
+
+            insert_sorted(split->keys, split->children, split->count, old_byte, n);
+            insert_sorted(split->keys, split->children, split->count, key_byte(key, depth + p),
+                          make_leaf(key, value));
+            *ref = split;
+            return true;
+        }
+
+        depth += n->prefix_len;
+        uint8_t byte = key_byte(key, depth);
+
+        node** child = find_child(n, byte);
+        if (child) return insert_recursive(child, key, value, depth + 1);
+
+        add_child(ref, byte, make_leaf(key, value));
+        return true;
+    }
+
+    // ==================== 批量构建 ====================
+
+    template<typename Iterator>
+    node* build_recursive(Iterator lo, Iterator hi, unsigned depth) {
+        if (hi - lo == 1) return make_leaf(lo->first, lo->second);
+
+        // 有序：首尾 key 的公共前缀就是整段的公共前缀
+        key_type first = lo->first;
+        key_type last = (hi - 1)->first;
+        unsigned p = 0;
+        while (depth + p < key_bytes - 1 && key_byte(first, depth + p) == key_byte(last, depth + p)) ++p;
+        unsigned d = depth + p;
+
+        // 统计 d 层的不同字节数，选择节点类型
+        unsigned groups = 0;
+        for (Iterator it = lo; it != hi; it = group_end(it, hi, d)) groups++;
+
+        node* n;
+        if (groups <= 4)       n = alloc_node<node4>(NODE4);
+        else if (groups <= 16) n = alloc_node<node16>(NODE16);
+        else if (groups <= 48) n = alloc_node<node48>(NODE48);
+        else                   n = alloc_node<node256>(NODE256);
+
+        n->prefix_len = static_cast<uint8_t>(p);
+        for (unsigned i = 0; i < p; ++i) n->prefix[i] = key_byte(first, depth + i);
+
+        node* tmp = n;
+        for (Iterator it = lo; it != hi; ) {
+            Iterator next = group_end(it, hi, d);
+            // 节点已按组数选好类型，add_child 不会触发升级
+            add_child(&tmp, key_byte(it->first, d), build_recursive(it, next, d + 1));
+            it = next;
+        }
+
+        return n;
+    }
+
+    /// 返回 [it, hi) 中第 d 字节与 it 相同的一段的结尾
+    template<typename Iterator>
+    static Iterator group_end(Iterator it, Iterator hi, unsigned d) {
+        uint8_t byte = key_byte(it->first, d);
+        return std::upper_bound(it, hi, byte, [d](uint8_t b, const pair_type& kv) {
+            return b < key_byte(kv.first, d);
+        });
+    }
+
+    size_t height_recursive(const node* n) const {
+        if (!n || is_leaf(n)) return 0;
+
+        size_t h = 0;
+        switch (n->type) {
+            case NODE4: {
+                const node4* p = static_cast<const node4*>(n);
+                for (unsigned i = 0; i < p->count; ++i) h = std::max(h, height_recursive(p->children[i]));
+                break;
+            }
+            case NODE16: {
+                const node16* p = static_cast<const node16*>(n);
+                for (unsigned i = 0; i < p->count; ++i) h = std::max(h, height_recursive(p->children[i]));
+                break;
+            }
+            case NODE48: {
+                const node48* p = static_cast<const node48*>(n);
+                for (unsigned i = 0; i < p->count; ++i) h = std::max(h, height_recursive(p->children[i]));
+                break;
+            }
+            case NODE256: {
+                const node256* p = static_cast<const node256*>(n);
+                for (unsigned i = 0; i < 256; ++i) h = std::max(h, height_recursive(p->children[i]));
+                break;
+            }
+        }
+        return h + 1;
+    }
+
+    node* m_root = nullptr;
+    size_t m_size = 0;
+    size_t m_memory_bytes = 0;
+    size_t m_node_count[4] = {0, 0, 0, 0};
+};
+
+/**
+ * 走 bulk_load() 构建路径的 ART（测试框架按 bulk_load_only 选择构建方式）
+ */
+template<typename Value = uint64_t>
+class BulkART : public ART<Value> {
+public:
+    static constexpr bool bulk_load_only = true;
+};
+
+using ART64 = ART<uint64_t>;
+using BulkART64 = BulkART<uint64_t>;
+
+} // namespace art
+} // namespace structures
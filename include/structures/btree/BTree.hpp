@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stx/btree_map.h>
+#include "../../utils/PrefetchUtils.hpp"
 /**
  * B+ 树封装接口
  * 
@@ -52,9 +53,18 @@ struct LargeNodeBTree {
 
 /**
  * 自定义配置的 B+ 树
+ * Prefetch 为 prefetch_leaf() 使用的预取策略（见 PrefetchUtils.hpp）
+ * LeafLayout 为叶子中 key / value 的排布：
+ *   stx::btree_leaf_split       key 数组 + value 数组（默认）
+ *   stx::btree_leaf_interleaved (key, value) 交错存放
+ *   stx::btree_leaf_blocked     每 8 个 key 后跟它们的 8 个 value
+ * PooledChildren 为 true 时节点从连续的节点池分配，内部节点用 32 位池下标代替 8 字节孩子指针
  */
 template<typename Key = uint64_t, typename Value = uint64_t, 
-         int LeafSlots = 64, int InnerSlots = 64>
+         int LeafSlots = 64, int InnerSlots = 64,
+         typename Prefetch = DefaultPrefetchPolicy,
+         int LeafLayout = stx::btree_leaf_split,
+         bool PooledChildren = false>
 struct CustomBTree {
     struct traits {
         static const bool selfverify = false;
@@ -62,6 +72,9 @@ struct CustomBTree {
         static const int leafslots = LeafSlots;
         static const int innerslots = InnerSlots;
         static const size_t binsearch_threshold = 256;
+        static const int leaf_layout = LeafLayout;
+        static const bool pooled_children = PooledChildren;
+        using prefetch_policy = Prefetch;
     };
     
     using type = stx::btree_map<Key, Value, std::less<Key>, traits>;
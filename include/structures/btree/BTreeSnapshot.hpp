@@ -0,0 +1,157 @@
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <stx/btree.h>
+
+/**
+ * B+ 树快照：把整棵树写成一个连续、与地址无关的镜像文件（btree::write_image()），
+ * 之后 mmap 打开即可原地查找，不需要重建节点。
+ *
+ * 镜像格式见 stx::btree_image_header：按层存放节点（根在前、叶子在后），
+ * 内部节点用相对文件起始的字节偏移引用孩子，同一节点的孩子在下一层连续存放。
+ *
+ * 和 dump() / restore() 的区别：restore 逐个节点读流、分配、修指针，耗时与树大小成正比；
+ * 快照 open() 只做一次 mmap 和头部校验，页面在第一次访问时才载入。
+ */
+
+namespace structures {
+namespace btree {
+
+/**
+ * 以 mmap 方式打开的只读 B+ 树快照
+ * Tree 为写出快照的 btree_map 类型，open() 会检查 key / value 大小和节点 slot 数是否一致。
+ * 查找接口与 btree_map 一致：find() 返回指向 value 的指针，未命中返回 end()（nullptr）。
+ */
+template<typename Tree>
+class BTreeSnapshot {
+public:
+    using key_type = typename Tree::key_type;
+    using data_type = typename Tree::data_type;
+    using key_compare = typename Tree::key_compare;
+    using size_type = size_t;
+    using const_iterator = const data_type*;
+
+    using header_type = stx::btree_image_header;
+    using inner_type = stx::btree_image_inner<key_type, Tree::innerslotmax>;
+    using leaf_type = stx::btree_image_leaf<key_type, data_type, Tree::leafslotmax>;
+
+    BTreeSnapshot() = default;
+    ~BTreeSnapshot() { close(); }
+
+    BTreeSnapshot(const BTreeSnapshot&) = delete;
+    BTreeSnapshot& operator=(const BTreeSnapshot&) = delete;
+
+    /**
+     * 把树写成快照文件，失败返回 false
+     */
+    static bool save(const Tree& tree, const std::string& path) {
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        if (!os) return false;
+        return tree.write_image(os) && os.flush().good();
+    }
+
+    /**
+     * 映射快照文件并校验头部，格式或树配置不符时返回 false
+     * populate 为 true 时用 MAP_POPULATE 一次性载入全部页面，否则按需缺页
+     */
+    bool open(const std::string& path, bool populate = false) {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(header_type)) {
+            ::close(fd);
+            return false;
+        }
+
+        int flags = MAP_PRIVATE | (populate ? MAP_POPULATE : 0);
+        void* p = mmap(nullptr, st.st_size, PROT_READ, flags, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+
+        m_base = static_cast<const char*>(p);
+        m_bytes = st.st_size;
+
+        if (!valid()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (m_base) munmap(const_cast<char*>(m_base), m_bytes);
+        m_base = nullptr;
+        m_bytes = 0;
+    }
+
+    bool is_open() const { return m_base != nullptr; }
+
+    const_iterator find(const key_type& key) const {
+        if (!m_base || header().height == 0) return end();
+
+        uint64_t offset = header().root;
+        for (uint32_t level = header().height - 1; level > 0; --level) {
+            const inner_type* inner = reinterpret_cast<const inner_type*>(m_base + offset);
+            size_t slot = std::lower_bound(inner->slotkey, inner->slotkey + inner->slotuse, key, m_less)
+                          - inner->slotkey;
+            offset = inner->first_child + slot * (level == 1 ? sizeof(leaf_type) : sizeof(inner_type));
+        }
+
+        const leaf_type* leaf = reinterpret_cast<const leaf_type*>(m_base + offset);
+        const key_type* k = std::lower_bound(leaf->slotkey, leaf->slotkey + leaf->slotuse, key, m_less);
+        if (k == leaf->slotkey + leaf->slotuse || m_less(key, *k)) return end();
+        return leaf->slotdata + (k - leaf->slotkey);
+    }
+
+    const_iterator end() const { return nullptr; }
+
+    bool exists(const key_type& key) const {
+        return find(key) != end();
+    }
+
+    size_t size() const { return m_base ? header().itemcount : 0; }
+    bool empty() const { return size() == 0; }
+    size_t height() const { return m_base ? header().height : 0; }
+    size_t leaf_count() const { return m_base ? header().leaves : 0; }
+    size_t inner_count() const { return m_base ? header().innernodes : 0; }
+
+    /// 镜像文件大小（映射的字节数）
+    size_t memory_bytes() const { return m_bytes; }
+
+private:
+    const header_type& header() const {
+        return *reinterpret_cast<const header_type*>(m_base);
+    }
+
+    bool valid() const {
+        const header_type& h = header();
+        return h.signed_ok()
+            && h.key_type_size == sizeof(key_type)
+            && h.data_type_size == sizeof(data_type)
+            && h.leafslots == Tree::leafslotmax
+            && h.innerslots == Tree::innerslotmax
+            && h.inner_bytes == sizeof(inner_type)
+            && h.leaf_bytes == sizeof(leaf_type)
+            && h.image_bytes == m_bytes
+            && h.root < m_bytes && h.first_leaf < m_bytes;
+    }
+
+    const char* m_base = nullptr;
+    size_t m_bytes = 0;
+    key_compare m_less;
+};
+
+} // namespace btree
+} // namespace structures
@@ -2,39 +2,98 @@
 
 #include <iostream>
 #include <iomanip>
+#include <string>
+#include <vector>
 #include <cstddef>
 
 namespace structures {
 namespace btree {
 
+/**
+ * 单层节点的填充情况
+ */
+struct LevelFill {
+    size_t nodes = 0;
+    size_t used_slots = 0;
+    size_t total_slots = 0;
+    bool leaf = false;
+
+    /// 按节点填充率分桶：[0,10%)、[10%,20%) ... [90%,100%]
+    size_t histogram[10] = {};
+
+    double fill() const {
+        return total_slots ? static_cast<double>(used_slots) / total_slots : 0.0;
+    }
+};
+
 /**
  * B+ 树统计信息
  */
 struct TreeStatistics {
     size_t total_keys;
     size_t leaf_nodes;
-    size_t inner_nodes; 
+    size_t inner_nodes;
     size_t leafslot_max;
     size_t innerslot_max;
-    
+    size_t memory_bytes;
+    size_t height;
+    double leaf_fill;
+    double inner_fill;
+
+    /// 每层的填充统计，下标 0 为根
+    std::vector<LevelFill> levels;
+
     /**
      * 从 B+ 树中收集统计信息
+     * 节点数取自 get_stats()，高度 / 填充率 / 内存通过 visit_nodes() 遍历整棵树得到
      */
     template<typename BTree>
     static TreeStatistics collect(const BTree& btree) {
         TreeStatistics stat;
         auto stx_stats = btree.get_stats();
-        
+
         stat.total_keys = stx_stats.itemcount;
         stat.leaf_nodes = stx_stats.leaves;
         stat.inner_nodes = stx_stats.innernodes;
         stat.leafslot_max = BTree::leafslotmax;
         stat.innerslot_max = BTree::innerslotmax;
-        
-       
+        stat.memory_bytes = 0;
+
+        auto visit = [&stat](unsigned depth, unsigned short slotuse, unsigned short slotmax,
+                             size_t bytes, bool isleaf) {
+            if (depth >= stat.levels.size()) stat.levels.resize(depth + 1);
+
+            LevelFill& level = stat.levels[depth];
+            level.nodes++;
+            level.used_slots += slotuse;
+            level.total_slots += slotmax;
+            level.leaf = isleaf;
+
+            size_t bucket = slotmax ? (slotuse * 10) / slotmax : 0;
+            level.histogram[bucket < 10 ? bucket : 9]++;
+
+            // 节点内存：不含分配器开销
+            stat.memory_bytes += bytes;
+        };
+        btree.visit_nodes(visit);
+
+        stat.height = stat.levels.size();
+
+        size_t leaf_used = 0, leaf_total = 0, inner_used = 0, inner_total = 0;
+        for (const auto& level : stat.levels) {
+            (level.leaf ? leaf_used : inner_used) += level.used_slots;
+            (level.leaf ? leaf_total : inner_total) += level.total_slots;
+        }
+        stat.leaf_fill = leaf_total ? static_cast<double>(leaf_used) / leaf_total : 0.0;
+        stat.inner_fill = inner_total ? static_cast<double>(inner_used) / inner_total : 0.0;
+
         return stat;
     }
-    
+
+    double bytes_per_key() const {
+        return total_keys ? static_cast<double>(memory_bytes) / total_keys : 0.0;
+    }
+
     /**
      * 打印统计信息
      */
@@ -42,26 +101,65 @@ struct TreeStatistics {
         std::cout << "\n  ════════════════════════════════════════════════════" << std::endl;
         std::cout << "  Tree Structure Statistics" << std::endl;
         std::cout << "  ════════════════════════════════════════════════════" << std::endl;
-        
+
         auto print_stat = [](const std::string& name, auto value, const std::string& note = "") {
-            std::cout << "    " << std::left << std::setw(30) << name 
+            std::cout << "    " << std::left << std::setw(30) << name
                       << std::right << std::setw(15) << value;
             if (!note.empty()) {
                 std::cout << " " << note;
             }
             std::cout << std::endl;
         };
-        
+
         print_stat("Total Keys:", total_keys);
         print_stat("Leaf Nodes:", leaf_nodes);
-        print_stat("Inner Nodes:", inner_nodes);   
-        std::cout << "    " << std::left << std::setw(30) << "Leaf Slot Max:" 
+        print_stat("Inner Nodes:", inner_nodes);
+        std::cout << "    " << std::left << std::setw(30) << "Leaf Slot Max:"
                   << std::right << std::setw(15) << leafslot_max << std::endl;
-        std::cout << "    " << std::left << std::setw(30) << "Inner Slot Max:" 
+        std::cout << "    " << std::left << std::setw(30) << "Inner Slot Max:"
                   << std::right << std::setw(15) << innerslot_max << std::endl;
+        print_stat("Height:", height, "levels");
+        std::cout << std::fixed << std::setprecision(2);
+        print_stat("Avg Leaf Fill:", leaf_fill * 100.0, "%");
+        print_stat("Avg Inner Fill:", inner_fill * 100.0, "%");
+        print_stat("Memory:", memory_bytes / 1024, "KB");
+        print_stat("Bytes per Key:", bytes_per_key());
+        print_level_fill();
         std::cout << "  ════════════════════════════════════════════════════" << std::endl;
     }
+
+    /**
+     * 每层一行：节点数、平均填充率、填充率直方图（各桶节点占比 %）
+     */
+    void print_level_fill() const {
+        if (levels.empty()) return;
+
+        std::cout << "\n    Per-Level Fill (histogram: % of nodes per fill decile)" << std::endl;
+        std::cout << "    " << std::left << std::setw(7) << "Level" << std::right
+                  << std::setw(10) << "Nodes" << std::setw(8) << "Fill%" << "  ";
+        for (int b = 1; b <= 10; ++b) {
+            std::cout << std::setw(6) << ((b < 10 ? "<" : "<=") + std::to_string(b * 10));
+        }
+        std::cout << std::endl;
+
+        for (size_t depth = 0; depth < levels.size(); ++depth) {
+            const LevelFill& level = levels[depth];
+            std::string name = "L" + std::to_string(depth) + (level.leaf ? " leaf" : "");
+
+            std::cout << std::fixed << std::setprecision(1);
+            std::cout << "    " << std::left << std::setw(7) << name << std::right
+                      << std::setw(10) << level.nodes
+                      << std::setw(8) << level.fill() * 100.0 << "  ";
+
+            std::cout << std::setprecision(0);
+            for (size_t b = 0; b < 10; ++b) {
+                std::cout << std::setw(6) << (level.histogram[b] * 100.0 / level.nodes);
+            }
+            std::cout << std::endl;
+        }
+        std::cout << std::setprecision(2);
+    }
 };
 
 } // namespace btree
-} // namespace structures
\ No newline at end of file
+} // namespace structures
@@ -42,8 +42,14 @@
 #include <istream>
 #include <ostream>
 #include <memory>
+#include <vector>
+#include <limits>
+#include <type_traits>
 #include <cstddef>
+#include <cstdint>
+#include <new>
 #include <assert.h>
+#include <sys/mman.h>
 
 // *** Debugging Macros
 
@@ -140,6 +146,449 @@ struct btree_default_map_traits
     static const size_t binsearch_threshold = 256;
 };
 
+/// Memory layout of the key/data slots in a leaf, selected by an optional
+/// traits::leaf_layout constant. Sets always use btree_leaf_split.
+enum btree_leaf_layout
+{
+    /// Separate key and data arrays (the original stx layout): a key search
+    /// touches only the key array, a hit needs one more line for the data.
+    btree_leaf_split = 0,
+
+    /// Array of (key,data) pairs: the data item of a hit lies next to its key,
+    /// but a linear scan strides over the data items.
+    btree_leaf_interleaved = 1,
+
+    /// Blocks of btree_leaf_block keys followed by their data items. A search
+    /// skips whole blocks by their last key and scans only one block.
+    btree_leaf_blocked = 2
+};
+
+/// Number of slots per block in btree_leaf_blocked leaves.
+static const unsigned short btree_leaf_block = 8;
+
+/// Storage of the key/data slots of a leaf node in the chosen layout. Every
+/// layout provides key(i), data(i), keys_end() (end of the bytes a key search
+/// may touch), find_lower/find_upper search kernels and slot copy functions
+/// with std::copy / std::copy_backward semantics.
+template <typename _Key, typename _Data, unsigned short _Slots,
+          int _Layout, bool _UsedAsSet>
+struct btree_leaf_slots;
+
+/// Split layout: key array followed by the data array.
+template <typename _Key, typename _Data, unsigned short _Slots, bool _UsedAsSet>
+struct btree_leaf_slots<_Key, _Data, _Slots, btree_leaf_split, _UsedAsSet>
+{
+    /// Keys of the data items
+    _Key            slotkey[_Slots];
+
+    /// Array of data
+    _Data           slotdata[_UsedAsSet ? 1 : _Slots];
+
+    inline _Key& key(unsigned short i) { return slotkey[i]; }
+    inline const _Key& key(unsigned short i) const { return slotkey[i]; }
+
+    inline _Data& data(unsigned short i) { return slotdata[_UsedAsSet ? 0 : i]; }
+    inline const _Data& data(unsigned short i) const { return slotdata[_UsedAsSet ? 0 : i]; }
+
+    inline const void* keys_end() const { return slotkey + _Slots; }
+
+    template <typename _Less>
+    inline int find_lower(unsigned short n, const _Key& k, const _Less& less) const
+    {
+        int lo = 0;
+        while (lo < n && less(slotkey[lo], k)) ++lo;
+        return lo;
+    }
+
+    template <typename _Less>
+    inline int find_upper(unsigned short n, const _Key& k, const _Less& less) const
+    {
+        int lo = 0;
+        while (lo < n && !less(k, slotkey[lo])) ++lo;
+        return lo;
+    }
+
+    static inline void copy(const btree_leaf_slots& src, unsigned short first, unsigned short last,
+                            btree_leaf_slots& dst, unsigned short dstfirst)
+    {
+        std::copy(src.slotkey + first, src.slotkey + last, dst.slotkey + dstfirst);
+        if (!_UsedAsSet)
+            std::copy(src.slotdata + first, src.slotdata + last, dst.slotdata + dstfirst);
+    }
+
+    static inline void copy_backward(const btree_leaf_slots& src, unsigned short first, unsigned short last,
+                                     btree_leaf_slots& dst, unsigned short dstlast)
+    {
+        std::copy_backward(src.slotkey + first, src.slotkey + last, dst.slotkey + dstlast);
+        if (!_UsedAsSet)
+            std::copy_backward(src.slotdata + first, src.slotdata + last, dst.slotdata + dstlast);
+    }
+};
+
+/// Element-wise slot copies shared by the interleaved and blocked layouts.
+template <typename _Slots>
+struct btree_leaf_slots_copy
+{
+    static inline void copy(const _Slots& src, unsigned short first, unsigned short last,
+                            _Slots& dst, unsigned short dstfirst)
+    {
+        for (; first != last; ++first, ++dstfirst) {
+            dst.key(dstfirst) = src.key(first);
+            dst.data(dstfirst) = src.data(first);
+        }
+    }
+
+    static inline void copy_backward(const _Slots& src, unsigned short first, unsigned short last,
+                                     _Slots& dst, unsigned short dstlast)
+    {
+        while (last != first) {
+            --last, --dstlast;
+            dst.key(dstlast) = src.key(last);
+            dst.data(dstlast) = src.data(last);
+        }
+    }
+};
+
+/// Interleaved layout: one array of (key,data) pairs.
+template <typename _Key, typename _Data, unsigned short _Slots>
+struct btree_leaf_slots<_Key, _Data, _Slots, btree_leaf_interleaved, false>
+    : public btree_leaf_slots_copy< btree_leaf_slots<_Key, _Data, _Slots, btree_leaf_interleaved, false> >
+{
+    struct slot
+    {
+        _Key    key;
+        _Data   data;
+    };
+
+    /// Key/data pairs
+    slot            slots[_Slots];
+
+    inline _Key& key(unsigned short i) { return slots[i].key; }
+    inline const _Key& key(unsigned short i) const { return slots[i].key; }
+
+    inline _Data& data(unsigned short i) { return slots[i].data; }
+    inline const _Data& data(unsigned short i) const { return slots[i].data; }
+
+    inline const void* keys_end() const { return slots + _Slots; }
+
+    template <typename _Less>
+    inline int find_lower(unsigned short n, const _Key& k, const _Less& less) const
+    {
+        int lo = 0;
+        while (lo < n && less(slots[lo].key, k)) ++lo;
+        return lo;
+    }
+
+    template <typename _Less>
+    inline int find_upper(unsigned short n, const _Key& k, const _Less& less) const
+    {
+        int lo = 0;
+        while (lo < n && !less(k, slots[lo].key)) ++lo;
+        return lo;
+    }
+};
+
+/// Blocked layout: blocks of btree_leaf_block keys followed by their data.
+template <typename _Key, typename _Data, unsigned short _Slots>
+struct btree_leaf_slots<_Key, _Data, _Slots, btree_leaf_blocked, false>
+    : public btree_leaf_slots_copy< btree_leaf_slots<_Key, _Data, _Slots, btree_leaf_blocked, false> >
+{
+    static const unsigned short B = btree_leaf_block;
+    static const unsigned short numblocks = (_Slots + B - 1) / B;
+
+    struct block
+    {
+        _Key    key[B];
+        _Data   data[B];
+    };
+
+    /// Blocks of keys followed by their data items
+    block           blocks[numblocks];
+
+    inline _Key& key(unsigned short i) { return blocks[i / B].key[i % B]; }
+    inline const _Key& key(unsigned short i) const { return blocks[i / B].key[i % B]; }
+
+    inline _Data& data(unsigned short i) { return blocks[i / B].data[i % B]; }
+    inline const _Data& data(unsigned short i) const { return blocks[i / B].data[i % B]; }
+
+    inline const void* keys_end() const { return blocks + numblocks; }
+
+    /// Skips full blocks whose last key is less than k, then scans one block.
+    template <typename _Less>
+    inline int find_lower(unsigned short n, const _Key& k, const _Less& less) const
+    {
+        unsigned short b = 0;
+        while ((b + 1) * B < n && less(blocks[b].key[B - 1], k)) ++b;
+
+        const _Key *bk = blocks[b].key;
+        const int m = std::min<int>(n - b * B, B);
+        int i = 0;
+        while (i < m && less(bk[i], k)) ++i;
+        return b * B + i;
+    }
+
+    template <typename _Less>
+    inline int find_upper(unsigned short n, const _Key& k, const _Less& less) const
+    {
+        unsigned short b = 0;
+        while ((b + 1) * B < n && !less(k, blocks[b].key[B - 1])) ++b;
+
+        const _Key *bk = blocks[b].key;
+        const int m = std::min<int>(n - b * B, B);
+        int i = 0;
+        while (i < m && !less(k, bk[i])) ++i;
+        return b * B + i;
+    }
+};
+
+/// Node arena for trees with traits::pooled_children. All nodes of one tree
+/// are carved out of a single reserved address range, so a child can be
+/// referenced by a 32-bit index counted in btree_node_pool::unit bytes from
+/// the start of the range instead of by an 8-byte pointer. Address space is
+/// reserved once and committed in chunks as the tree grows; freed nodes are
+/// kept on per-size free lists. Index 0 is never handed out and stands for
+/// NULL.
+class btree_node_pool
+{
+public:
+    /// Allocation granularity and unit of the child indices.
+    static const size_t unit = 64;
+
+    /// Address space reserved per tree; 32-bit indices in 64 byte units
+    /// could address up to 256 GiB.
+    static const size_t reserve_bytes = size_t(1) << 36;
+
+    /// Memory committed at a time when the bump pointer runs out.
+    static const size_t commit_bytes = size_t(1) << 24;
+
+    btree_node_pool()
+        : m_base(NULL), m_reserved(0), m_committed(0), m_used(unit)
+    { }
+
+    ~btree_node_pool()
+    {
+        if (m_base) munmap(m_base, m_reserved);
+    }
+
+    /// Allocate bytes rounded up to whole units.
+    void* allocate(size_t bytes)
+    {
+        const size_t units = (bytes + unit - 1) / unit;
+
+        if (units < m_free.size() && !m_free[units].empty()) {
+            uint32_t idx = m_free[units].back();
+            m_free[units].pop_back();
+            return pointer(idx);
+        }
+
+        if (!m_base) reserve();
+
+        const size_t need = m_used + units * unit;
+        if (need > m_committed)
+        {
+            size_t grow = (need - m_committed + commit_bytes - 1) / commit_bytes * commit_bytes;
+            if (m_committed + grow > m_reserved) grow = m_reserved - m_committed;
+            if (need > m_committed + grow ||
+                mprotect(m_base + m_committed, grow, PROT_READ | PROT_WRITE) != 0)
+                throw std::bad_alloc();
+            m_committed += grow;
+        }
+
+        void *p = m_base + m_used;
+        m_used = need;
+        return p;
+    }
+
+    /// Return a block of the given size to its free list.
+    void deallocate(void *p, size_t bytes)
+    {
+        const size_t units = (bytes + unit - 1) / unit;
+        if (units >= m_free.size()) m_free.resize(units + 1);
+        m_free[units].push_back(index(p));
+    }
+
+    /// Drop all blocks at once and hand the committed pages back to the
+    /// kernel. Only valid when no node of the tree is alive any more.
+    void reset()
+    {
+        if (m_base && m_committed)
+            madvise(m_base, m_committed, MADV_DONTNEED);
+        m_free.clear();
+        m_used = unit;
+    }
+
+    /// Index of a block returned by allocate(), 0 for NULL.
+    inline uint32_t index(const void *p) const
+    {
+        if (!p) return 0;
+        return static_cast<uint32_t>((static_cast<const char*>(p) - m_base) / unit);
+    }
+
+    /// Block address of an index, NULL for 0.
+    inline void* pointer(uint32_t idx) const
+    {
+        return idx ? m_base + size_t(idx) * unit : NULL;
+    }
+
+    /// Bytes handed out so far, including blocks on the free lists.
+    size_t used_bytes() const
+    {
+        return m_used - unit;
+    }
+
+    void swap(btree_node_pool &other)
+    {
+        std::swap(m_base, other.m_base);
+        std::swap(m_reserved, other.m_reserved);
+        std::swap(m_committed, other.m_committed);
+        std::swap(m_used, other.m_used);
+        m_free.swap(other.m_free);
+    }
+
+private:
+    btree_node_pool(const btree_node_pool&);
+    btree_node_pool& operator=(const btree_node_pool&);
+
+    /// Reserve the address range inaccessible; PROT_NONE private mappings
+    /// are not charged against the overcommit limit.
+    void reserve()
+    {
+        for (size_t bytes = reserve_bytes; bytes >= commit_bytes; bytes /= 2)
+        {
+            void *p = mmap(NULL, bytes, PROT_NONE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (p != MAP_FAILED) {
+                m_base = static_cast<char*>(p);
+                m_reserved = bytes;
+                return;
+            }
+        }
+        throw std::bad_alloc();
+    }
+
+    /// Start of the reserved range
+    char            *m_base;
+
+    /// Length of the reserved range
+    size_t          m_reserved;
+
+    /// Bytes at the start of the range that are readable and writable
+    size_t          m_committed;
+
+    /// Bump pointer offset; the first unit stays unused for index 0
+    size_t          m_used;
+
+    /// Free block indices, by size in units
+    std::vector< std::vector<uint32_t> > m_free;
+};
+
+/// Header of the position-independent tree image written by
+/// btree::write_image(). The image holds the nodes level by level, root
+/// first and leaves last; each level is one contiguous array starting at a
+/// multiple of btree_image_header::align bytes. Children are referenced by
+/// byte offset from the start of the image, so the file can be mapped at
+/// any address and searched in place.
+struct btree_image_header
+{
+    /// Alignment of the header and of every level array
+    static const size_t align = 64;
+
+    /// "stx-bimg", to reject files of other formats
+    char            signature[8];
+
+    /// Currently 1
+    uint32_t        version;
+
+    /// sizeof(btree_image_header)
+    uint32_t        header_bytes;
+
+    /// sizeof(key_type) and sizeof(data_type)
+    uint16_t        key_type_size;
+    uint16_t        data_type_size;
+
+    /// Number of slots in the leaves and in the inner nodes
+    uint16_t        leafslots;
+    uint16_t        innerslots;
+
+    /// Size of one image inner node and one image leaf
+    uint32_t        inner_bytes;
+    uint32_t        leaf_bytes;
+
+    /// Number of levels, 0 for an empty tree
+    uint32_t        height;
+
+    /// Allow duplicates
+    uint32_t        allow_duplicates;
+
+    /// The item count of the tree
+    uint64_t        itemcount;
+
+    /// Number of leaves and inner nodes
+    uint64_t        leaves;
+    uint64_t        innernodes;
+
+    /// Offsets of the root node and of the first leaf
+    uint64_t        root;
+    uint64_t        first_leaf;
+
+    /// Total size of the image in bytes
+    uint64_t        image_bytes;
+
+    /// Fill in the signature and version.
+    inline void sign()
+    {
+        const char s[8] = { 's', 't', 'x', '-', 'b', 'i', 'm', 'g' };
+        std::copy(s, s + 8, signature);
+        version = 1;
+        header_bytes = sizeof(btree_image_header);
+    }
+
+    /// True if the signature and version match sign().
+    inline bool signed_ok() const
+    {
+        const char s[8] = { 's', 't', 'x', '-', 'b', 'i', 'm', 'g' };
+        return std::equal(s, s + 8, signature) && version == 1
+            && header_bytes == sizeof(btree_image_header);
+    }
+};
+
+/// Inner node of a tree image. The slotuse + 1 children are stored next to
+/// each other in the level below, starting at offset first_child.
+template <typename _Key, unsigned short _Slots>
+struct btree_image_inner
+{
+    /// Level in the tree, 1 for the parents of leaves
+    uint16_t        level;
+
+    /// Number of used key slots
+    uint16_t        slotuse;
+
+    uint32_t        reserved;
+
+    /// Offset of the first child from the start of the image
+    uint64_t        first_child;
+
+    /// Separator keys
+    _Key            slotkey[_Slots];
+};
+
+/// Leaf of a tree image, always in the split layout. Leaves are stored in
+/// key order, so the next leaf directly follows the current one.
+template <typename _Key, typename _Data, unsigned short _Slots>
+struct btree_image_leaf
+{
+    /// Number of used slots
+    uint16_t        slotuse;
+
+    uint16_t        reserved[3];
+
+    /// Keys of the data items
+    _Key            slotkey[_Slots];
+
+    /// Data items
+    _Data           slotdata[_Slots];
+};
+
 /** @brief Basic class implementing a base B+ tree data structure in memory.
  *
  * The base implementation of a memory B+ tree. It is based on the
@@ -247,6 +696,44 @@ public:
     /// with BTREE_DEBUG and the key type must be std::ostream printable.
     static const bool                   debug = traits::debug;
 
+private:
+    /// Selects traits::leaf_layout if present, else btree_leaf_split.
+    template <typename T, typename = void>
+    struct select_leaf_layout
+    {
+        static const int value = btree_leaf_split;
+    };
+
+    template <typename T>
+    struct select_leaf_layout<T, std::void_t<decltype(T::leaf_layout)> >
+    {
+        static const int value = T::leaf_layout;
+    };
+
+    /// Selects traits::pooled_children if present, else false.
+    template <typename T, typename = void>
+    struct select_pooled_children
+    {
+        static const bool value = false;
+    };
+
+    template <typename T>
+    struct select_pooled_children<T, std::void_t<decltype(T::pooled_children)> >
+    {
+        static const bool value = T::pooled_children;
+    };
+
+public:
+    /// Layout of the key/data slots in leaves, see btree_leaf_layout. Sets
+    /// have no data items and always use the split layout.
+    static const int                    leaf_layout =
+        used_as_set ? int(btree_leaf_split) : select_leaf_layout<traits>::value;
+
+    /// If true, all nodes are allocated from a btree_node_pool and inner
+    /// nodes reference their children by 32-bit pool index instead of by
+    /// pointer, which leaves more room for keys in each inner node.
+    static const bool                   pooled_children = select_pooled_children<traits>::value;
+
 private:
     // *** Node Classes for In-Memory Nodes
 
@@ -275,6 +762,9 @@ private:
         }
     };
 
+    /// Reference to a child node stored in inner nodes
+    typedef typename std::conditional<pooled_children, uint32_t, node*>::type child_type;
+
     /// Extended structure of a inner node in-memory. Contains only keys and no
     /// data items.
     struct inner_node : public node
@@ -285,8 +775,9 @@ private:
         /// Keys of children or data pointers
         key_type        slotkey[innerslotmax];
 
-        /// Pointers to children
-        node*           childid[innerslotmax+1];
+        /// Pointers to children, or their pool indices with pooled_children.
+        /// Use btree::child() and btree::set_child() to access single slots.
+        child_type      childid[innerslotmax+1];
 
         /// Set variables to initial values
         inline void initialize(const unsigned short l)
@@ -314,10 +805,15 @@ private:
     };
 
     /// Extended structure of a leaf node in memory. Contains pairs of keys and
-    /// data items. Key and data slots are kept in separate arrays, because the
-    /// key array is traversed very often compared to accessing the data items.
+    /// data items, arranged according to leaf_layout. The default split layout
+    /// keeps key and data slots in separate arrays, because the key array is
+    /// traversed very often compared to accessing the data items.
     struct leaf_node : public node
     {
+        /// Slot storage in the configured layout
+        typedef btree_leaf_slots<key_type, data_type, leafslotmax,
+                                 leaf_layout, used_as_set> slots_type;
+
         /// Define an related allocator for the leaf_node structs.
         typedef typename _Alloc::template rebind<leaf_node>::other alloc_type;
 
@@ -327,11 +823,32 @@ private:
         /// Double linked list pointers to traverse the leaves
         leaf_node       *nextleaf;
 
-        /// Keys of children or data pointers
-        key_type        slotkey[leafslotmax];
+        /// Keys and data items
+        slots_type      slots;
+
+        /// Key in slot i
+        inline key_type& key(unsigned short i) { return slots.key(i); }
+        inline const key_type& key(unsigned short i) const { return slots.key(i); }
+
+        /// Data item in slot i
+        inline data_type& data(unsigned short i) { return slots.data(i); }
+        inline const data_type& data(unsigned short i) const { return slots.data(i); }
+
+        /// Copy slots [first,last) of src to dst starting at dstfirst, like
+        /// std::copy. src and dst may be the same leaf if dstfirst <= first.
+        static inline void copy_slots(const leaf_node *src, unsigned short first, unsigned short last,
+                                      leaf_node *dst, unsigned short dstfirst)
+        {
+            slots_type::copy(src->slots, first, last, dst->slots, dstfirst);
+        }
 
-        /// Array of data
-        data_type       slotdata[used_as_set ? 1 : leafslotmax];
+        /// Copy slots [first,last) of src to dst ending at dstlast, like
+        /// std::copy_backward.
+        static inline void copy_slots_backward(const leaf_node *src, unsigned short first, unsigned short last,
+                                               leaf_node *dst, unsigned short dstlast)
+        {
+            slots_type::copy_backward(src->slots, first, last, dst->slots, dstlast);
+        }
 
         /// Set variables to initial values
         inline void initialize()
@@ -364,8 +881,8 @@ private:
         {
             BTREE_ASSERT(used_as_set == false);
             BTREE_ASSERT(slot < node::slotuse);
-            slotkey[slot] = value.first;
-            slotdata[slot] = value.second;
+            key(slot) = value.first;
+            data(slot) = value.second;
         }
 
         /// Set the key pair in slot. Overloaded function used by
@@ -374,10 +891,48 @@ private:
         {
             BTREE_ASSERT(used_as_set == true);
             BTREE_ASSERT(slot < node::slotuse);
-            slotkey[slot] = key;
+            this->key(slot) = key;
+        }
+    };
+
+public:
+    /// Size in bytes of one inner node, used to estimate the memory footprint.
+    static const size_t inner_node_bytes = sizeof(inner_node);
+
+    /// Size in bytes of one leaf node, used to estimate the memory footprint.
+    static const size_t leaf_node_bytes = sizeof(leaf_node);
+
+private:
+    /// Leaf prefetch used when the traits define no prefetch_policy: header
+    /// and key array, for reading, into all cache levels.
+    struct default_prefetch_policy
+    {
+        static void prefetch_node(const void *node, size_t keybytes, size_t /* nodebytes */)
+        {
+            const char *p = static_cast<const char*>(node);
+            for (size_t off = 0; off < keybytes; off += 64)
+                __builtin_prefetch(p + off, 0, 3);
         }
     };
 
+    /// Selects traits::prefetch_policy if present, else the default.
+    template <typename T, typename = void>
+    struct select_prefetch_policy
+    {
+        typedef default_prefetch_policy type;
+    };
+
+    template <typename T>
+    struct select_prefetch_policy<T, std::void_t<typename T::prefetch_policy> >
+    {
+        typedef typename T::prefetch_policy type;
+    };
+
+public:
+    /// Policy used by prefetch_leaf(): a type with a static
+    /// prefetch_node(node, keybytes, nodebytes) function.
+    typedef typename select_prefetch_policy<traits>::type prefetch_policy;
+
 private:
     // *** Template Magic to Convert a pair or key/data types to a value_type
 
@@ -529,13 +1084,13 @@ public:
         /// Key of the current slot
         inline const key_type& key() const
         {
-            return currnode->slotkey[currslot];
+            return currnode->key(currslot);
         }
 
         /// Writable reference to the current data object
         inline data_type& data() const
         {
-            return currnode->slotdata[used_as_set ? 0 : currslot];
+            return currnode->data(currslot);
         }
 
         /// Prefix++ advance the iterator to the next slot
@@ -732,13 +1287,13 @@ public:
         /// Key of the current slot
         inline const key_type& key() const
         {
-            return currnode->slotkey[currslot];
+            return currnode->key(currslot);
         }
 
         /// Read-only reference to the current data object
         inline const data_type& data() const
         {
-            return currnode->slotdata[used_as_set ? 0 : currslot];
+            return currnode->data(currslot);
         }
 
         /// Prefix++ advance the iterator to the next slot
@@ -935,14 +1490,14 @@ public:
         inline const key_type& key() const
         {
             BTREE_ASSERT(currslot > 0);
-            return currnode->slotkey[currslot - 1];
+            return currnode->key(currslot - 1);
         }
 
         /// Writable reference to the current data object
         inline data_type& data() const
         {
             BTREE_ASSERT(currslot > 0);
-            return currnode->slotdata[used_as_set ? 0 : currslot-1];
+            return currnode->data(currslot - 1);
         }
 
         /// Prefix++ advance the iterator to the next slot
@@ -1142,14 +1697,14 @@ public:
         inline const key_type& key() const
         {
             BTREE_ASSERT(currslot > 0);
-            return currnode->slotkey[currslot - 1];
+            return currnode->key(currslot - 1);
         }
 
         /// Read-only reference to the current data object
         inline const data_type& data() const
         {
             BTREE_ASSERT(currslot > 0);
-            return currnode->slotdata[used_as_set ? 0 : currslot-1];
+            return currnode->data(currslot - 1);
         }
 
         /// Prefix++ advance the iterator to the previous slot
@@ -1305,6 +1860,31 @@ private:
     /// Memory allocator.
     allocator_type m_allocator;
 
+    /// Node arena, only used with pooled_children.
+    btree_node_pool m_pool;
+
+    /// Number of key bits indexing the radix table, zero if disabled.
+    unsigned int m_radix_bits = 0;
+
+    /// Number of levels below the root the radix table tries to skip.
+    unsigned int m_radix_depth = 0;
+
+    /// Radix table entries point at nodes of this level or above.
+    unsigned short m_radix_level = 0;
+
+    /// Set by structural changes at or above m_radix_level. Lookups start at
+    /// the root until refresh_radix_table() rebuilds the table.
+    bool m_radix_dirty = false;
+
+    /// Smallest key in the tree when the table was built.
+    key_type m_radix_min = key_type();
+
+    /// Right shift applied to (key - m_radix_min) to get the bucket.
+    unsigned int m_radix_shift = 0;
+
+    /// One start node per bucket.
+    std::vector<const node*> m_radix_table;
+
 public:
     // *** Constructors and Destructor
 
@@ -1362,6 +1942,14 @@ public:
         std::swap(m_stats, from.m_stats);
         std::swap(m_key_less, from.m_key_less);
         std::swap(m_allocator, from.m_allocator);
+        m_pool.swap(from.m_pool);
+        std::swap(m_radix_bits, from.m_radix_bits);
+        std::swap(m_radix_depth, from.m_radix_depth);
+        std::swap(m_radix_level, from.m_radix_level);
+        std::swap(m_radix_dirty, from.m_radix_dirty);
+        std::swap(m_radix_min, from.m_radix_min);
+        std::swap(m_radix_shift, from.m_radix_shift);
+        m_radix_table.swap(from.m_radix_table);
     }
 
 public:
@@ -1465,7 +2053,9 @@ private:
     /// Allocate and initialize a leaf node
     inline leaf_node* allocate_leaf()
     {
-        leaf_node *n = new (leaf_node_allocator().allocate(1)) leaf_node();
+        void *p = pooled_children ? m_pool.allocate(sizeof(leaf_node))
+                                  : static_cast<void*>(leaf_node_allocator().allocate(1));
+        leaf_node *n = new (p) leaf_node();
         n->initialize();
         m_stats.leaves++;
         return n;
@@ -1474,7 +2064,9 @@ private:
     /// Allocate and initialize an inner node
     inline inner_node* allocate_inner(unsigned short level)
     {
-        inner_node *n = new (inner_node_allocator().allocate(1)) inner_node();
+        void *p = pooled_children ? m_pool.allocate(sizeof(inner_node))
+                                  : static_cast<void*>(inner_node_allocator().allocate(1));
+        inner_node *n = new (p) inner_node();
         n->initialize(level);
         m_stats.innernodes++;
         return n;
@@ -1488,18 +2080,52 @@ private:
             leaf_node *ln = static_cast<leaf_node*>(n);
             typename leaf_node::alloc_type a(leaf_node_allocator());
             a.destroy(ln);
-            a.deallocate(ln, 1);
+            if (pooled_children) m_pool.deallocate(ln, sizeof(leaf_node));
+            else a.deallocate(ln, 1);
             m_stats.leaves--;
         }
         else {
             inner_node *in = static_cast<inner_node*>(n);
             typename inner_node::alloc_type a(inner_node_allocator());
             a.destroy(in);
-            a.deallocate(in, 1);
+            if (pooled_children) m_pool.deallocate(in, sizeof(inner_node));
+            else a.deallocate(in, 1);
             m_stats.innernodes--;
         }
     }
 
+    /// Child node in slot of an inner node
+    inline node* child(const inner_node *n, unsigned short slot) const
+    {
+        return decode_child(n->childid[slot]);
+    }
+
+    /// Set the child node in slot of an inner node
+    inline void set_child(inner_node *n, unsigned short slot, node *c)
+    {
+        encode_child(n->childid[slot], c);
+    }
+
+    inline node* decode_child(node *c) const
+    {
+        return c;
+    }
+
+    inline node* decode_child(uint32_t c) const
+    {
+        return static_cast<node*>(m_pool.pointer(c));
+    }
+
+    inline void encode_child(node *&ref, node *c) const
+    {
+        ref = c;
+    }
+
+    inline void encode_child(uint32_t &ref, node *c) const
+    {
+        ref = m_pool.index(c);
+    }
+
     /// Convenient template function for conditional copying of slotdata. This
     /// should be used instead of std::copy for all slotdata manipulations.
     template<class InputIterator, class OutputIterator>
@@ -1537,6 +2163,10 @@ public:
             m_stats = tree_stats();
         }
 
+        if (pooled_children) m_pool.reset();
+
+        m_radix_dirty = true;
+
         BTREE_ASSERT(m_stats.itemcount == 0);
     }
 
@@ -1559,8 +2189,8 @@ private:
 
             for (unsigned short slot = 0; slot < innernode->slotuse + 1; ++slot)
             {
-                clear_recursive(innernode->childid[slot]);
-                free_node(innernode->childid[slot]);
+                clear_recursive(child(innernode, slot));
+                free_node(child(innernode, slot));
             }
         }
     }
@@ -1721,6 +2351,20 @@ private:
         }
     }
 
+    /// Searches for the first key in the leaf n greater or equal to key,
+    /// using the search kernel of the leaf layout.
+    inline int find_lower(const leaf_node *n, const key_type& key) const
+    {
+        return n->slots.find_lower(n->slotuse, key, m_key_less);
+    }
+
+    /// Searches for the first key in the leaf n greater than key, using the
+    /// search kernel of the leaf layout.
+    inline int find_upper(const leaf_node *n, const key_type& key) const
+    {
+        return n->slots.find_upper(n->slotuse, key, m_key_less);
+    }
+
 public:
     // *** Access Functions to the Item Count
 
@@ -1749,6 +2393,33 @@ public:
         return m_stats;
     }
 
+    /// Walk the whole tree depth-first and call visitor(depth, slotuse,
+    /// slotmax, bytes, isleaf) once per node, the root having depth 0. Used
+    /// to collect fill factor and memory statistics per level.
+    template <typename Visitor>
+    void visit_nodes(Visitor &visitor) const
+    {
+        if (m_root) visit_nodes_recursive(m_root, 0, visitor);
+    }
+
+private:
+    /// Recursively visit a subtree for visit_nodes()
+    template <typename Visitor>
+    void visit_nodes_recursive(const node *n, unsigned int depth, Visitor &visitor) const
+    {
+        if (n->isleafnode())
+        {
+            visitor(depth, n->slotuse, leafslotmax, leaf_node_bytes, true);
+            return;
+        }
+
+        visitor(depth, n->slotuse, innerslotmax, inner_node_bytes, false);
+
+        const inner_node *inner = static_cast<const inner_node*>(n);
+        for (unsigned short slot = 0; slot <= inner->slotuse; ++slot)
+            visit_nodes_recursive(child(inner, slot), depth + 1, visitor);
+    }
+
 public:
     // *** Standard Access Functions Querying the Tree by Descending to a Leaf
 
@@ -1756,7 +2427,7 @@ public:
     /// (find(k) != end()) or (count() != 0).
     bool exists(const key_type &key) const
     {
-        const node *n = m_root;
+        const node *n = radix_start(key);
         if (!n) return false;
 
         while(!n->isleafnode())
@@ -1764,57 +2435,160 @@ public:
             const inner_node *inner = static_cast<const inner_node*>(n);
             int slot = find_lower(inner, key);
 
-            n = inner->childid[slot];
+            n = child(inner, slot);
         }
 
         const leaf_node *leaf = static_cast<const leaf_node*>(n);
 
         int slot = find_lower(leaf, key);
-        return (slot < leaf->slotuse && key_equal(key, leaf->slotkey[slot]));
+        return (slot < leaf->slotuse && key_equal(key, leaf->key(slot)));
     }
 
     /// Tries to locate a key in the B+ tree and returns an iterator to the
     /// key/data slot if found. If unsuccessful it returns end().
     iterator find(const key_type &key)
     {
-        node *n = m_root;
+        node *n = const_cast<node*>(radix_start(key));
+        if (!n) return end();
+
+        while(!n->isleafnode())
+        {
+            const inner_node *inner = static_cast<const inner_node*>(n);
+            int slot = find_lower(inner, key);
+
+            n = child(inner, slot);
+        }
+
+        leaf_node *leaf = static_cast<leaf_node*>(n);
+
+        int slot = find_lower(leaf, key);
+        return (slot < leaf->slotuse && key_equal(key, leaf->key(slot)))
+            ? iterator(leaf, slot) : end();
+    }
+
+    /// Tries to locate a key in the B+ tree and returns an constant iterator
+    /// to the key/data slot if found. If unsuccessful it returns end().
+    const_iterator find(const key_type &key) const
+    {
+        const node *n = radix_start(key);
+        if (!n) return end();
+
+        while(!n->isleafnode())
+        {
+            const inner_node *inner = static_cast<const inner_node*>(n);
+            int slot = find_lower(inner, key);
+
+            n = child(inner, slot);
+        }
+
+        const leaf_node *leaf = static_cast<const leaf_node*>(n);
+
+        int slot = find_lower(leaf, key);
+        return (slot < leaf->slotuse && key_equal(key, leaf->key(slot)))
+            ? const_iterator(leaf, slot) : end();
+    }
+
+    /// Descend the inner nodes for key and prefetch the leaf the key would
+    /// be found in, without reading the leaf itself. A software-pipelined
+    /// lookup loop calls this for a query a few iterations ahead, so the
+    /// leaf miss overlaps with the current lookup. Which part of the leaf is
+    /// fetched, and with which hint, is decided by Policy, by default the
+    /// prefetch_policy of the tree traits.
+    template <typename Policy = prefetch_policy>
+    void prefetch_leaf(const key_type &key) const
+    {
+        const node *n = radix_start(key);
+        if (!n) return;
+
+        while(!n->isleafnode())
+        {
+            const inner_node *inner = static_cast<const inner_node*>(n);
+            int slot = find_lower(inner, key);
+
+            n = child(inner, slot);
+        }
+
+        const leaf_node *leaf = static_cast<const leaf_node*>(n);
+        const size_t keybytes = static_cast<const char*>(leaf->slots.keys_end())
+                                - reinterpret_cast<const char*>(leaf);
+
+        Policy::prefetch_node(leaf, keybytes, leaf_node_bytes);
+    }
+
+    /// Same lookup as find(), always starting at the root, but reports every
+    /// node on the path to \p visitor: visitor.enter(depth, node, bytes)
+    /// right before the node is searched (the root has depth 0) and
+    /// visitor.done(depth) after the leaf search. Used to attribute lookup
+    /// cost and memory accesses to the tree levels.
+    template <typename Visitor>
+    const_iterator find_visit(const key_type &key, Visitor &visitor) const
+    {
+        const node *n = m_root;
         if (!n) return end();
 
+        unsigned int depth = 0;
         while(!n->isleafnode())
         {
+            visitor.enter(depth, n, inner_node_bytes);
+
             const inner_node *inner = static_cast<const inner_node*>(n);
             int slot = find_lower(inner, key);
 
-            n = inner->childid[slot];
+            n = child(inner, slot);
+            ++depth;
         }
 
-        leaf_node *leaf = static_cast<leaf_node*>(n);
+        visitor.enter(depth, n, leaf_node_bytes);
+
+        const leaf_node *leaf = static_cast<const leaf_node*>(n);
 
         int slot = find_lower(leaf, key);
-        return (slot < leaf->slotuse && key_equal(key, leaf->slotkey[slot]))
-            ? iterator(leaf, slot) : end();
+        const_iterator it = (slot < leaf->slotuse && key_equal(key, leaf->key(slot)))
+            ? const_iterator(leaf, slot) : end();
+
+        visitor.done(depth);
+        return it;
     }
 
-    /// Tries to locate a key in the B+ tree and returns an constant iterator
-    /// to the key/data slot if found. If unsuccessful it returns end().
-    const_iterator find(const key_type &key) const
+    /// Same lookup as find_visit(), but reports the individual memory reads
+    /// instead of whole nodes: tracer.touch(depth, ptr, bytes) for the node
+    /// header, every key compared by the linear search and the child slot
+    /// followed, then tracer.done(depth) after the leaf search. Feeds the
+    /// cache simulator with the exact bytes a lookup touches.
+    template <typename Tracer>
+    const_iterator find_trace(const key_type &key, Tracer &tracer) const
     {
         const node *n = m_root;
         if (!n) return end();
 
+        unsigned int depth = 0;
         while(!n->isleafnode())
         {
             const inner_node *inner = static_cast<const inner_node*>(n);
             int slot = find_lower(inner, key);
 
-            n = inner->childid[slot];
+            tracer.touch(depth, n, sizeof(node));
+            for (int i = 0; i <= slot && i < inner->slotuse; ++i)
+                tracer.touch(depth, &inner->slotkey[i], sizeof(key_type));
+            tracer.touch(depth, &inner->childid[slot], sizeof(child_type));
+
+            n = child(inner, slot);
+            ++depth;
         }
 
         const leaf_node *leaf = static_cast<const leaf_node*>(n);
 
         int slot = find_lower(leaf, key);
-        return (slot < leaf->slotuse && key_equal(key, leaf->slotkey[slot]))
+
+        tracer.touch(depth, n, sizeof(node));
+        for (int i = 0; i <= slot && i < leaf->slotuse; ++i)
+            tracer.touch(depth, &leaf->key(i), sizeof(key_type));
+
+        const_iterator it = (slot < leaf->slotuse && key_equal(key, leaf->key(slot)))
             ? const_iterator(leaf, slot) : end();
+
+        tracer.done(depth);
+        return it;
     }
 
     /// Tries to locate a key in the B+ tree and returns the number of
@@ -1829,7 +2603,7 @@ public:
             const inner_node *inner = static_cast<const inner_node*>(n);
             int slot = find_lower(inner, key);
 
-            n = inner->childid[slot];
+            n = child(inner, slot);
         }
 
         const leaf_node *leaf = static_cast<const leaf_node*>(n);
@@ -1837,7 +2611,7 @@ public:
         int slot = find_lower(leaf, key);
         size_type num = 0;
 
-        while (leaf && slot < leaf->slotuse && key_equal(key, leaf->slotkey[slot]))
+        while (leaf && slot < leaf->slotuse && key_equal(key, leaf->key(slot)))
         {
             ++num;
             if (++slot >= leaf->slotuse)
@@ -1862,7 +2636,7 @@ public:
             const inner_node *inner = static_cast<const inner_node*>(n);
             int slot = find_lower(inner, key);
 
-            n = inner->childid[slot];
+            n = child(inner, slot);
         }
 
         leaf_node *leaf = static_cast<leaf_node*>(n);
@@ -1884,7 +2658,7 @@ public:
             const inner_node *inner = static_cast<const inner_node*>(n);
             int slot = find_lower(inner, key);
 
-            n = inner->childid[slot];
+            n = child(inner, slot);
         }
 
         const leaf_node *leaf = static_cast<const leaf_node*>(n);
@@ -1905,7 +2679,7 @@ public:
             const inner_node *inner = static_cast<const inner_node*>(n);
             int slot = find_upper(inner, key);
 
-            n = inner->childid[slot];
+            n = child(inner, slot);
         }
 
         leaf_node *leaf = static_cast<leaf_node*>(n);
@@ -1927,7 +2701,7 @@ public:
             const inner_node *inner = static_cast<const inner_node*>(n);
             int slot = find_upper(inner, key);
 
-            n = inner->childid[slot];
+            n = child(inner, slot);
         }
 
         const leaf_node *leaf = static_cast<const leaf_node*>(n);
@@ -1948,6 +2722,143 @@ public:
         return std::pair<const_iterator, const_iterator>(lower_bound(key), upper_bound(key));
     }
 
+public:
+    // *** Radix Table Descent
+
+    /// Enable a flat lookup table indexed by the top \p bits bits of (key -
+    /// smallest key). Each bucket stores the deepest node, at most \p depth
+    /// levels below the root, whose subtree contains the whole key range of
+    /// the bucket. exists() and find() then start descending there instead of
+    /// at the root. The table is built here. Splits, merges and rebalancing
+    /// at or above the table level, and root changes, mark it stale; stale
+    /// tables are ignored (lookups start at the root) until the next
+    /// refresh_radix_table(). Const lookups never modify the tree and may run
+    /// concurrently. Integer keys only.
+    void enable_radix_table(unsigned int bits, unsigned int depth)
+    {
+        BTREE_ASSERT(bits < sizeof(size_t) * 8);
+        m_radix_bits = bits;
+        m_radix_depth = depth;
+        rebuild_radix_table();
+    }
+
+    /// Rebuild the radix table if a structural change since the last build
+    /// made it stale. Call before a read phase that follows updates.
+    void refresh_radix_table()
+    {
+        if (m_radix_bits && m_radix_dirty) rebuild_radix_table();
+    }
+
+    /// Remove the radix table, lookups start at the root again.
+    void disable_radix_table()
+    {
+        m_radix_bits = 0;
+        std::vector<const node*>().swap(m_radix_table);
+    }
+
+    /// Size of the radix table in bytes.
+    size_t radix_table_bytes() const
+    {
+        return m_radix_table.size() * sizeof(const node*);
+    }
+
+    /// Average number of levels skipped by starting at a table entry.
+    double radix_avg_skipped_levels() const
+    {
+        if (m_radix_table.empty()) return 0.0;
+
+        size_t skipped = 0;
+        for (size_t b = 0; b < m_radix_table.size(); ++b)
+            skipped += m_root->level - m_radix_table[b]->level;
+
+        return static_cast<double>(skipped) / m_radix_table.size();
+    }
+
+private:
+    /// Node to start a lookup descent at: the radix table entry of the key's
+    /// bucket, or the root if no table is enabled or the table is stale.
+    /// Read-only, so concurrent const lookups are safe.
+    const node* radix_start(const key_type& key) const
+    {
+        if (!std::is_integral<key_type>::value || m_radix_bits == 0)
+            return m_root;
+
+        if (m_radix_dirty || m_radix_table.empty()) return m_root;
+
+        return m_radix_table[radix_bucket(key)];
+    }
+
+    /// Bucket of a key, keys outside [min, max] clamp to the first/last one.
+    size_t radix_bucket(const key_type& key) const
+    {
+        if constexpr (std::is_integral<key_type>::value)
+        {
+            typedef typename std::make_unsigned<key_type>::type ukey_type;
+
+            if (!key_less(m_radix_min, key)) return 0;
+            ukey_type offset = static_cast<ukey_type>(key) - static_cast<ukey_type>(m_radix_min);
+            size_t b = static_cast<size_t>(offset >> m_radix_shift);
+            return std::min(b, m_radix_table.size() - 1);
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    /// Build the table: for every bucket, descend with its smallest and its
+    /// largest key together until they pick different children or the target
+    /// level is reached. find_lower() is monotonic in the key, so every key
+    /// of the bucket follows the same path down to that node.
+    void rebuild_radix_table()
+    {
+        m_radix_dirty = false;
+        m_radix_table.clear();
+
+        if constexpr (std::is_integral<key_type>::value)
+        {
+            if (!m_root || m_stats.itemcount == 0) return;
+
+            const key_type kmin = m_headleaf->key(0);
+            const key_type kmax = m_tailleaf->key(m_tailleaf->slotuse - 1);
+
+            typedef typename std::make_unsigned<key_type>::type ukey_type;
+            const ukey_type range = static_cast<ukey_type>(kmax) - static_cast<ukey_type>(kmin);
+
+            unsigned int shift = 0;
+            while (shift < sizeof(ukey_type) * 8 && (range >> shift) >= (ukey_type(1) << m_radix_bits))
+                ++shift;
+
+            const size_t buckets = static_cast<size_t>(range >> shift) + 1;
+
+            m_radix_min = kmin;
+            m_radix_shift = shift;
+            m_radix_level = (m_root->level > m_radix_depth) ? m_root->level - m_radix_depth : 1;
+            m_radix_table.resize(buckets);
+
+            for (size_t b = 0; b < buckets; ++b)
+            {
+                // the outermost buckets also cover keys beyond the key range
+                key_type lo = (b == 0) ? std::numeric_limits<key_type>::min()
+                    : static_cast<key_type>(static_cast<ukey_type>(kmin) + (static_cast<ukey_type>(b) << shift));
+                key_type hi = (b + 1 == buckets) ? std::numeric_limits<key_type>::max()
+                    : static_cast<key_type>(static_cast<ukey_type>(kmin) + (static_cast<ukey_type>(b + 1) << shift) - 1);
+
+                const node *n = m_root;
+                while (!n->isleafnode() && n->level > m_radix_level)
+                {
+                    const inner_node *inner = static_cast<const inner_node*>(n);
+                    int slot = find_lower(inner, lo);
+                    if (slot != find_lower(inner, hi)) break;
+
+                    n = child(inner, slot);
+                }
+
+                m_radix_table[b] = n;
+            }
+        }
+    }
+
 public:
     // *** B+ Tree Object Comparison Functions
 
@@ -2003,11 +2914,15 @@ public:
             m_key_less = other.key_comp();
             m_allocator = other.get_allocator();
 
+            m_radix_bits = other.m_radix_bits;
+            m_radix_depth = other.m_radix_depth;
+            m_radix_dirty = true;
+
             if (other.size() != 0)
             {
                 m_stats.leaves = m_stats.innernodes = 0;
                 if (other.m_root) {
-                    m_root = copy_recursive(other.m_root);
+                    m_root = copy_recursive(other.m_root, other);
                 }
                 m_stats = other.m_stats;
             }
@@ -2023,21 +2938,25 @@ public:
         : m_root(NULL), m_headleaf(NULL), m_tailleaf(NULL),
           m_stats( other.m_stats ),
           m_key_less( other.key_comp() ),
-          m_allocator( other.get_allocator() )
+          m_allocator( other.get_allocator() ),
+          m_radix_bits( other.m_radix_bits ),
+          m_radix_depth( other.m_radix_depth ),
+          m_radix_dirty( true )
     {
         if (size() > 0)
         {
             m_stats.leaves = m_stats.innernodes = 0;
             if (other.m_root) {
-                m_root = copy_recursive(other.m_root);
+                m_root = copy_recursive(other.m_root, other);
             }
             if (selfverify) verify();
         }
     }
 
 private:
-    /// Recursively copy nodes from another B+ tree object
-    struct node* copy_recursive(const node *n)
+    /// Recursively copy nodes from another B+ tree object. The children of n
+    /// are resolved through other, which owns n.
+    struct node* copy_recursive(const node *n, const btree_self &other)
     {
         if (n->isleafnode())
         {
@@ -2045,8 +2964,7 @@ private:
             leaf_node *newleaf = allocate_leaf();
 
             newleaf->slotuse = leaf->slotuse;
-            std::copy(leaf->slotkey, leaf->slotkey + leaf->slotuse, newleaf->slotkey);
-            data_copy(leaf->slotdata, leaf->slotdata + leaf->slotuse, newleaf->slotdata);
+            leaf_node::copy_slots(leaf, 0, leaf->slotuse, newleaf, 0);
 
             if (m_headleaf == NULL)
             {
@@ -2072,7 +2990,7 @@ private:
 
             for (unsigned short slot = 0; slot <= inner->slotuse; ++slot)
             {
-                newinner->childid[slot] = copy_recursive(inner->childid[slot]);
+                set_child(newinner, slot, copy_recursive(other.child(inner, slot), other));
             }
 
             return newinner;
@@ -2148,6 +3066,7 @@ private:
 
         if (m_root == NULL) {
             m_root = m_headleaf = m_tailleaf = allocate_leaf();
+            m_radix_dirty = true;
         }
 
         std::pair<iterator, bool> r = insert_descend(m_root, key, value, &newkey, &newchild);
@@ -2157,12 +3076,13 @@ private:
             inner_node *newroot = allocate_inner(m_root->level + 1);
             newroot->slotkey[0] = newkey;
 
-            newroot->childid[0] = m_root;
-            newroot->childid[1] = newchild;
+            set_child(newroot, 0, m_root);
+            set_child(newroot, 1, newchild);
 
             newroot->slotuse = 1;
 
             m_root = newroot;
+            m_radix_dirty = true;
         }
 
         // increment itemcount if the item was inserted
@@ -2200,9 +3120,9 @@ private:
 
             int slot = find_lower(inner, key);
 
-            BTREE_PRINT("btree::insert_descend into " << inner->childid[slot]);
+            BTREE_PRINT("btree::insert_descend into " << child(inner, slot));
 
-            std::pair<iterator, bool> r = insert_descend(inner->childid[slot],
+            std::pair<iterator, bool> r = insert_descend(child(inner, slot),
                                                          key, value, &newkey, &newchild);
 
             if (newchild)
@@ -2238,11 +3158,11 @@ private:
 
                         // move the split key and it's datum into the left node
                         inner->slotkey[inner->slotuse] = *splitkey;
-                        inner->childid[inner->slotuse+1] = splitinner->childid[0];
+                        set_child(inner, inner->slotuse+1, child(splitinner, 0));
                         inner->slotuse++;
 
                         // set new split key and move corresponding datum into right node
-                        splitinner->childid[0] = newchild;
+                        set_child(splitinner, 0, newchild);
                         *splitkey = newkey;
 
                         return r;
@@ -2267,7 +3187,7 @@ private:
                                    inner->childid + inner->slotuse+2);
 
                 inner->slotkey[slot] = newkey;
-                inner->childid[slot + 1] = newchild;
+                set_child(inner, slot + 1, newchild);
                 inner->slotuse++;
             }
 
@@ -2279,7 +3199,7 @@ private:
 
             int slot = find_lower(leaf, key);
 
-            if (!allow_duplicates && slot < leaf->slotuse && key_equal(key, leaf->slotkey[slot])) {
+            if (!allow_duplicates && slot < leaf->slotuse && key_equal(key, leaf->key(slot))) {
                 return std::pair<iterator, bool>(iterator(leaf, slot), false);
             }
 
@@ -2298,13 +3218,11 @@ private:
             // move items and put data item into correct data slot
             BTREE_ASSERT(slot >= 0 && slot <= leaf->slotuse);
 
-            std::copy_backward(leaf->slotkey + slot, leaf->slotkey + leaf->slotuse,
-                               leaf->slotkey + leaf->slotuse+1);
-            data_copy_backward(leaf->slotdata + slot, leaf->slotdata + leaf->slotuse,
-                               leaf->slotdata + leaf->slotuse+1);
+            leaf_node::copy_slots_backward(leaf, slot, leaf->slotuse,
+                                           leaf, leaf->slotuse+1);
 
-            leaf->slotkey[slot] = key;
-            if (!used_as_set) leaf->slotdata[slot] = value;
+            leaf->key(slot) = key;
+            if (!used_as_set) leaf->data(slot) = value;
             leaf->slotuse++;
 
             if (splitnode && leaf != *splitnode && slot == leaf->slotuse-1)
@@ -2342,16 +3260,13 @@ private:
             newleaf->nextleaf->prevleaf = newleaf;
         }
 
-        std::copy(leaf->slotkey + mid, leaf->slotkey + leaf->slotuse,
-                  newleaf->slotkey);
-        data_copy(leaf->slotdata + mid, leaf->slotdata + leaf->slotuse,
-                  newleaf->slotdata);
+        leaf_node::copy_slots(leaf, mid, leaf->slotuse, newleaf, 0);
 
         leaf->slotuse = mid;
         leaf->nextleaf = newleaf;
         newleaf->prevleaf = leaf;
 
-        *_newkey = leaf->slotkey[leaf->slotuse-1];
+        *_newkey = leaf->key(leaf->slotuse-1);
         *_newleaf = newleaf;
     }
 
@@ -2378,6 +3293,9 @@ private:
 
         inner_node *newinner = allocate_inner(inner->level);
 
+        // splits below the radix table level keep every table entry valid
+        if (inner->level >= m_radix_level) m_radix_dirty = true;
+
         newinner->slotuse = inner->slotuse - (mid + 1);
 
         std::copy(inner->slotkey + mid+1, inner->slotkey + inner->slotuse,
@@ -2402,6 +3320,7 @@ public:
     {
         BTREE_ASSERT(empty());
 
+        m_radix_dirty = true;
         m_stats.itemcount = iend - ibegin;
 
         // calculate number of leaves needed, round up.
@@ -2466,15 +3385,15 @@ public:
             // copy last key from each leaf and set child
             for (unsigned short s = 0; s < n->slotuse; ++s)
             {
-                n->slotkey[s] = leaf->slotkey[leaf->slotuse-1];
-                n->childid[s] = leaf;
+                n->slotkey[s] = leaf->key(leaf->slotuse-1);
+                set_child(n, s, leaf);
                 leaf = leaf->nextleaf;
             }
-            n->childid[n->slotuse] = leaf;
+            set_child(n, n->slotuse, leaf);
 
             // track max key of any descendant.
             nextlevel[i].first = n;
-            nextlevel[i].second = &leaf->slotkey[leaf->slotuse-1];
+            nextlevel[i].second = &leaf->key(leaf->slotuse-1);
 
             leaf = leaf->nextleaf;
             num_leaves -= n->slotuse+1;
@@ -2504,10 +3423,10 @@ public:
                 for (unsigned short s = 0; s < n->slotuse; ++s)
                 {
                     n->slotkey[s] = *nextlevel[inner_index].second;
-                    n->childid[s] = nextlevel[inner_index].first;
+                    set_child(n, s, nextlevel[inner_index].first);
                     ++inner_index;
                 }
-                n->childid[n->slotuse] = nextlevel[inner_index].first;
+                set_child(n, n->slotuse, nextlevel[inner_index].first);
 
                 // reuse nextlevel array for parents, because we can overwrite
                 // slots we've already consumed.
@@ -2527,6 +3446,307 @@ public:
         if (selfverify) verify();
     }
 
+public:
+    // *** Batch Insertion - Merge a Sorted Batch into Existing Leaves
+
+    /// Insert the range [first,last) of key/data pairs as one batch. The batch
+    /// is sorted by key and routed down the tree in a single pass: every
+    /// target leaf is visited once, all of its new items are merged into it,
+    /// and an overflowing leaf is split once into as many evenly filled
+    /// siblings as required. Overflowing inner nodes are handled the same way
+    /// on the recursion unroll. Keys already present in the tree, and repeated
+    /// keys within the batch, are skipped like insert() would. Returns the
+    /// number of items inserted. Trees allowing duplicates fall back to
+    /// individual insert() calls.
+    template <typename InputIterator>
+    size_type insert_batch(InputIterator first, InputIterator last)
+    {
+        if (allow_duplicates)
+        {
+            size_type oldsize = size();
+            insert(first, last);
+            return size() - oldsize;
+        }
+
+        std::vector<pair_type> batch(first, last);
+        if (batch.empty()) return 0;
+
+        // stable sort, so that the first of several equal keys wins
+        pair_key_less pkless(m_key_less);
+        if (!std::is_sorted(batch.begin(), batch.end(), pkless))
+            std::stable_sort(batch.begin(), batch.end(), pkless);
+
+        batch.erase(std::unique(batch.begin(), batch.end(), pair_key_equal(m_key_less)),
+                    batch.end());
+
+        if (m_root == NULL) {
+            m_root = m_headleaf = m_tailleaf = allocate_leaf();
+            m_radix_dirty = true;
+        }
+
+        split_list splits;
+        std::vector<pair_type> scratch;
+
+        size_type inserted = insert_batch_descend(m_root, batch.data(), batch.data() + batch.size(),
+                                                  splits, scratch);
+
+        // grow new roots until all split siblings hang below a single node
+        while (!splits.empty())
+        {
+            inner_node *newroot = allocate_inner(m_root->level + 1);
+            set_child(newroot, 0, m_root);
+            newroot->slotuse = 0;
+
+            m_root = newroot;
+            m_radix_dirty = true;
+
+            split_list rootsplits;
+            insert_batch_children(newroot, pending_list(1, pending_split(0, splits)), rootsplits);
+            splits.swap(rootsplits);
+        }
+
+        m_stats.itemcount += inserted;
+
+        if (selfverify) verify();
+
+        return inserted;
+    }
+
+private:
+    // *** Private Batch Insertion Functions
+
+    /// Orders key/data pairs by their key only.
+    struct pair_key_less
+    {
+        key_compare     key_less;
+
+        inline explicit pair_key_less(const key_compare &kc)
+            : key_less(kc)
+        { }
+
+        inline bool operator()(const pair_type &a, const pair_type &b) const
+        {
+            return key_less(a.first, b.first);
+        }
+
+        inline bool operator()(const key_type &a, const pair_type &b) const
+        {
+            return key_less(a, b.first);
+        }
+    };
+
+    /// Equality of key/data pairs by their key only, used to drop repeated
+    /// keys from a sorted batch.
+    struct pair_key_equal
+    {
+        key_compare     key_less;
+
+        inline explicit pair_key_equal(const key_compare &kc)
+            : key_less(kc)
+        { }
+
+        inline bool operator()(const pair_type &a, const pair_type &b) const
+        {
+            return !key_less(a.first, b.first) && !key_less(b.first, a.first);
+        }
+    };
+
+    /// New right siblings of a node created by a batch split, each with the
+    /// separator key which belongs in front of it in the parent.
+    typedef std::vector< std::pair<key_type, node*> > split_list;
+
+    /// The split siblings returned by the child in a given slot.
+    typedef std::pair<unsigned short, split_list> pending_split;
+
+    /// All child splits of one inner node, in slot order.
+    typedef std::vector<pending_split> pending_list;
+
+    /// Recursively route the sorted, duplicate-free run [begin,end) down to
+    /// the leaves. New right siblings of n are appended to splits. The
+    /// scratch vector is reused by all leaf merges of one batch.
+    size_type insert_batch_descend(node* n, const pair_type* begin, const pair_type* end,
+                                   split_list &splits, std::vector<pair_type> &scratch)
+    {
+        if (!n->isleafnode())
+        {
+            inner_node *inner = static_cast<inner_node*>(n);
+
+            size_type inserted = 0;
+            pending_list pending;
+            split_list childsplits;
+
+            const pair_type* run = begin;
+            for (unsigned short slot = 0; slot <= inner->slotuse && run != end; ++slot)
+            {
+                // find_lower() routes key to the first slot with key <= slotkey
+                const pair_type* runend = end;
+                if (slot < inner->slotuse) {
+                    runend = std::upper_bound(run, end, inner->slotkey[slot], pair_key_less(m_key_less));
+                }
+
+                if (run != runend)
+                {
+                    inserted += insert_batch_descend(child(inner, slot), run, runend,
+                                                     childsplits, scratch);
+
+                    if (!childsplits.empty()) {
+                        pending.push_back(pending_split(slot, split_list()));
+                        pending.back().second.swap(childsplits);
+                    }
+                }
+
+                run = runend;
+            }
+
+            if (!pending.empty()) {
+                insert_batch_children(inner, pending, splits);
+            }
+
+            return inserted;
+        }
+        else // n->isleafnode() == true
+        {
+            leaf_node *leaf = static_cast<leaf_node*>(n);
+
+            // merge the existing slots and the run, existing keys win
+            scratch.clear();
+            scratch.reserve(leaf->slotuse + (end - begin));
+
+            unsigned short slot = 0;
+            const pair_type* it = begin;
+            while (slot < leaf->slotuse || it != end)
+            {
+                if (it == end || (slot < leaf->slotuse && key_less(leaf->key(slot), it->first))) {
+                    scratch.push_back(pair_type(leaf->key(slot),
+                                                used_as_set ? data_type() : leaf->data(slot)));
+                    ++slot;
+                }
+                else if (slot < leaf->slotuse && key_equal(leaf->key(slot), it->first)) {
+                    ++it;
+                }
+                else {
+                    scratch.push_back(*it);
+                    ++it;
+                }
+            }
+
+            size_type inserted = scratch.size() - leaf->slotuse;
+            if (inserted == 0) return 0;
+
+            // split the leaf once into evenly filled pieces
+            size_t num_items = scratch.size();
+            size_t num_pieces = (num_items + leafslotmax-1) / leafslotmax;
+
+            leaf_node *nextleaf = leaf->nextleaf;
+            leaf_node *piece = leaf;
+            size_t pos = 0;
+
+            for (size_t p = 0; p < num_pieces; ++p)
+            {
+                if (p > 0)
+                {
+                    leaf_node *newleaf = allocate_leaf();
+                    newleaf->prevleaf = piece;
+                    piece->nextleaf = newleaf;
+
+                    splits.push_back(std::make_pair(piece->key(piece->slotuse-1),
+                                                    static_cast<node*>(newleaf)));
+                    piece = newleaf;
+                }
+
+                piece->slotuse = static_cast<unsigned short>(num_items / (num_pieces-p));
+                for (unsigned short s = 0; s < piece->slotuse; ++s, ++pos)
+                {
+                    piece->key(s) = scratch[pos].first;
+                    if (!used_as_set) piece->data(s) = scratch[pos].second;
+                }
+
+                num_items -= piece->slotuse;
+            }
+
+            BTREE_ASSERT(pos == scratch.size() && num_items == 0);
+
+            piece->nextleaf = nextleaf;
+            if (nextleaf == NULL) {
+                m_tailleaf = piece;
+            }
+            else {
+                nextleaf->prevleaf = piece;
+            }
+
+            return inserted;
+        }
+    }
+
+    /// Merge the split siblings of the children listed in pending into the
+    /// inner node, and split it once into evenly filled pieces if it
+    /// overflows. New right siblings of inner are appended to splits.
+    void insert_batch_children(inner_node* inner, const pending_list &pending, split_list &splits)
+    {
+        std::vector<key_type> keys;
+        std::vector<node*> children;
+
+        size_t num_new = 0;
+        for (size_t i = 0; i < pending.size(); ++i)
+            num_new += pending[i].second.size();
+
+        keys.reserve(inner->slotuse + num_new);
+        children.reserve(inner->slotuse + 1 + num_new);
+
+        typename pending_list::const_iterator pi = pending.begin();
+        for (unsigned short slot = 0; slot <= inner->slotuse; ++slot)
+        {
+            children.push_back(child(inner, slot));
+
+            if (pi != pending.end() && pi->first == slot)
+            {
+                for (size_t s = 0; s < pi->second.size(); ++s)
+                {
+                    keys.push_back(pi->second[s].first);
+                    children.push_back(pi->second[s].second);
+                }
+                ++pi;
+            }
+
+            if (slot < inner->slotuse) keys.push_back(inner->slotkey[slot]);
+        }
+
+        BTREE_ASSERT(pi == pending.end() && keys.size() + 1 == children.size());
+
+        size_t num_children = children.size();
+        size_t num_pieces = (num_children + innerslotmax) / (innerslotmax+1);
+
+        inner_node *piece = inner;
+        size_t pos = 0;
+
+        for (size_t p = 0; p < num_pieces; ++p)
+        {
+            if (p > 0)
+            {
+                inner_node *newinner = allocate_inner(inner->level);
+
+                // splits below the radix table level keep every table entry valid
+                if (inner->level >= m_radix_level) m_radix_dirty = true;
+
+                // the key between two pieces moves up into the parent
+                splits.push_back(std::make_pair(keys[pos-1], static_cast<node*>(newinner)));
+                piece = newinner;
+            }
+
+            size_t count = num_children / (num_pieces-p);
+            piece->slotuse = static_cast<unsigned short>(count - 1);
+
+            std::copy(keys.begin() + pos, keys.begin() + pos + count - 1, piece->slotkey);
+            for (size_t c = 0; c < count; ++c)
+                set_child(piece, static_cast<unsigned short>(c), children[pos + c]);
+
+            pos += count;
+            num_children -= count;
+        }
+
+        BTREE_ASSERT(pos == children.size() && num_children == 0);
+    }
+
 private:
     // *** Support Class Encapsulating Deletion Results
 
@@ -2604,7 +3824,9 @@ public:
         result_t result = erase_one_descend(key, m_root, NULL, NULL, NULL, NULL, NULL, 0);
 
         if (!result.has(btree_not_found))
+        {
             --m_stats.itemcount;
+        }
 
 #ifdef BTREE_DEBUG
         if (debug) print(std::cout);
@@ -2641,7 +3863,9 @@ public:
         result_t result = erase_iter_descend(iter, m_root, NULL, NULL, NULL, NULL, NULL, 0);
 
         if (!result.has(btree_not_found))
+        {
             --m_stats.itemcount;
+        }
 
 #ifdef BTREE_DEBUG
         if (debug) print(std::cout);
@@ -2684,7 +3908,7 @@ private:
 
             int slot = find_lower(leaf, key);
 
-            if (slot >= leaf->slotuse || !key_equal(key, leaf->slotkey[slot]))
+            if (slot >= leaf->slotuse || !key_equal(key, leaf->key(slot)))
             {
                 BTREE_PRINT("Could not find key " << key << " to erase.");
 
@@ -2693,10 +3917,7 @@ private:
 
             BTREE_PRINT("Found key in leaf " << curr << " at slot " << slot);
 
-            std::copy(leaf->slotkey + slot+1, leaf->slotkey + leaf->slotuse,
-                      leaf->slotkey + slot);
-            data_copy(leaf->slotdata + slot+1, leaf->slotdata + leaf->slotuse,
-                      leaf->slotdata + slot);
+            leaf_node::copy_slots(leaf, slot+1, leaf->slotuse, leaf, slot);
 
             leaf->slotuse--;
 
@@ -2708,15 +3929,15 @@ private:
             {
                 if (parent && parentslot < parent->slotuse)
                 {
-                    BTREE_ASSERT(parent->childid[parentslot] == curr);
-                    parent->slotkey[parentslot] = leaf->slotkey[leaf->slotuse - 1];
+                    BTREE_ASSERT(child(parent, parentslot) == curr);
+                    parent->slotkey[parentslot] = leaf->key(leaf->slotuse - 1);
                 }
                 else
                 {
                     if (leaf->slotuse >= 1)
                     {
-                        BTREE_PRINT("Scheduling lastkeyupdate: key " << leaf->slotkey[leaf->slotuse - 1]);
-                        myres |= result_t(btree_update_lastkey, leaf->slotkey[leaf->slotuse - 1]);
+                        BTREE_PRINT("Scheduling lastkeyupdate: key " << leaf->key(leaf->slotuse - 1));
+                        myres |= result_t(btree_update_lastkey, leaf->key(leaf->slotuse - 1));
                     }
                     else
                     {
@@ -2740,6 +3961,7 @@ private:
 
                     m_root = leaf = NULL;
                     m_headleaf = m_tailleaf = NULL;
+                    m_radix_dirty = true;
 
                     // will be decremented soon by insert_start()
                     BTREE_ASSERT(m_stats.itemcount == 1);
@@ -2806,27 +4028,27 @@ private:
             int slot = find_lower(inner, key);
 
             if (slot == 0) {
-                myleft = (left == NULL) ? NULL : (static_cast<inner_node*>(left))->childid[left->slotuse - 1];
+                myleft = (left == NULL) ? NULL : child(static_cast<inner_node*>(left), left->slotuse - 1);
                 myleftparent = leftparent;
             }
             else {
-                myleft = inner->childid[slot - 1];
+                myleft = child(inner, slot - 1);
                 myleftparent = inner;
             }
 
             if (slot == inner->slotuse) {
-                myright = (right == NULL) ? NULL : (static_cast<inner_node*>(right))->childid[0];
+                myright = (right == NULL) ? NULL : child(static_cast<inner_node*>(right), 0);
                 myrightparent = rightparent;
             }
             else {
-                myright = inner->childid[slot + 1];
+                myright = child(inner, slot + 1);
                 myrightparent = inner;
             }
 
-            BTREE_PRINT("erase_one_descend into " << inner->childid[slot]);
+            BTREE_PRINT("erase_one_descend into " << child(inner, slot));
 
             result_t result = erase_one_descend(key,
-                                                inner->childid[slot],
+                                                child(inner, slot),
                                                 myleft, myright,
                                                 myleftparent, myrightparent,
                                                 inner, slot);
@@ -2844,8 +4066,11 @@ private:
                 {
                     BTREE_PRINT("Fixing lastkeyupdate: key " << result.lastkey << " into parent " << parent << " at parentslot " << parentslot);
 
-                    BTREE_ASSERT(parent->childid[parentslot] == curr);
+                    BTREE_ASSERT(child(parent, parentslot) == curr);
                     parent->slotkey[parentslot] = result.lastkey;
+
+                    // the key range routed to this subtree shrank
+                    if (inner->level >= m_radix_level) m_radix_dirty = true;
                 }
                 else
                 {
@@ -2857,13 +4082,13 @@ private:
             if (result.has(btree_fixmerge))
             {
                 // either the current node or the next is empty and should be removed
-                if (inner->childid[slot]->slotuse != 0)
+                if (child(inner, slot)->slotuse != 0)
                     slot++;
 
                 // this is the child slot invalidated by the merge
-                BTREE_ASSERT(inner->childid[slot]->slotuse == 0);
+                BTREE_ASSERT(child(inner, slot)->slotuse == 0);
 
-                free_node(inner->childid[slot]);
+                free_node(child(inner, slot));
 
                 std::copy(inner->slotkey + slot, inner->slotkey + inner->slotuse,
                           inner->slotkey + slot-1);
@@ -2876,8 +4101,8 @@ private:
                 {
                     // fix split key for children leaves
                     slot--;
-                    leaf_node *child = static_cast<leaf_node*>(inner->childid[slot]);
-                    inner->slotkey[slot] = child->slotkey[ child->slotuse-1 ];
+                    leaf_node *childleaf = static_cast<leaf_node*>(child(inner, slot));
+                    inner->slotkey[slot] = childleaf->key(childleaf->slotuse-1);
                 }
             }
 
@@ -2889,7 +4114,8 @@ private:
                     BTREE_ASSERT(inner == m_root);
                     BTREE_ASSERT(inner->slotuse == 0);
 
-                    m_root = inner->childid[0];
+                    m_root = child(inner, 0);
+                    m_radix_dirty = true;
 
                     inner->slotuse = 0;
                     free_node(inner);
@@ -2989,10 +4215,7 @@ private:
 
             BTREE_PRINT("Found iterator in leaf " << curr << " at slot " << slot);
 
-            std::copy(leaf->slotkey + slot+1, leaf->slotkey + leaf->slotuse,
-                      leaf->slotkey + slot);
-            data_copy(leaf->slotdata + slot+1, leaf->slotdata + leaf->slotuse,
-                      leaf->slotdata + slot);
+            leaf_node::copy_slots(leaf, slot+1, leaf->slotuse, leaf, slot);
 
             leaf->slotuse--;
 
@@ -3004,15 +4227,15 @@ private:
             {
                 if (parent && parentslot < parent->slotuse)
                 {
-                    BTREE_ASSERT(parent->childid[parentslot] == curr);
-                    parent->slotkey[parentslot] = leaf->slotkey[leaf->slotuse - 1];
+                    BTREE_ASSERT(child(parent, parentslot) == curr);
+                    parent->slotkey[parentslot] = leaf->key(leaf->slotuse - 1);
                 }
                 else
                 {
                     if (leaf->slotuse >= 1)
                     {
-                        BTREE_PRINT("Scheduling lastkeyupdate: key " << leaf->slotkey[leaf->slotuse - 1]);
-                        myres |= result_t(btree_update_lastkey, leaf->slotkey[leaf->slotuse - 1]);
+                        BTREE_PRINT("Scheduling lastkeyupdate: key " << leaf->key(leaf->slotuse - 1));
+                        myres |= result_t(btree_update_lastkey, leaf->key(leaf->slotuse - 1));
                     }
                     else
                     {
@@ -3036,6 +4259,7 @@ private:
 
                     m_root = leaf = NULL;
                     m_headleaf = m_tailleaf = NULL;
+                    m_radix_dirty = true;
 
                     // will be decremented soon by insert_start()
                     BTREE_ASSERT(m_stats.itemcount == 1);
@@ -3108,27 +4332,27 @@ private:
                 inner_node *myleftparent, *myrightparent;
 
                 if (slot == 0) {
-                    myleft = (left == NULL) ? NULL : (static_cast<inner_node*>(left))->childid[left->slotuse - 1];
+                    myleft = (left == NULL) ? NULL : child(static_cast<inner_node*>(left), left->slotuse - 1);
                     myleftparent = leftparent;
                 }
                 else {
-                    myleft = inner->childid[slot - 1];
+                    myleft = child(inner, slot - 1);
                     myleftparent = inner;
                 }
 
                 if (slot == inner->slotuse) {
-                    myright = (right == NULL) ? NULL : (static_cast<inner_node*>(right))->childid[0];
+                    myright = (right == NULL) ? NULL : child(static_cast<inner_node*>(right), 0);
                     myrightparent = rightparent;
                 }
                 else {
-                    myright = inner->childid[slot + 1];
+                    myright = child(inner, slot + 1);
                     myrightparent = inner;
                 }
 
-                BTREE_PRINT("erase_iter_descend into " << inner->childid[slot]);
+                BTREE_PRINT("erase_iter_descend into " << child(inner, slot));
 
                 result = erase_iter_descend(iter,
-                                            inner->childid[slot],
+                                            child(inner, slot),
                                             myleft, myright,
                                             myleftparent, myrightparent,
                                             inner, slot);
@@ -3155,8 +4379,11 @@ private:
                 {
                     BTREE_PRINT("Fixing lastkeyupdate: key " << result.lastkey << " into parent " << parent << " at parentslot " << parentslot);
 
-                    BTREE_ASSERT(parent->childid[parentslot] == curr);
+                    BTREE_ASSERT(child(parent, parentslot) == curr);
                     parent->slotkey[parentslot] = result.lastkey;
+
+                    // the key range routed to this subtree shrank
+                    if (inner->level >= m_radix_level) m_radix_dirty = true;
                 }
                 else
                 {
@@ -3168,13 +4395,13 @@ private:
             if (result.has(btree_fixmerge))
             {
                 // either the current node or the next is empty and should be removed
-                if (inner->childid[slot]->slotuse != 0)
+                if (child(inner, slot)->slotuse != 0)
                     slot++;
 
                 // this is the child slot invalidated by the merge
-                BTREE_ASSERT(inner->childid[slot]->slotuse == 0);
+                BTREE_ASSERT(child(inner, slot)->slotuse == 0);
 
-                free_node(inner->childid[slot]);
+                free_node(child(inner, slot));
 
                 std::copy(inner->slotkey + slot, inner->slotkey + inner->slotuse,
                           inner->slotkey + slot-1);
@@ -3187,8 +4414,8 @@ private:
                 {
                     // fix split key for children leaves
                     slot--;
-                    leaf_node *child = static_cast<leaf_node*>(inner->childid[slot]);
-                    inner->slotkey[slot] = child->slotkey[ child->slotuse-1 ];
+                    leaf_node *childleaf = static_cast<leaf_node*>(child(inner, slot));
+                    inner->slotkey[slot] = childleaf->key(childleaf->slotuse-1);
                 }
             }
 
@@ -3201,7 +4428,8 @@ private:
                     BTREE_ASSERT(inner == m_root);
                     BTREE_ASSERT(inner->slotuse == 0);
 
-                    m_root = inner->childid[0];
+                    m_root = child(inner, 0);
+                    m_radix_dirty = true;
 
                     inner->slotuse = 0;
                     free_node(inner);
@@ -3269,10 +4497,7 @@ private:
 
         BTREE_ASSERT(left->slotuse + right->slotuse < leafslotmax);
 
-        std::copy(right->slotkey, right->slotkey + right->slotuse,
-                  left->slotkey + left->slotuse);
-        data_copy(right->slotdata, right->slotdata + right->slotuse,
-                  left->slotdata + left->slotuse);
+        leaf_node::copy_slots(right, 0, right->slotuse, left, left->slotuse);
 
         left->slotuse += right->slotuse;
 
@@ -3290,27 +4515,30 @@ private:
     /// Merge two inner nodes. The function moves all key/childid pairs from
     /// right to left and sets right's slotuse to zero. The right slot is then
     /// removed by the calling parent node.
-    static result_t merge_inner(inner_node* left, inner_node* right, inner_node* parent, unsigned int parentslot)
+    result_t merge_inner(inner_node* left, inner_node* right, inner_node* parent, unsigned int parentslot)
     {
         BTREE_PRINT("Merge inner nodes " << left << " and " << right << " with common parent " << parent << ".");
 
         BTREE_ASSERT(left->level == right->level);
         BTREE_ASSERT(parent->level == left->level + 1);
 
-        BTREE_ASSERT(parent->childid[parentslot] == left);
+        BTREE_ASSERT(child(parent, parentslot) == left);
 
         BTREE_ASSERT(left->slotuse + right->slotuse < innerslotmax);
 
+        // merges below the radix table level keep every table entry valid
+        if (left->level >= m_radix_level) m_radix_dirty = true;
+
         if (selfverify)
         {
             // find the left node's slot in the parent's children
             unsigned int leftslot = 0;
-            while(leftslot <= parent->slotuse && parent->childid[leftslot] != left)
+            while(leftslot <= parent->slotuse && child(parent, leftslot) != left)
                 ++leftslot;
 
             BTREE_ASSERT(leftslot < parent->slotuse);
-            BTREE_ASSERT(parent->childid[leftslot] == left);
-            BTREE_ASSERT(parent->childid[leftslot+1] == right);
+            BTREE_ASSERT(child(parent, leftslot) == left);
+            BTREE_ASSERT(child(parent, leftslot+1) == right);
 
             BTREE_ASSERT(parentslot == leftslot);
         }
@@ -3334,7 +4562,7 @@ private:
     /// Balance two leaf nodes. The function moves key/data pairs from right to
     /// left so that both nodes are equally filled. The parent node is updated
     /// if possible.
-    static result_t shift_left_leaf(leaf_node *left, leaf_node *right, inner_node *parent, unsigned int parentslot)
+    result_t shift_left_leaf(leaf_node *left, leaf_node *right, inner_node *parent, unsigned int parentslot)
     {
         BTREE_ASSERT(left->isleafnode() && right->isleafnode());
         BTREE_ASSERT(parent->level == 1);
@@ -3343,7 +4571,7 @@ private:
         BTREE_ASSERT(left == right->prevleaf);
 
         BTREE_ASSERT(left->slotuse < right->slotuse);
-        BTREE_ASSERT(parent->childid[parentslot] == left);
+        BTREE_ASSERT(child(parent, parentslot) == left);
 
         unsigned int shiftnum = (right->slotuse - left->slotuse) >> 1;
 
@@ -3353,42 +4581,38 @@ private:
 
         // copy the first items from the right node to the last slot in the left node.
 
-        std::copy(right->slotkey, right->slotkey + shiftnum,
-                  left->slotkey + left->slotuse);
-        data_copy(right->slotdata, right->slotdata + shiftnum,
-                  left->slotdata + left->slotuse);
+        leaf_node::copy_slots(right, 0, shiftnum, left, left->slotuse);
 
         left->slotuse += shiftnum;
 
         // shift all slots in the right node to the left
 
-        std::copy(right->slotkey + shiftnum, right->slotkey + right->slotuse,
-                  right->slotkey);
-        data_copy(right->slotdata + shiftnum, right->slotdata + right->slotuse,
-                  right->slotdata);
+        leaf_node::copy_slots(right, shiftnum, right->slotuse, right, 0);
 
         right->slotuse -= shiftnum;
 
         // fixup parent
         if (parentslot < parent->slotuse) {
-            parent->slotkey[parentslot] = left->slotkey[left->slotuse - 1];
+            parent->slotkey[parentslot] = left->key(left->slotuse - 1);
             return btree_ok;
         }
         else { // the update is further up the tree
-            return result_t(btree_update_lastkey, left->slotkey[left->slotuse - 1]);
+            return result_t(btree_update_lastkey, left->key(left->slotuse - 1));
         }
     }
 
     /// Balance two inner nodes. The function moves key/data pairs from right
     /// to left so that both nodes are equally filled. The parent node is
     /// updated if possible.
-    static void shift_left_inner(inner_node *left, inner_node *right, inner_node *parent, unsigned int parentslot)
+    void shift_left_inner(inner_node *left, inner_node *right, inner_node *parent, unsigned int parentslot)
     {
         BTREE_ASSERT(left->level == right->level);
         BTREE_ASSERT(parent->level == left->level + 1);
 
         BTREE_ASSERT(left->slotuse < right->slotuse);
-        BTREE_ASSERT(parent->childid[parentslot] == left);
+        BTREE_ASSERT(child(parent, parentslot) == left);
+
+        if (left->level >= m_radix_level) m_radix_dirty = true;
 
         unsigned int shiftnum = (right->slotuse - left->slotuse) >> 1;
 
@@ -3401,12 +4625,12 @@ private:
             // find the left node's slot in the parent's children and compare to parentslot
 
             unsigned int leftslot = 0;
-            while(leftslot <= parent->slotuse && parent->childid[leftslot] != left)
+            while(leftslot <= parent->slotuse && child(parent, leftslot) != left)
                 ++leftslot;
 
             BTREE_ASSERT(leftslot < parent->slotuse);
-            BTREE_ASSERT(parent->childid[leftslot] == left);
-            BTREE_ASSERT(parent->childid[leftslot+1] == right);
+            BTREE_ASSERT(child(parent, leftslot) == left);
+            BTREE_ASSERT(child(parent, leftslot+1) == right);
 
             BTREE_ASSERT(leftslot == parentslot);
         }
@@ -3440,14 +4664,14 @@ private:
     /// Balance two leaf nodes. The function moves key/data pairs from left to
     /// right so that both nodes are equally filled. The parent node is updated
     /// if possible.
-    static void shift_right_leaf(leaf_node *left, leaf_node *right, inner_node *parent, unsigned int parentslot)
+    void shift_right_leaf(leaf_node *left, leaf_node *right, inner_node *parent, unsigned int parentslot)
     {
         BTREE_ASSERT(left->isleafnode() && right->isleafnode());
         BTREE_ASSERT(parent->level == 1);
 
         BTREE_ASSERT(left->nextleaf == right);
         BTREE_ASSERT(left == right->prevleaf);
-        BTREE_ASSERT(parent->childid[parentslot] == left);
+        BTREE_ASSERT(child(parent, parentslot) == left);
 
         BTREE_ASSERT(left->slotuse > right->slotuse);
 
@@ -3459,12 +4683,12 @@ private:
         {
             // find the left node's slot in the parent's children
             unsigned int leftslot = 0;
-            while(leftslot <= parent->slotuse && parent->childid[leftslot] != left)
+            while(leftslot <= parent->slotuse && child(parent, leftslot) != left)
                 ++leftslot;
 
             BTREE_ASSERT(leftslot < parent->slotuse);
-            BTREE_ASSERT(parent->childid[leftslot] == left);
-            BTREE_ASSERT(parent->childid[leftslot+1] == right);
+            BTREE_ASSERT(child(parent, leftslot) == left);
+            BTREE_ASSERT(child(parent, leftslot+1) == right);
 
             BTREE_ASSERT(leftslot == parentslot);
         }
@@ -3473,34 +4697,31 @@ private:
 
         BTREE_ASSERT(right->slotuse + shiftnum < leafslotmax);
 
-        std::copy_backward(right->slotkey, right->slotkey + right->slotuse,
-                           right->slotkey + right->slotuse + shiftnum);
-        data_copy_backward(right->slotdata, right->slotdata + right->slotuse,
-                           right->slotdata + right->slotuse + shiftnum);
+        leaf_node::copy_slots_backward(right, 0, right->slotuse,
+                                       right, right->slotuse + shiftnum);
 
         right->slotuse += shiftnum;
 
         // copy the last items from the left node to the first slot in the right node.
-        std::copy(left->slotkey + left->slotuse - shiftnum, left->slotkey + left->slotuse,
-                  right->slotkey);
-        data_copy(left->slotdata + left->slotuse - shiftnum, left->slotdata + left->slotuse,
-                  right->slotdata);
+        leaf_node::copy_slots(left, left->slotuse - shiftnum, left->slotuse, right, 0);
 
         left->slotuse -= shiftnum;
 
-        parent->slotkey[parentslot] = left->slotkey[left->slotuse-1];
+        parent->slotkey[parentslot] = left->key(left->slotuse-1);
     }
 
     /// Balance two inner nodes. The function moves key/data pairs from left to
     /// right so that both nodes are equally filled. The parent node is updated
     /// if possible.
-    static void shift_right_inner(inner_node *left, inner_node *right, inner_node *parent, unsigned int parentslot)
+    void shift_right_inner(inner_node *left, inner_node *right, inner_node *parent, unsigned int parentslot)
     {
         BTREE_ASSERT(left->level == right->level);
         BTREE_ASSERT(parent->level == left->level + 1);
 
         BTREE_ASSERT(left->slotuse > right->slotuse);
-        BTREE_ASSERT(parent->childid[parentslot] == left);
+        BTREE_ASSERT(child(parent, parentslot) == left);
+
+        if (left->level >= m_radix_level) m_radix_dirty = true;
 
         unsigned int shiftnum = (left->slotuse - right->slotuse) >> 1;
 
@@ -3510,12 +4731,12 @@ private:
         {
             // find the left node's slot in the parent's children
             unsigned int leftslot = 0;
-            while(leftslot <= parent->slotuse && parent->childid[leftslot] != left)
+            while(leftslot <= parent->slotuse && child(parent, leftslot) != left)
                 ++leftslot;
 
             BTREE_ASSERT(leftslot < parent->slotuse);
-            BTREE_ASSERT(parent->childid[leftslot] == left);
-            BTREE_ASSERT(parent->childid[leftslot+1] == right);
+            BTREE_ASSERT(child(parent, leftslot) == left);
+            BTREE_ASSERT(child(parent, leftslot+1) == right);
 
             BTREE_ASSERT(leftslot == parentslot);
         }
@@ -3578,7 +4799,7 @@ public:
 private:
 
     /// Recursively descend down the tree and print out nodes.
-    static void print_node(std::ostream &os, const node* node, unsigned int depth=0, bool recursive=false)
+    void print_node(std::ostream &os, const node* node, unsigned int depth=0, bool recursive=false) const
     {
         for(unsigned int i = 0; i < depth; i++) os << "  ";
 
@@ -3595,7 +4816,7 @@ private:
 
             for (unsigned int slot = 0; slot < leafnode->slotuse; ++slot)
             {
-                os << leafnode->slotkey[slot] << "  "; // << "(data: " << leafnode->slotdata[slot] << ") ";
+                os << leafnode->key(slot) << "  "; // << "(data: " << leafnode->data(slot) << ") ";
             }
             os << std::endl;
         }
@@ -3607,15 +4828,15 @@ private:
 
             for (unsigned short slot = 0; slot < innernode->slotuse; ++slot)
             {
-                os << "(" << innernode->childid[slot] << ") " << innernode->slotkey[slot] << " ";
+                os << "(" << child(innernode, slot) << ") " << innernode->slotkey[slot] << " ";
             }
-            os << "(" << innernode->childid[innernode->slotuse] << ")" << std::endl;
+            os << "(" << child(innernode, innernode->slotuse) << ")" << std::endl;
 
             if (recursive)
             {
                 for (unsigned short slot = 0; slot < innernode->slotuse + 1; ++slot)
                 {
-                    print_node(os, innernode->childid[slot], depth + 1, recursive);
+                    print_node(os, child(innernode, slot), depth + 1, recursive);
                 }
             }
         }
@@ -3660,11 +4881,11 @@ private:
 
             for(unsigned short slot = 0; slot < leaf->slotuse - 1; ++slot)
             {
-                assert(key_lessequal(leaf->slotkey[slot], leaf->slotkey[slot + 1]));
+                assert(key_lessequal(leaf->key(slot), leaf->key(slot + 1)));
             }
 
-            *minkey = leaf->slotkey[0];
-            *maxkey = leaf->slotkey[leaf->slotuse - 1];
+            *minkey = leaf->key(0);
+            *maxkey = leaf->key(leaf->slotuse - 1);
 
             vstats.leaves++;
             vstats.itemcount += leaf->slotuse;
@@ -3684,7 +4905,7 @@ private:
 
             for(unsigned short slot = 0; slot <= inner->slotuse; ++slot)
             {
-                const node *subnode = inner->childid[slot];
+                const node *subnode = child(inner, slot);
                 key_type subminkey = key_type();
                 key_type submaxkey = key_type();
 
@@ -3707,8 +4928,8 @@ private:
                 {
                     // children are leaves and must be linked together in the
                     // correct order
-                    const leaf_node *leafa = static_cast<const leaf_node*>(inner->childid[slot]);
-                    const leaf_node *leafb = static_cast<const leaf_node*>(inner->childid[slot + 1]);
+                    const leaf_node *leafa = static_cast<const leaf_node*>(child(inner, slot));
+                    const leaf_node *leafb = static_cast<const leaf_node*>(child(inner, slot + 1));
 
                     assert(leafa->nextleaf == leafb);
                     assert(leafa == leafb->prevleaf);
@@ -3717,11 +4938,11 @@ private:
                 if (inner->level == 2 && slot < inner->slotuse)
                 {
                     // verify leaf links between the adjacent inner nodes
-                    const inner_node *parenta = static_cast<const inner_node*>(inner->childid[slot]);
-                    const inner_node *parentb = static_cast<const inner_node*>(inner->childid[slot+1]);
+                    const inner_node *parenta = static_cast<const inner_node*>(child(inner, slot));
+                    const inner_node *parentb = static_cast<const inner_node*>(child(inner, slot+1));
 
-                    const leaf_node *leafa = static_cast<const leaf_node*>(parenta->childid[parenta->slotuse]);
-                    const leaf_node *leafb = static_cast<const leaf_node*>(parentb->childid[0]);
+                    const leaf_node *leafa = static_cast<const leaf_node*>(child(parenta, parenta->slotuse));
+                    const leaf_node *leafb = static_cast<const leaf_node*>(child(parentb, 0));
 
                     assert(leafa->nextleaf == leafb);
                     assert(leafa == leafb->prevleaf);
@@ -3748,14 +4969,14 @@ private:
 
             for(unsigned short slot = 0; slot < n->slotuse - 1; ++slot)
             {
-                assert(key_lessequal(n->slotkey[slot], n->slotkey[slot + 1]));
+                assert(key_lessequal(n->key(slot), n->key(slot + 1)));
             }
 
             testcount += n->slotuse;
 
             if (n->nextleaf)
             {
-                assert(key_lessequal(n->slotkey[n->slotuse-1], n->nextleaf->slotkey[0]));
+                assert(key_lessequal(n->key(n->slotuse-1), n->nextleaf->key(0)));
 
                 assert(n == n->nextleaf->prevleaf);
             }
@@ -3881,6 +5102,7 @@ public:
             if (m_root == NULL) return false;
 
             m_stats.itemcount = fileheader.itemcount;
+            m_radix_dirty = true;
         }
 
 #ifdef BTREE_DEBUG
@@ -3891,6 +5113,124 @@ public:
         return true;
     }
 
+    /// Write the B+ tree as one contiguous, position-independent image (see
+    /// btree_image_header). Unlike dump(), the image contains no pointers and
+    /// can be memory-mapped and searched without rebuilding any node. Leaves
+    /// are converted to the split layout. key_type and data_type must be
+    /// trivially copyable. Returns false if the stream failed.
+    bool write_image(std::ostream &os) const
+    {
+        typedef btree_image_inner<key_type, innerslotmax> image_inner;
+        typedef btree_image_leaf<key_type, data_type, leafslotmax> image_leaf;
+
+        static_assert(std::is_trivially_copyable<key_type>::value &&
+                      std::is_trivially_copyable<data_type>::value,
+                      "tree images need trivially copyable key and data types");
+
+        // collect the nodes of each level, root first
+        std::vector< std::vector<const node*> > levels;
+        if (m_root)
+        {
+            levels.push_back(std::vector<const node*>(1, m_root));
+            while (!levels.back().front()->isleafnode())
+            {
+                std::vector<const node*> below;
+                for (size_t i = 0; i < levels.back().size(); ++i)
+                {
+                    const inner_node *inner = static_cast<const inner_node*>(levels.back()[i]);
+                    for (unsigned short slot = 0; slot <= inner->slotuse; ++slot)
+                        below.push_back(child(inner, slot));
+                }
+                levels.push_back(below);
+            }
+        }
+
+        const size_t align = btree_image_header::align;
+        const size_t headerbytes = (sizeof(btree_image_header) + align - 1) / align * align;
+
+        std::vector<uint64_t> offset(levels.size() + 1, headerbytes);
+        for (size_t d = 0; d < levels.size(); ++d)
+        {
+            size_t bytes = levels[d].size() * (d + 1 == levels.size() ? sizeof(image_leaf) : sizeof(image_inner));
+            offset[d + 1] = (offset[d] + bytes + align - 1) / align * align;
+        }
+
+        btree_image_header header;
+        std::fill(reinterpret_cast<char*>(&header), reinterpret_cast<char*>(&header + 1), 0);
+        header.sign();
+        header.key_type_size = sizeof(key_type);
+        header.data_type_size = sizeof(data_type);
+        header.leafslots = leafslotmax;
+        header.innerslots = innerslotmax;
+        header.inner_bytes = sizeof(image_inner);
+        header.leaf_bytes = sizeof(image_leaf);
+        header.height = static_cast<uint32_t>(levels.size());
+        header.allow_duplicates = allow_duplicates;
+        header.itemcount = size();
+        header.leaves = m_stats.leaves;
+        header.innernodes = m_stats.innernodes;
+        header.root = levels.empty() ? 0 : offset[0];
+        header.first_leaf = levels.empty() ? 0 : offset[levels.size() - 1];
+        header.image_bytes = offset[levels.size()];
+
+        const char zeros[btree_image_header::align] = { 0 };
+        uint64_t pos = 0;
+
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        pos += sizeof(header);
+
+        for (size_t d = 0; d < levels.size(); ++d)
+        {
+            os.write(zeros, offset[d] - pos);
+            pos = offset[d];
+
+            if (d + 1 == levels.size())
+            {
+                image_leaf out;
+                for (size_t i = 0; i < levels[d].size(); ++i)
+                {
+                    const leaf_node *leaf = static_cast<const leaf_node*>(levels[d][i]);
+
+                    std::fill(reinterpret_cast<char*>(&out), reinterpret_cast<char*>(&out + 1), 0);
+                    out.slotuse = leaf->slotuse;
+                    for (unsigned short slot = 0; slot < leaf->slotuse; ++slot)
+                    {
+                        out.slotkey[slot] = leaf->key(slot);
+                        out.slotdata[slot] = leaf->data(slot);
+                    }
+                    os.write(reinterpret_cast<const char*>(&out), sizeof(out));
+                }
+                pos += levels[d].size() * sizeof(image_leaf);
+            }
+            else
+            {
+                // children of consecutive nodes are consecutive in the level below
+                const size_t childbytes = (d + 2 == levels.size()) ? sizeof(image_leaf) : sizeof(image_inner);
+                uint64_t nextchild = offset[d + 1];
+
+                image_inner out;
+                for (size_t i = 0; i < levels[d].size(); ++i)
+                {
+                    const inner_node *inner = static_cast<const inner_node*>(levels[d][i]);
+
+                    std::fill(reinterpret_cast<char*>(&out), reinterpret_cast<char*>(&out + 1), 0);
+                    out.level = inner->level;
+                    out.slotuse = inner->slotuse;
+                    out.first_child = nextchild;
+                    std::copy(inner->slotkey, inner->slotkey + inner->slotuse, out.slotkey);
+                    os.write(reinterpret_cast<const char*>(&out), sizeof(out));
+
+                    nextchild += (inner->slotuse + 1) * childbytes;
+                }
+                pos += levels[d].size() * sizeof(image_inner);
+            }
+        }
+
+        os.write(zeros, header.image_bytes - pos);
+
+        return os.good();
+    }
+
 private:
 
     /// Recursively descend down the tree and dump each node in a precise order
@@ -3912,7 +5252,7 @@ private:
 
             for(unsigned short slot = 0; slot <= inner->slotuse; ++slot)
             {
-                const node *subnode = inner->childid[slot];
+                const node *subnode = child(inner, slot);
 
                 dump_node(os, subnode);
             }
@@ -3970,7 +5310,7 @@ private:
 
             for(unsigned short slot = 0; slot <= newinner->slotuse; ++slot)
             {
-                newinner->childid[slot] = restore_node(is);
+                set_child(newinner, slot, restore_node(is));
             }
 
             return newinner;
@@ -117,6 +117,18 @@ public:
     /// this can differ from slots in each leaf.
     static const unsigned short         innerslotmax =  btree_impl::innerslotmax;
 
+    /// Size in bytes of one inner node of the underlying B+ tree.
+    static const size_t                 inner_node_bytes = btree_impl::inner_node_bytes;
+
+    /// Size in bytes of one leaf node of the underlying B+ tree.
+    static const size_t                 leaf_node_bytes = btree_impl::leaf_node_bytes;
+
+    /// Layout of the key/data slots in leaves, see btree_leaf_layout.
+    static const int                    leaf_layout = btree_impl::leaf_layout;
+
+    /// True if inner nodes reference children by 32-bit pool index.
+    static const bool                   pooled_children = btree_impl::pooled_children;
+
     /// Computed B+ tree parameter: The minimum number of key/data slots used
     /// in a leaf. If fewer slots are used, the leaf will be merged or slots
     /// shifted from it's siblings.
@@ -329,6 +341,14 @@ public:
 	return tree.get_stats();
     }
 
+    /// Call visitor(depth, slotuse, slotmax, bytes, isleaf) for every node.
+    /// See btree::visit_nodes().
+    template <typename Visitor>
+    void visit_nodes(Visitor &visitor) const
+    {
+        tree.visit_nodes(visitor);
+    }
+
 public:
     // *** Standard Access Functions Querying the Tree by Descending to a Leaf
 
@@ -353,6 +373,30 @@ public:
 	return tree.find(key);
     }
 
+    /// Prefetch the leaf a key would be found in, using Policy (by default
+    /// the prefetch_policy of the traits). See btree::prefetch_leaf().
+    template <typename Policy = typename btree_impl::prefetch_policy>
+    void prefetch_leaf(const key_type &key) const
+    {
+        tree.template prefetch_leaf<Policy>(key);
+    }
+
+    /// Same as find(), but reports each node on the root-to-leaf path to
+    /// visitor. See btree::find_visit().
+    template <typename Visitor>
+    const_iterator find_visit(const key_type &key, Visitor &visitor) const
+    {
+        return tree.find_visit(key, visitor);
+    }
+
+    /// Same as find(), but reports every memory read of the lookup to
+    /// tracer. See btree::find_trace().
+    template <typename Tracer>
+    const_iterator find_trace(const key_type &key, Tracer &tracer) const
+    {
+        return tree.find_trace(key, tracer);
+    }
+
     /// Tries to locate a key in the B+ tree and returns the number of
     /// identical key entries found. Since this is a unique map, count()
     /// returns either 0 or 1.
@@ -532,6 +576,50 @@ public:
         return tree.bulk_load(first, last);
     }
 
+    /// Insert the range [first,last) of value_type pairs as one batch. The
+    /// batch is sorted and merged into its target leaves in a single pass,
+    /// splitting each leaf at most once. Returns the number of inserted
+    /// pairs.
+    template <typename InputIterator>
+    inline size_type insert_batch(InputIterator first, InputIterator last)
+    {
+        return tree.insert_batch(first, last);
+    }
+
+public:
+    // *** Radix Table Descent
+
+    /// Start lookups at a radix table entry indexed by the top bits of the
+    /// key, skipping up to depth levels below the root.
+    void enable_radix_table(unsigned int bits, unsigned int depth)
+    {
+        tree.enable_radix_table(bits, depth);
+    }
+
+    /// Rebuild the radix table if updates since the last build made it stale.
+    void refresh_radix_table()
+    {
+        tree.refresh_radix_table();
+    }
+
+    /// Remove the radix table.
+    void disable_radix_table()
+    {
+        tree.disable_radix_table();
+    }
+
+    /// Size of the radix table in bytes.
+    size_t radix_table_bytes() const
+    {
+        return tree.radix_table_bytes();
+    }
+
+    /// Average number of levels skipped by the radix table.
+    double radix_avg_skipped_levels() const
+    {
+        return tree.radix_avg_skipped_levels();
+    }
+
 public:
     // *** Public Erase Functions
 
@@ -612,6 +700,13 @@ public:
     {
         return tree.restore(is);
     }
+
+    /// Write the B+ tree as a position-independent image that can be
+    /// memory-mapped and searched in place. See btree::write_image().
+    bool write_image(std::ostream &os) const
+    {
+        return tree.write_image(os);
+    }
 };
 
 } // namespace stx
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <algorithm>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/**
+ * 叶子 key 前缀 / 差值压缩的静态 B+ 树，固定 64 位整数 key
+ *
+ * - 叶子存 base（叶子第一个 key）和每个 key 相对 base 的差值，
+ *   差值宽度按叶子内最大差值逐叶选择：8 / 16 / 32 位，放不下时退回 64 位
+ * - 每个叶子的差值区固定为 LeafKeys * 宽度 字节，空位填全 1，
+ *   叶内查找直接在压缩形式上用 AVX2 整块比较（不解压）
+ * - 内部节点为 Fanout 个子树最大 key 的隐式数组，没有孩子指针
+ * - value 按全局位置单独存放
+ *
+ * 只读结构，查找接口与 btree_map 一致：find() 返回指向 value 的指针，未命中返回 end()（nullptr）。
+ */
+
+namespace structures {
+namespace compressed {
+
+template<typename Value = uint64_t, size_t LeafKeys = 64, size_t Fanout = 16>
+class CompressedBTree {
+    static_assert(LeafKeys % 32 == 0 && LeafKeys <= 1024, "LeafKeys must be a multiple of 32");
+    static_assert(Fanout % 4 == 0, "Fanout must be a multiple of 4");
+
+public:
+    using key_type = uint64_t;
+    using data_type = Value;
+    using pair_type = std::pair<uint64_t, Value>;
+    using size_type = size_t;
+    using const_iterator = const data_type*;
+
+    static constexpr size_t leaf_keys = LeafKeys;
+    static constexpr size_t fanout = Fanout;
+
+    /// 只能通过 bulk_load() 构建
+    static constexpr bool bulk_load_only = true;
+
+private:
+    /// 差值区按 32 字节（一个 AVX2 寄存器）为单位寻址
+    static constexpr size_t block_bytes = 32;
+
+    struct leaf {
+        uint64_t base;
+        uint32_t block;     // 差值区起始（block_bytes 为单位）
+        uint16_t count;
+        uint8_t width;      // 差值字节数：1 / 2 / 4 / 8
+        uint8_t pad;
+    };
+
+    struct alignas(64) inner_node {
+        key_type keys[Fanout];
+    };
+
+    static constexpr key_type pad_key = std::numeric_limits<key_type>::max();
+
+public:
+    CompressedBTree() = default;
+
+    /**
+     * 从有序、无重复的 (key, value) 序列构建
+     */
+    template<typename Iterator>
+    void bulk_load(Iterator ibegin, Iterator iend) {
+        m_size = iend - ibegin;
+        m_leaves.clear();
+        m_deltas.clear();
+        m_data.clear();
+        m_levels.clear();
+
+        if (m_size == 0) return;
+
+        size_t num_leaves = (m_size + LeafKeys - 1) / LeafKeys;
+        m_leaves.resize(num_leaves);
+        m_data.resize(m_size);
+
+        std::vector<key_type> leaf_keys(LeafKeys);
+        std::vector<key_type> max_keys(num_leaves);
+
+        Iterator it = ibegin;
+        size_t pos = 0;
+        for (size_t l = 0; l < num_leaves; ++l) {
+            size_t count = std::min(LeafKeys, m_size - pos);
+            for (size_t i = 0; i < count; ++i, ++it, ++pos) {
+                leaf_keys[i] = it->first;
+                m_data[pos] = it->second;
+            }
+            encode_leaf(m_leaves[l], leaf_keys.data(), count);
+            max_keys[l] = leaf_keys[count - 1];
+        }
+
+        build_inner(max_keys);
+    }
+
+    // ==================== 查找 ====================
+
+    const_iterator find(const key_type& key) const {
+        if (m_size == 0) return end();
+
+        // 自顶向下：第一个最大 key >= key 的子树
+        size_t idx = 0;
+        for (size_t lvl = m_levels.size(); lvl-- > 0; ) {
+            idx = idx * Fanout + rank(m_levels[lvl][idx], key);
+            size_t below = lvl > 0 ? m_levels[lvl - 1].size() : m_leaves.size();
+            if (idx >= below) return end();
+        }
+
+        const leaf& lf = m_leaves[idx];
+        if (key < lf.base) return end();
+
+        // 路由保证 key <= 叶子最大 key，差值一定放得下 lf.width
+        uint64_t d = key - lf.base;
+        const uint8_t* deltas = m_deltas.data() + size_t(lf.block) * block_bytes;
+        size_t slot = leaf_rank(deltas, lf.width, d);
+
+        if (slot < lf.count && delta_at(deltas, lf.width, slot) == d) {
+            return &m_data[idx * LeafKeys + slot];
+        }
+        return end();
+    }
+
+    const_iterator end() const { return nullptr; }
+
+    bool exists(const key_type& key) const {
+        return find(key) != end();
+    }
+
+    // ==================== 统计 ====================
+
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /// 树高（内部层数 + 叶子层）
+    size_t height() const {
+        return m_size ? m_levels.size() + 1 : 0;
+    }
+
+    size_t leaf_count() const { return m_leaves.size(); }
+
+    /// 差值宽度为 width 字节的叶子数
+    size_t leaves_with_width(unsigned width) const {
+        size_t n = 0;
+        for (const auto& lf : m_leaves) n += (lf.width == width);
+        return n;
+    }
+
+    /// key 相关的全部字节：叶子头 + 差值区 + 内部节点
+    size_t key_bytes() const {
+        size_t bytes = m_leaves.size() * sizeof(leaf) + m_deltas.size();
+        for (const auto& level : m_levels) bytes += level.size() * sizeof(inner_node);
+        return bytes;
+    }
+
+    /// 原始 key 数组字节数 / 压缩后 key 字节数
+    double compression_ratio() const {
+        return key_bytes() ? static_cast<double>(m_size * sizeof(key_type)) / key_bytes() : 0.0;
+    }
+
+    size_t memory_bytes() const {
+        return key_bytes() + m_data.size() * sizeof(data_type);
+    }
+
+private:
+    /**
+     * 选择能放下最大差值的最小宽度，写入差值区，空位填全 1
+     */
+    void encode_leaf(leaf& lf, const key_type* keys, size_t count) {
+        uint64_t max_delta = keys[count - 1] - keys[0];
+        uint8_t width = max_delta <= 0xFF ? 1
+                      : max_delta <= 0xFFFF ? 2
+                      : max_delta <= 0xFFFFFFFFull ? 4 : 8;
+
+        lf.base = keys[0];
+        lf.count = static_cast<uint16_t>(count);
+        lf.width = width;
+        lf.pad = 0;
+        lf.block = static_cast<uint32_t>(m_deltas.size() / block_bytes);
+
+        size_t offset = m_deltas.size();
+        m_deltas.resize(offset + LeafKeys * width, 0xFF);
+        uint8_t* out = m_deltas.data() + offset;
+
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t d = keys[i] - keys[0];
+            switch (width) {
+                case 1: out[i] = static_cast<uint8_t>(d); break;
+                case 2: { uint16_t v = static_cast<uint16_t>(d); std::memcpy(out + 2 * i, &v, 2); break; }
+                case 4: { uint32_t v = static_cast<uint32_t>(d); std::memcpy(out + 4 * i, &v, 4); break; }
+                default: std::memcpy(out + 8 * i, &d, 8); break;
+            }
+        }
+    }
+
+    /**
+     * 内部层自底向上：每 Fanout 个子树一组，记录各子树最大 key，不足补 pad_key
+     */
+    void build_inner(std::vector<key_type> max_keys) {
+        while (max_keys.size() > 1) {
+            size_t nodes = (max_keys.size() + Fanout - 1) / Fanout;
+            std::vector<inner_node> level(nodes);
+            std::vector<key_type> upper(nodes);
+
+            for (size_t n = 0; n < nodes; ++n) {
+                for (size_t i = 0; i < Fanout; ++i) {
+                    size_t c = n * Fanout + i;
+                    level[n].keys[i] = c < max_keys.size() ? max_keys[c] : pad_key;
+                }
+                upper[n] = max_keys[std::min(max_keys.size(), (n + 1) * Fanout) - 1];
+            }
+
+            m_levels.push_back(std::move(level));
+            max_keys.swap(upper);
+        }
+    }
+
+    static uint64_t delta_at(const uint8_t* deltas, unsigned width, size_t slot) {
+        switch (width) {
+            case 1: return deltas[slot];
+            case 2: { uint16_t v; std::memcpy(&v, deltas + 2 * slot, 2); return v; }
+            case 4: { uint32_t v; std::memcpy(&v, deltas + 4 * slot, 4); return v; }
+            default: { uint64_t v; std::memcpy(&v, deltas + 8 * slot, 8); return v; }
+        }
+    }
+
+    /**
+     * 内部节点中小于 key 的 key 个数
+     */
+    static size_t rank(const inner_node& n, key_type key) {
+#ifdef __AVX2__
+        // AVX2 只有有符号比较，翻转最高位
+        const __m256i flip = _mm256_set1_epi64x(static_cast<long long>(1ULL << 63));
+        const __m256i x = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(key)), flip);
+        const __m256i* p = reinterpret_cast<const __m256i*>(n.keys);
+
+        size_t cnt = 0;
+        for (size_t v = 0; v < Fanout / 4; ++v) {
+            __m256i lt = _mm256_cmpgt_epi64(x, _mm256_xor_si256(_mm256_load_si256(p + v), flip));
+            cnt += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(lt)));
+        }
+        return cnt;
+#else
+        size_t cnt = 0;
+        for (size_t i = 0; i < Fanout; ++i) {
+            cnt += (n.keys[i] < key);
+        }
+        return cnt;
+#endif
+    }
+
+    /**
+     * 叶子差值区中小于 d 的差值个数（空位全 1，不会小于 d）
+     */
+    static size_t leaf_rank(const uint8_t* deltas, unsigned width, uint64_t d) {
+#ifdef __AVX2__
+        const __m256i* p = reinterpret_cast<const __m256i*>(deltas);
+        const size_t vectors = LeafKeys * width / block_bytes;
+        size_t cnt = 0;
+
+        switch (width) {
+            case 1: {
+                const __m256i flip = _mm256_set1_epi8(static_cast<char>(0x80));
+                const __m256i x = _mm256_xor_si256(_mm256_set1_epi8(static_cast<char>(d)), flip);
+                for (size_t v = 0; v < vectors; ++v) {
+                    __m256i lt = _mm256_cmpgt_epi8(x, _mm256_xor_si256(_mm256_loadu_si256(p + v), flip));
+                    cnt += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(lt)));
+                }
+                return cnt;
+            }
+            case 2: {
+                const __m256i flip = _mm256_set1_epi16(static_cast<short>(0x8000));
+                const __m256i x = _mm256_xor_si256(_mm256_set1_epi16(static_cast<short>(d)), flip);
+                for (size_t v = 0; v < vectors; ++v) {
+                    __m256i lt = _mm256_cmpgt_epi16(x, _mm256_xor_si256(_mm256_loadu_si256(p + v), flip));
+                    // 每个 16 位比较结果占 movemask 的两位
+                    cnt += __builtin_popcount(static_cast<unsigned>(_mm256_movemask_epi8(lt))) / 2;
+                }
+                return cnt;
+            }
+            case 4: {
+                const __m256i flip = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+                const __m256i x = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(d)), flip);
+                for (size_t v = 0; v < vectors; ++v) {
+                    __m256i lt = _mm256_cmpgt_epi32(x, _mm256_xor_si256(_mm256_loadu_si256(p + v), flip));
+                    cnt += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(lt)));
+                }
+                return cnt;
+            }
+            default: {
+                const __m256i flip = _mm256_set1_epi64x(static_cast<long long>(1ULL << 63));
+                const __m256i x = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(d)), flip);
+                for (size_t v = 0; v < vectors; ++v) {
+                    __m256i lt = _mm256_cmpgt_epi64(x, _mm256_xor_si256(_mm256_loadu_si256(p + v), flip));
+                    cnt += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(lt)));
+                }
+                return cnt;
+            }
+        }
+#else
+        size_t cnt = 0;
+        for (size_t i = 0; i < LeafKeys; ++i) {
+            cnt += (delta_at(deltas, width, i) < d);
+        }
+        return cnt;
+#endif
+    }
+
+    std::vector<leaf> m_leaves;
+    std::vector<uint8_t> m_deltas;
+    std::vector<data_type> m_data;
+
+    /// 内部层，下标 0 为最底层（孩子是叶子），最后一层为根
+    std::vector<std::vector<inner_node>> m_levels;
+
+    size_t m_size = 0;
+};
+
+using CompressedBTree64 = CompressedBTree<uint64_t>;
+
+} // namespace compressed
+} // namespace structures
@@ -0,0 +1,338 @@
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * CSB+ 树（Cache-Sensitive B+ Tree）
+ *
+ * 面向静态 / 读多写少场景的 B+ 树变体：
+ *   - 同一节点的所有孩子连续存放在一个 node group 中，
+ *     内部节点只保存一个指向第一个孩子的指针（STX 需要 innerslotmax+1 个）
+ *   - 每一层的节点都放在一个连续数组里，叶子之间的前后关系是隐式的
+ *   - 只支持 bulk_load 构建，更新需要重新构建
+ *
+ * 查找接口与 STX btree_map 保持一致（find / end / exists / lower_bound /
+ * get_stats），可以直接替换 CustomBTree 接入同一套测试流程。
+ */
+
+namespace structures {
+namespace csbtree {
+
+template<typename Key, typename Value,
+         int LeafSlots, int InnerSlots,
+         typename Compare = std::less<Key>>
+class CSBTree {
+public:
+    using key_type = Key;
+    using data_type = Value;
+    using pair_type = std::pair<Key, Value>;
+    using size_type = size_t;
+
+    static constexpr unsigned short leafslotmax = LeafSlots;
+    static constexpr unsigned short innerslotmax = InnerSlots;
+
+    /// 只能通过 bulk_load() 构建
+    static constexpr bool bulk_load_only = true;
+
+private:
+    struct leaf_node;
+
+    /**
+     * 内部节点：key 数组 + 单个孩子指针
+     * 孩子 i 位于 firstchild + i
+     */
+    struct alignas(64) inner_node {
+        unsigned short level;
+        unsigned short slotuse;
+        key_type slotkey[innerslotmax];
+        union {
+            const inner_node* inner;
+            const leaf_node* leaf;
+        } firstchild;
+    };
+
+    /**
+     * 叶子节点：没有前后指针，相邻叶子在数组中连续
+     */
+    struct alignas(64) leaf_node {
+        unsigned short slotuse;
+        key_type slotkey[leafslotmax];
+        data_type slotdata[leafslotmax];
+    };
+
+public:
+    /**
+     * 只读迭代器，指向某个叶子的某个 slot
+     */
+    class const_iterator {
+    public:
+        const_iterator() : currnode(nullptr), lastnode(nullptr), currslot(0) {}
+
+        const key_type& key() const { return currnode->slotkey[currslot]; }
+        const data_type& data() const { return currnode->slotdata[currslot]; }
+
+        const_iterator& operator++() {
+            if (currslot + 1u < currnode->slotuse || currnode == lastnode) {
+                ++currslot;
+            } else {
+                ++currnode;
+                currslot = 0;
+            }
+            return *this;
+        }
+
+        bool operator==(const const_iterator& x) const {
+            return currnode == x.currnode && currslot == x.currslot;
+        }
+        bool operator!=(const const_iterator& x) const {
+            return !(*this == x);
+        }
+
+    private:
+        friend class CSBTree;
+
+        const_iterator(const leaf_node* node, const leaf_node* last, unsigned short slot)
+            : currnode(node), lastnode(last), currslot(slot) {}
+
+        const leaf_node* currnode;
+        const leaf_node* lastnode;
+        unsigned short currslot;
+    };
+
+    using iterator = const_iterator;
+
+    /**
+     * 与 STX tree_stats 字段一致，TreeStatistics::collect() 可以直接使用
+     */
+    struct tree_stats {
+        size_type itemcount = 0;
+        size_type leaves = 0;
+        size_type innernodes = 0;
+
+        static constexpr unsigned short leafslots = leafslotmax;
+        static constexpr unsigned short innerslots = innerslotmax;
+
+        size_type nodes() const { return innernodes + leaves; }
+
+        double avgfill_leaves() const {
+            return static_cast<double>(itemcount) / (leaves * leafslots);
+        }
+    };
+
+    static constexpr size_t inner_node_bytes = sizeof(inner_node);
+    static constexpr size_t leaf_node_bytes = sizeof(leaf_node);
+
+public:
+    CSBTree() = default;
+
+    // 内部节点保存的是指向其他层数组的指针，不能拷贝
+    CSBTree(const CSBTree&) = delete;
+    CSBTree& operator=(const CSBTree&) = delete;
+    CSBTree(CSBTree&&) = default;
+    CSBTree& operator=(CSBTree&&) = default;
+
+    /**
+     * 从有序、无重复的 (key, value) 序列构建
+     * 叶子均匀填满，逐层向上构建内部节点，每层一个连续数组
+     */
+    template<typename Iterator>
+    void bulk_load(Iterator ibegin, Iterator iend) {
+        clear();
+
+        size_t num_items = iend - ibegin;
+        if (num_items == 0) return;
+
+        // 叶子层
+        size_t num_leaves = (num_items + leafslotmax - 1) / leafslotmax;
+        m_leaves.resize(num_leaves);
+
+        Iterator it = ibegin;
+        for (size_t i = 0; i < num_leaves; ++i) {
+            leaf_node& leaf = m_leaves[i];
+            leaf.slotuse = static_cast<unsigned short>(num_items / (num_leaves - i));
+            for (unsigned short s = 0; s < leaf.slotuse; ++s, ++it) {
+                leaf.slotkey[s] = it->first;
+                leaf.slotdata[s] = it->second;
+            }
+            num_items -= leaf.slotuse;
+        }
+
+        m_stats.itemcount = iend - ibegin;
+        m_stats.leaves = num_leaves;
+
+        if (num_leaves == 1) return;
+
+        // 内部节点，自底向上；每个孩子的最大 key 作为分隔 key
+        std::vector<key_type> childmax(num_leaves);
+        for (size_t i = 0; i < num_leaves; ++i) {
+            childmax[i] = m_leaves[i].slotkey[m_leaves[i].slotuse - 1];
+        }
+
+        std::vector<std::vector<inner_node>> levels;
+        size_t num_children = num_leaves;
+
+        for (unsigned short level = 1; num_children > 1; ++level) {
+            size_t num_parents = (num_children + innerslotmax) / (innerslotmax + 1);
+            std::vector<inner_node> parents(num_parents);
+
+            size_t child = 0;
+            size_t remaining = num_children;
+            for (size_t i = 0; i < num_parents; ++i) {
+                inner_node& n = parents[i];
+                size_t count = remaining / (num_parents - i);
+
+                n.level = level;
+                n.slotuse = static_cast<unsigned short>(count - 1);
+                if (level == 1) {
+                    n.firstchild.leaf = &m_leaves[child];
+                } else {
+                    n.firstchild.inner = &levels.back()[child];
+                }
+
+                for (unsigned short s = 0; s < n.slotuse; ++s) {
+                    n.slotkey[s] = childmax[child + s];
+                }
+
+                childmax[i] = childmax[child + count - 1];
+                child += count;
+                remaining -= count;
+            }
+
+            m_stats.innernodes += num_parents;
+            levels.push_back(std::move(parents));
+            num_children = num_parents;
+        }
+
+        // levels 自底向上构建，存储时改为根在前
+        m_inner.assign(std::make_move_iterator(levels.rbegin()),
+                       std::make_move_iterator(levels.rend()));
+    }
+
+    void clear() {
+        m_inner.clear();
+        m_leaves.clear();
+        m_stats = tree_stats();
+    }
+
+    // ==================== 查找 ====================
+
+    const_iterator find(const key_type& key) const {
+        const leaf_node* leaf = find_leaf(key);
+        if (!leaf) return end();
+
+        unsigned short slot = find_lower(leaf->slotkey, leaf->slotuse, key);
+        return (slot < leaf->slotuse && key_equal(key, leaf->slotkey[slot]))
+            ? const_iterator(leaf, last_leaf(), slot) : end();
+    }
+
+    bool exists(const key_type& key) const {
+        return find(key) != end();
+    }
+
+    const_iterator lower_bound(const key_type& key) const {
+        const leaf_node* leaf = find_leaf(key);
+        if (!leaf) return end();
+
+        unsigned short slot = find_lower(leaf->slotkey, leaf->slotuse, key);
+        const_iterator it(leaf, last_leaf(), slot);
+        if (slot == leaf->slotuse && leaf != last_leaf()) ++it;
+        return it;
+    }
+
+    const_iterator begin() const {
+        if (m_leaves.empty()) return end();
+        return const_iterator(m_leaves.data(), last_leaf(), 0);
+    }
+
+    const_iterator end() const {
+        if (m_leaves.empty()) return const_iterator();
+        return const_iterator(last_leaf(), last_leaf(), last_leaf()->slotuse);
+    }
+
+    // ==================== 统计 ====================
+
+    size_type size() const { return m_stats.itemcount; }
+    bool empty() const { return m_stats.itemcount == 0; }
+
+    const tree_stats& get_stats() const { return m_stats; }
+
+    /// 树高（叶子层算 1 层）
+    size_t height() const {
+        return m_leaves.empty() ? 0 : m_inner.size() + 1;
+    }
+
+    /**
+     * 对每个节点调用 visitor(depth, slotuse, slotmax, bytes, isleaf)，根的 depth 为 0
+     * 与 STX visit_nodes() 接口一致，按层顺序访问
+     */
+    template<typename Visitor>
+    void visit_nodes(Visitor& visitor) const {
+        for (size_t depth = 0; depth < m_inner.size(); ++depth) {
+            for (const inner_node& n : m_inner[depth]) {
+                visitor(static_cast<unsigned>(depth), n.slotuse, innerslotmax, inner_node_bytes, false);
+            }
+        }
+        for (const leaf_node& leaf : m_leaves) {
+            visitor(static_cast<unsigned>(m_inner.size()), leaf.slotuse, leafslotmax, leaf_node_bytes, true);
+        }
+    }
+
+private:
+    const leaf_node* last_leaf() const {
+        return &m_leaves.back();
+    }
+
+    /**
+     * 从根沿 node group 下降到叶子
+     */
+    const leaf_node* find_leaf(const key_type& key) const {
+        if (m_leaves.empty()) return nullptr;
+        if (m_inner.empty()) return m_leaves.data();
+
+        const inner_node* n = m_inner.front().data();
+        while (n->level > 1) {
+            n = n->firstchild.inner + find_lower(n->slotkey, n->slotuse, key);
+        }
+        return n->firstchild.leaf + find_lower(n->slotkey, n->slotuse, key);
+    }
+
+    /**
+     * 节点内线性查找第一个 >= key 的 slot（与 STX find_lower 一致）
+     */
+    unsigned short find_lower(const key_type* slotkey, unsigned short slotuse,
+                              const key_type& key) const {
+        unsigned short lo = 0;
+        while (lo < slotuse && m_key_less(slotkey[lo], key)) ++lo;
+        return lo;
+    }
+
+    bool key_equal(const key_type& a, const key_type& b) const {
+        return !m_key_less(a, b) && !m_key_less(b, a);
+    }
+
+    /// 内部节点，按层存放（m_inner[0] 只有根节点）
+    std::vector<std::vector<inner_node>> m_inner;
+
+    /// 全部叶子，按 key 顺序连续存放
+    std::vector<leaf_node> m_leaves;
+
+    tree_stats m_stats;
+    Compare m_key_less;
+};
+
+/**
+ * 自定义配置的 CSB+ 树，模板参数与 CustomBTree 对应
+ */
+template<typename Key = uint64_t, typename Value = uint64_t,
+         int LeafSlots = 64, int InnerSlots = 64>
+struct CustomCSBTree {
+    using type = CSBTree<Key, Value, LeafSlots, InnerSlots>;
+};
+
+using CSBTree64 = typename CustomCSBTree<uint64_t, uint64_t, 16, 16>::type;
+
+} // namespace csbtree
+} // namespace structures
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "../../utils/PrefetchUtils.hpp"
+
+/**
+ * PGM 风格的分段线性索引（Piecewise Geometric Model）
+ *
+ * - 最底层：用 shrinking cone 贪心算法一次遍历 key，切成误差 <= Epsilon 的线段
+ * - 上层：对下一层线段的起始 key 递归同样的分段，直到只剩一个线段
+ * - 查找：自顶向下，每层预测位置后只在 ±误差窗口内搜索下一层的线段，
+ *   最后在 ±误差窗口内搜索 key 数组（last-mile）
+ * - Prefetch = true 时，在 last-mile 搜索前预取预测位置的 key 和 value
+ *
+ * 只读结构，find() 返回指向 value 的指针，未命中返回 end()（nullptr）。
+ */
+
+namespace structures {
+namespace learned {
+
+template<typename Key = uint64_t, typename Value = uint64_t,
+         size_t Epsilon = 64, size_t EpsilonRecursive = 4, bool Prefetch = false>
+class PGMIndex {
+public:
+    using key_type = Key;
+    using data_type = Value;
+    using pair_type = std::pair<Key, Value>;
+    using size_type = size_t;
+    using const_iterator = const data_type*;
+
+    /// 只能通过 bulk_load() 构建
+    static constexpr bool bulk_load_only = true;
+
+private:
+    /// 线段：pos = first + slope * (key - key0)，覆盖下一层 [first, 下一线段 first)
+    struct segment {
+        key_type key;
+        double slope;
+        size_t first;
+    };
+
+    struct level {
+        std::vector<segment> segments;
+
+        /// 构建后实测的最大误差
+        size_t error;
+    };
+
+public:
+    /**
+     * 从有序、无重复的 (key, value) 序列构建
+     */
+    template<typename Iterator>
+    void bulk_load(Iterator ibegin, Iterator iend) {
+        size_t n = iend - ibegin;
+        m_keys.resize(n);
+        m_data.resize(n);
+        m_levels.clear();
+
+        size_t i = 0;
+        for (Iterator it = ibegin; it != iend; ++it, ++i) {
+            m_keys[i] = it->first;
+            m_data[i] = it->second;
+        }
+
+        if (n == 0) return;
+
+        // 自底向上：先对 key 分段，再对每层线段的起始 key 分段
+        std::vector<level> bottom_up;
+        bottom_up.push_back(build_level(m_keys, Epsilon));
+
+        while (bottom_up.back().segments.size() > 1) {
+            std::vector<key_type> seg_keys;
+            seg_keys.reserve(bottom_up.back().segments.size());
+            for (const auto& s : bottom_up.back().segments) seg_keys.push_back(s.key);
+
+            bottom_up.push_back(build_level(seg_keys, EpsilonRecursive));
+        }
+
+        m_levels.assign(std::make_move_iterator(bottom_up.rbegin()),
+                        std::make_move_iterator(bottom_up.rend()));
+    }
+
+    // ==================== 查找 ====================
+
+    const_iterator find(const key_type& key) const {
+        if (m_keys.empty()) return end();
+
+        size_t seg = 0;
+        for (size_t l = 0; l + 1 < m_levels.size(); ++l) {
+            const level& lv = m_levels[l];
+            const std::vector<segment>& below = m_levels[l + 1].segments;
+
+            size_t pred = predict(lv, seg, key, below.size());
+            size_t lo = pred > lv.error + 1 ? pred - lv.error - 1 : 0;
+            size_t hi = std::min(below.size(), pred + lv.error + 2);
+
+            // 窗口内最后一个起始 key <= key 的线段
+            auto it = std::upper_bound(below.begin() + lo, below.begin() + hi, key,
+                                       [](const key_type& k, const segment& s) { return k < s.key; });
+            seg = (it == below.begin()) ? 0 : (it - below.begin()) - 1;
+        }
+
+        const level& bottom = m_levels.back();
+        size_t pred = predict(bottom, seg, key, m_keys.size());
+
+        if (Prefetch) {
+            do_prefetch(&m_keys[pred]);
+            do_prefetch(&m_data[pred]);
+        }
+
+        size_t lo = pred > bottom.error + 1 ? pred - bottom.error - 1 : 0;
+        size_t hi = std::min(m_keys.size(), pred + bottom.error + 2);
+
+        auto it = std::lower_bound(m_keys.begin() + lo, m_keys.begin() + hi, key);
+        if (it == m_keys.begin() + hi || *it != key) return end();
+        return &m_data[it - m_keys.begin()];
+    }
+
+    const_iterator end() const { return nullptr; }
+
+    bool exists(const key_type& key) const {
+        return find(key) != end();
+    }
+
+    // ==================== 统计 ====================
+
+    size_type size() const { return m_keys.size(); }
+    bool empty() const { return m_keys.empty(); }
+
+    /// 线段层数
+    size_t height() const { return m_levels.size(); }
+
+    size_t num_segments() const {
+        return m_levels.empty() ? 0 : m_levels.back().segments.size();
+    }
+
+    /// 所有线段占用的字节数（不含 key / value 数组）
+    size_t model_bytes() const {
+        size_t bytes = 0;
+        for (const auto& lv : m_levels) bytes += lv.segments.size() * sizeof(segment);
+        return bytes;
+    }
+
+    size_t memory_bytes() const {
+        return model_bytes() + m_keys.size() * sizeof(key_type) + m_data.size() * sizeof(data_type);
+    }
+
+private:
+    /**
+     * 用线段 seg 预测 key 在下一层的位置，截断到该线段覆盖的范围
+     */
+    size_t predict(const level& lv, size_t seg, const key_type& key, size_t below_size) const {
+        const segment& s = lv.segments[seg];
+        size_t last = (seg + 1 < lv.segments.size()) ? lv.segments[seg + 1].first - 1 : below_size - 1;
+
+        if (key <= s.key) return s.first;
+
+        double p = static_cast<double>(s.first) + s.slope * static_cast<double>(key - s.key);
+        if (p >= static_cast<double>(last)) return last;
+        return std::max(s.first, static_cast<size_t>(p));
+    }
+
+    /**
+     * Shrinking cone：以线段起点为顶点维护可行斜率区间 [slope_lo, slope_hi]，
+     * 新点使区间为空时结束当前线段
+     */
+    level build_level(const std::vector<key_type>& keys, size_t eps) const {
+        level lv;
+        lv.error = 0;
+
+        size_t n = keys.size();
+        size_t start = 0;
+
+        while (start < n) {
+            double slope_lo = 0.0;
+            double slope_hi = std::numeric_limits<double>::infinity();
+
+            size_t end = start + 1;
+            for (; end < n; ++end) {
+                double dx = static_cast<double>(keys[end] - keys[start]);
+                double dy = static_cast<double>(end - start);
+
+                double lo = (dy - eps) / dx;
+                double hi = (dy + eps) / dx;
+                if (lo > slope_hi || hi < slope_lo) break;
+
+                slope_lo = std::max(slope_lo, lo);
+                slope_hi = std::min(slope_hi, hi);
+            }
+
+            double slope = (end - start > 1) ? (slope_lo + slope_hi) / 2 : 0.0;
+            lv.segments.push_back(segment{keys[start], slope, start});
+            start = end;
+        }
+
+        // 记录真实误差（浮点舍入和截断都算在内）
+        for (size_t seg = 0; seg < lv.segments.size(); ++seg) {
+            size_t last = (seg + 1 < lv.segments.size()) ? lv.segments[seg + 1].first : n;
+            for (size_t i = lv.segments[seg].first; i < last; ++i) {
+                size_t pred = predict(lv, seg, keys[i], n);
+                lv.error = std::max(lv.error, pred > i ? pred - i : i - pred);
+            }
+        }
+
+        return lv;
+    }
+
+    std::vector<key_type> m_keys;
+    std::vector<data_type> m_data;
+
+    /// m_levels[0] 是根层（只有一个线段），m_levels.back() 直接索引 key 数组
+    std::vector<level> m_levels;
+};
+
+using PGM64 = PGMIndex<uint64_t, uint64_t, 64, 4, false>;
+using PGM64Prefetch = PGMIndex<uint64_t, uint64_t, 64, 4, true>;
+
+} // namespace learned
+} // namespace structures
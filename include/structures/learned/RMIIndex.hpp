@@ -0,0 +1,241 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "../../utils/PrefetchUtils.hpp"
+
+/**
+ * 两级 RMI（Recursive Model Index）
+ *
+ * - 第一级：一个线性模型，把 key 映射到第二级模型编号
+ * - 第二级：num_models 个线性模型，各自拟合落到该模型的 key 的位置，
+ *   并记录构建时的最大左右误差
+ * - 查找：预测位置后只在 [pred - err_lo, pred + err_hi] 内二分（last-mile）
+ * - Prefetch = true 时，在 last-mile 搜索前预取预测位置的 key 和 value
+ *
+ * 只读结构，find() 返回指向 value 的指针，未命中返回 end()（nullptr）。
+ */
+
+namespace structures {
+namespace learned {
+
+template<typename Key = uint64_t, typename Value = uint64_t, bool Prefetch = false>
+class RMIIndex {
+public:
+    using key_type = Key;
+    using data_type = Value;
+    using pair_type = std::pair<Key, Value>;
+    using size_type = size_t;
+    using const_iterator = const data_type*;
+
+    /// 只能通过 bulk_load() 构建
+    static constexpr bool bulk_load_only = true;
+
+private:
+    /// 第二级线性模型：pos = intercept + slope * (key - base)
+    struct leaf_model {
+        key_type base;
+        double slope;
+        double intercept;
+        uint32_t err_lo;
+        uint32_t err_hi;
+    };
+
+public:
+    /**
+     * @param num_models 第二级模型数量，0 表示按 key 数自动选择（约 256 key / 模型）
+     */
+    explicit RMIIndex(size_t num_models = 0) : m_requested_models(num_models) {}
+
+    /**
+     * 从有序、无重复的 (key, value) 序列构建
+     */
+    template<typename Iterator>
+    void bulk_load(Iterator ibegin, Iterator iend) {
+        size_t n = iend - ibegin;
+        m_keys.resize(n);
+        m_data.resize(n);
+
+        size_t i = 0;
+        for (Iterator it = ibegin; it != iend; ++it, ++i) {
+            m_keys[i] = it->first;
+            m_data[i] = it->second;
+        }
+
+        size_t num_models = m_requested_models;
+        if (num_models == 0) num_models = std::max<size_t>(1, n / 256);
+        m_models.assign(num_models, leaf_model{key_type(), 0.0, 0.0, 0, 0});
+
+        if (n == 0) return;
+
+        // 第一级：最小二乘拟合 key -> 模型编号
+        fit_root(num_models);
+
+        // 第二级：每个模型拟合落到它的连续一段 key
+        size_t begin = 0;
+        while (begin < n) {
+            size_t j = route(m_keys[begin]);
+            size_t end = begin + 1;
+            while (end < n && route(m_keys[end]) == j) ++end;
+
+            fit_leaf(m_models[j], begin, end);
+            begin = end;
+        }
+    }
+
+    // ==================== 查找 ====================
+
+    const_iterator find(const key_type& key) const {
+        if (m_keys.empty()) return end();
+
+        const leaf_model& m = m_models[route(key)];
+        size_t pred = predict(m, key);
+
+        if (Prefetch) {
+            do_prefetch(&m_keys[pred]);
+            do_prefetch(&m_data[pred]);
+        }
+
+        size_t lo = pred > m.err_lo ? pred - m.err_lo : 0;
+        size_t hi = std::min(m_keys.size(), pred + m.err_hi + 1);
+
+        auto it = std::lower_bound(m_keys.begin() + lo, m_keys.begin() + hi, key);
+        if (it == m_keys.begin() + hi || *it != key) return end();
+        return &m_data[it - m_keys.begin()];
+    }
+
+    const_iterator end() const { return nullptr; }
+
+    bool exists(const key_type& key) const {
+        return find(key) != end();
+    }
+
+    // ==================== 统计 ====================
+
+    size_type size() const { return m_keys.size(); }
+    bool empty() const { return m_keys.empty(); }
+
+    /// 模型层数
+    size_t height() const { return 2; }
+
+    size_t num_models() const { return m_models.size(); }
+
+    /// 两级模型占用的字节数（不含 key / value 数组）
+    size_t model_bytes() const {
+        return sizeof(m_root_slope) + sizeof(m_root_intercept) +
+               m_models.size() * sizeof(leaf_model);
+    }
+
+    size_t memory_bytes() const {
+        return model_bytes() + m_keys.size() * sizeof(key_type) + m_data.size() * sizeof(data_type);
+    }
+
+    /// 第二级模型的平均搜索窗口（err_lo + err_hi + 1）
+    double avg_search_window() const {
+        if (m_models.empty()) return 0.0;
+        double sum = 0.0;
+        for (const auto& m : m_models) sum += m.err_lo + m.err_hi + 1.0;
+        return sum / m_models.size();
+    }
+
+private:
+    size_t route(const key_type& key) const {
+        double p = m_root_intercept + m_root_slope * static_cast<double>(key);
+        if (p <= 0.0) return 0;
+        size_t j = static_cast<size_t>(p);
+        return std::min(j, m_models.size() - 1);
+    }
+
+    size_t predict(const leaf_model& m, const key_type& key) const {
+        double dx = key >= m.base ? static_cast<double>(key - m.base)
+                                  : -static_cast<double>(m.base - key);
+        double p = m.intercept + m.slope * dx;
+        if (p <= 0.0) return 0;
+        size_t pos = static_cast<size_t>(p);
+        return std::min(pos, m_keys.size() - 1);
+    }
+
+    void fit_root(size_t num_models) {
+        size_t n = m_keys.size();
+        if (n == 1 || m_keys.front() == m_keys.back()) {
+            m_root_slope = 0.0;
+            m_root_intercept = 0.0;
+            return;
+        }
+
+        // y = i * num_models / n
+        long double mean_x = 0, mean_y = 0;
+        for (size_t i = 0; i < n; ++i) {
+            mean_x += static_cast<long double>(m_keys[i]);
+            mean_y += static_cast<long double>(i) * num_models / n;
+        }
+        mean_x /= n;
+        mean_y /= n;
+
+        long double cov = 0, var = 0;
+        for (size_t i = 0; i < n; ++i) {
+            long double dx = static_cast<long double>(m_keys[i]) - mean_x;
+            long double dy = static_cast<long double>(i) * num_models / n - mean_y;
+            cov += dx * dy;
+            var += dx * dx;
+        }
+
+        m_root_slope = static_cast<double>(var > 0 ? cov / var : 0);
+        m_root_intercept = static_cast<double>(mean_y - cov / var * mean_x);
+    }
+
+    void fit_leaf(leaf_model& m, size_t begin, size_t end) {
+        size_t cnt = end - begin;
+        m.base = m_keys[begin];
+
+        if (cnt == 1) {
+            m.slope = 0.0;
+            m.intercept = static_cast<double>(begin);
+        } else {
+            long double mean_x = 0, mean_y = 0;
+            for (size_t i = begin; i < end; ++i) {
+                mean_x += static_cast<long double>(m_keys[i] - m.base);
+                mean_y += i;
+            }
+            mean_x /= cnt;
+            mean_y /= cnt;
+
+            long double cov = 0, var = 0;
+            for (size_t i = begin; i < end; ++i) {
+                long double dx = static_cast<long double>(m_keys[i] - m.base) - mean_x;
+                long double dy = static_cast<long double>(i) - mean_y;
+                cov += dx * dy;
+                var += dx * dx;
+            }
+
+            m.slope = static_cast<double>(var > 0 ? cov / var : 0);
+            m.intercept = static_cast<double>(mean_y - (var > 0 ? cov / var : 0) * mean_x);
+        }
+
+        // 记录真实误差，保证构建时的每个 key 都在搜索窗口内
+        m.err_lo = 0;
+        m.err_hi = 0;
+        for (size_t i = begin; i < end; ++i) {
+            size_t pred = predict(m, m_keys[i]);
+            if (pred > i) m.err_lo = std::max<uint32_t>(m.err_lo, static_cast<uint32_t>(pred - i));
+            else m.err_hi = std::max<uint32_t>(m.err_hi, static_cast<uint32_t>(i - pred));
+        }
+    }
+
+    std::vector<key_type> m_keys;
+    std::vector<data_type> m_data;
+    std::vector<leaf_model> m_models;
+
+    double m_root_slope = 0.0;
+    double m_root_intercept = 0.0;
+    size_t m_requested_models = 0;
+};
+
+using RMI64 = RMIIndex<uint64_t, uint64_t, false>;
+using RMI64Prefetch = RMIIndex<uint64_t, uint64_t, true>;
+
+} // namespace learned
+} // namespace structures
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/**
+ * 静态 S-tree（FAST 风格的隐式索引搜索树）
+ *
+ * - 每个节点恰好 64 字节（一条 cache line），存 B = 64 / sizeof(Key) 个 key
+ * - 没有孩子指针：节点 k 的第 i 个孩子是 k * (B + 1) + i + 1
+ * - 由有序 key 数组按中序一次遍历构建
+ * - 节点内用 AVX2 一次比较整个节点（uint64: 2 x 4 路，uint32: 2 x 8 路）
+ *
+ * 只读结构，查找接口与 btree_map 一致：find() 返回指向 value 的指针，
+ * 未命中返回 end()（nullptr）。
+ */
+
+namespace structures {
+namespace stree {
+
+template<typename Key = uint64_t, typename Value = uint64_t>
+class STree {
+    static_assert(std::is_unsigned<Key>::value && (sizeof(Key) == 8 || sizeof(Key) == 4),
+                  "STree supports uint32_t / uint64_t keys");
+
+public:
+    using key_type = Key;
+    using data_type = Value;
+    using pair_type = std::pair<Key, Value>;
+    using size_type = size_t;
+    using const_iterator = const data_type*;
+
+    /// 每个节点的 key 数
+    static constexpr size_t node_keys = 64 / sizeof(Key);
+
+    /// 只能通过 bulk_load() 构建
+    static constexpr bool bulk_load_only = true;
+
+private:
+    struct alignas(64) node {
+        key_type keys[node_keys];
+    };
+
+    /// 填充空位的 key，不会小于任何查询
+    static constexpr key_type pad_key = std::numeric_limits<key_type>::max();
+
+public:
+    STree() = default;
+
+    /**
+     * 从有序、无重复的 (key, value) 序列构建
+     */
+    template<typename Iterator>
+    void bulk_load(Iterator ibegin, Iterator iend) {
+        m_size = iend - ibegin;
+        m_blocks = (m_size + node_keys - 1) / node_keys;
+
+        m_nodes.assign(m_blocks, node());
+        m_data.assign(m_blocks * node_keys, data_type());
+        m_has_pad_key = false;
+
+        Iterator it = ibegin;
+        size_t t = 0;
+        build(0, it, t);
+    }
+
+    // ==================== 查找 ====================
+
+    /**
+     * 返回第一个 >= key 的位置（节点号 * B + slot），不存在返回 npos
+     */
+    size_t lower_bound_pos(const key_type& key) const {
+        size_t res = npos;
+        size_t k = 0;
+
+        while (k < m_blocks) {
+            size_t i = rank(m_nodes[k], key);
+            if (i < node_keys) res = k * node_keys + i;
+            k = child(k, i);
+        }
+
+        return res;
+    }
+
+    const_iterator find(const key_type& key) const {
+        size_t pos = lower_bound_pos(key);
+        if (pos == npos) return end();
+
+        const key_type found = m_nodes[pos / node_keys].keys[pos % node_keys];
+        if (found != key) return end();
+        if (key == pad_key && !m_has_pad_key) return end();
+
+        return &m_data[pos];
+    }
+
+    const_iterator end() const { return nullptr; }
+
+    bool exists(const key_type& key) const {
+        return find(key) != end();
+    }
+
+    // ==================== 统计 ====================
+
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    /// 树高（节点层数）
+    size_t height() const {
+        size_t h = 0;
+        for (size_t k = 0; k < m_blocks; k = child(k, 0)) h++;
+        return h;
+    }
+
+    size_t memory_bytes() const {
+        return m_nodes.size() * sizeof(node) + m_data.size() * sizeof(data_type);
+    }
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    static size_t child(size_t k, size_t i) {
+        return k * (node_keys + 1) + i + 1;
+    }
+
+    /**
+     * 中序遍历：左子树、key、右子树，一次消费有序序列
+     */
+    template<typename Iterator>
+    void build(size_t k, Iterator& it, size_t& t) {
+        if (k >= m_blocks) return;
+
+        for (size_t i = 0; i < node_keys; ++i) {
+            build(child(k, i), it, t);
+
+            if (t < m_size) {
+                m_nodes[k].keys[i] = it->first;
+                m_data[k * node_keys + i] = it->second;
+                if (it->first == pad_key) m_has_pad_key = true;
+                ++it;
+                ++t;
+            } else {
+                m_nodes[k].keys[i] = pad_key;
+            }
+        }
+
+        build(child(k, node_keys), it, t);
+    }
+
+    /**
+     * 节点内小于 key 的 key 个数，即第一个 >= key 的 slot
+     */
+    static size_t rank(const node& n, key_type key) {
+#ifdef __AVX2__
+        if constexpr (sizeof(key_type) == 8) {
+            // AVX2 只有有符号比较，翻转最高位
+            const __m256i flip = _mm256_set1_epi64x(static_cast<long long>(1ULL << 63));
+            const __m256i x = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(key)), flip);
+            const __m256i* p = reinterpret_cast<const __m256i*>(n.keys);
+
+            __m256i lt0 = _mm256_cmpgt_epi64(x, _mm256_xor_si256(_mm256_load_si256(p), flip));
+            __m256i lt1 = _mm256_cmpgt_epi64(x, _mm256_xor_si256(_mm256_load_si256(p + 1), flip));
+
+            unsigned mask = _mm256_movemask_pd(_mm256_castsi256_pd(lt0))
+                          | (_mm256_movemask_pd(_mm256_castsi256_pd(lt1)) << 4);
+            return __builtin_popcount(mask);
+        } else {
+            const __m256i flip = _mm256_set1_epi32(static_cast<int>(1U << 31));
+            const __m256i x = _mm256_xor_si256(_mm256_set1_epi32(static_cast<int>(key)), flip);
+            const __m256i* p = reinterpret_cast<const __m256i*>(n.keys);
+
+            __m256i lt0 = _mm256_cmpgt_epi32(x, _mm256_xor_si256(_mm256_load_si256(p), flip));
+            __m256i lt1 = _mm256_cmpgt_epi32(x, _mm256_xor_si256(_mm256_load_si256(p + 1), flip));
+
+            unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(lt0))
+                          | (_mm256_movemask_ps(_mm256_castsi256_ps(lt1)) << 8);
+            return __builtin_popcount(mask);
+        }
+#else
+        size_t cnt = 0;
+        for (size_t i = 0; i < node_keys; ++i) {
+            cnt += (n.keys[i] < key);
+        }
+        return cnt;
+#endif
+    }
+
+    std::vector<node> m_nodes;
+    std::vector<data_type> m_data;
+
+    size_t m_size = 0;
+    size_t m_blocks = 0;
+    bool m_has_pad_key = false;
+};
+
+using STree64 = STree<uint64_t, uint64_t>;
+using STree32 = STree<uint32_t, uint32_t>;
+
+} // namespace stree
+} // namespace structures
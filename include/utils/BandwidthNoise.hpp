@@ -0,0 +1,133 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "HugePageAllocator.hpp"
+#include "Parallel.hpp"
+
+namespace utils {
+
+/**
+ * 访存带宽干扰：后台线程持续读一块大缓冲区，模拟和查询共享内存带宽的扫描负载
+ *   Stream: 每个线程顺序扫描自己的一段（硬件预取友好，占带宽最多）
+ *   Random: 每个线程随机读整块缓冲区中的 cache line（占用缺失处理资源）
+ *
+ * start(target_gbs) 按目标带宽限速：每读完 64KB 检查一次进度，超前时让出 CPU 等待；
+ * target_gbs 为 0 时不限速。stop() 返回这段时间实际达到的带宽。
+ */
+class BandwidthNoise {
+public:
+    enum class Pattern { Stream, Random };
+
+    BandwidthNoise(unsigned threads, size_t buffer_bytes, Pattern pattern)
+        : m_threads(std::max(1u, threads)),
+          m_pattern(pattern),
+          m_buffer(std::max(buffer_bytes, chunk_bytes * m_threads) / sizeof(uint64_t), 1),
+          m_bytes(m_threads) {}
+
+    ~BandwidthNoise() { stop(); }
+
+    BandwidthNoise(const BandwidthNoise&) = delete;
+    BandwidthNoise& operator=(const BandwidthNoise&) = delete;
+
+    static bool parse(const std::string& s, Pattern& out) {
+        if (s == "stream") { out = Pattern::Stream; return true; }
+        if (s == "random") { out = Pattern::Random; return true; }
+        return false;
+    }
+
+    static const char* name(Pattern p) {
+        return p == Pattern::Stream ? "stream" : "random";
+    }
+
+    unsigned threads() const { return m_threads; }
+    size_t buffer_bytes() const { return m_buffer.size() * sizeof(uint64_t); }
+
+    void start(double target_gbs = 0.0) {
+        stop();
+        m_running = true;
+        m_start = Clock::now();
+        // GB/s == bytes/ns
+        double per_thread = target_gbs / m_threads;
+        for (unsigned t = 0; t < m_threads; ++t) {
+            m_bytes[t].bytes = 0;
+            m_workers.emplace_back([this, t, per_thread] { run(t, per_thread); });
+        }
+    }
+
+    /// 停止干扰线程，返回从 start() 到现在的实际带宽（GB/s）
+    double stop() {
+        if (m_workers.empty()) return 0.0;
+        m_running = false;
+        for (auto& w : m_workers) w.join();
+        m_workers.clear();
+
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - m_start).count();
+        double bytes = 0;
+        for (const auto& b : m_bytes) bytes += b.bytes;
+        return ns > 0 ? bytes / ns : 0.0;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr size_t chunk_bytes = size_t(64) << 10;
+    static constexpr size_t line_words = 64 / sizeof(uint64_t);
+
+    /// 每个线程的计数独占一条 cache line，sink 保存读到的数据和，防止读被优化掉
+    struct alignas(64) Counter {
+        uint64_t bytes = 0;
+        uint64_t sink = 0;
+    };
+
+    void run(unsigned t, double bytes_per_ns) {
+        const size_t words = m_buffer.size();
+        const uint64_t* data = m_buffer.data();
+        const size_t chunk_words = chunk_bytes / sizeof(uint64_t);
+
+        size_t lo = chunk_begin(words, m_threads, t), hi = chunk_begin(words, m_threads, t + 1);
+        size_t pos = lo;
+        uint64_t rng = 0x9E3779B97F4A7C15ull * (t + 1);
+        uint64_t acc = 0;
+        uint64_t done = 0;
+
+        while (m_running.load(std::memory_order_relaxed)) {
+            if (m_pattern == Pattern::Stream) {
+                if (pos + chunk_words > hi) pos = lo;
+                for (size_t i = 0; i < chunk_words; ++i) acc += data[pos + i];
+                pos += chunk_words;
+            } else {
+                for (size_t i = 0; i < chunk_bytes / 64; ++i) {
+                    rng ^= rng << 13; rng ^= rng >> 7; rng ^= rng << 17;
+                    acc += data[(rng % (words / line_words)) * line_words];
+                }
+            }
+            done += chunk_bytes;
+            m_bytes[t].bytes = done;
+
+            // 限速：超前于目标带宽时让出 CPU
+            if (bytes_per_ns > 0) {
+                while (m_running.load(std::memory_order_relaxed)) {
+                    double ns = std::chrono::duration<double, std::nano>(Clock::now() - m_start).count();
+                    if (done <= ns * bytes_per_ns) break;
+                    std::this_thread::yield();
+                }
+            }
+        }
+        m_bytes[t].sink = acc;
+    }
+
+    unsigned m_threads;
+    Pattern m_pattern;
+    huge_vector<uint64_t> m_buffer;
+    std::vector<Counter> m_bytes;
+    std::vector<std::thread> m_workers;
+    std::atomic<bool> m_running{false};
+    Clock::time_point m_start;
+};
+
+} // namespace utils
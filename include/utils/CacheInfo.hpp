@@ -0,0 +1,157 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <utility>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace utils {
+
+/**
+ * 本机的缓存容量和 TLB 覆盖范围
+ * 缓存容量读 /sys/devices/system/cpu/cpu0/cache，取不到时退回 sysconf；
+ * TLB 项数用 cpuid 查询（Intel leaf 0x18 / AMD leaf 0x80000006），虚拟机中常常为 0。
+ * 取不到的项为 0，levels() 中不列出；相联度（ways）取不到时也为 0。
+ */
+struct CacheInfo {
+    size_t l1d = 0;
+    size_t l2 = 0;
+    size_t llc = 0;
+    size_t tlb_entries = 0;     // 4K 页最后一级数据 TLB 的项数
+    unsigned l1d_ways = 0;
+    unsigned l2_ways = 0;
+    unsigned llc_ways = 0;
+    unsigned tlb_ways = 0;
+
+    /// 4K 页下 TLB 能覆盖的字节数
+    size_t tlb_reach() const { return tlb_entries * 4096; }
+
+    static CacheInfo detect() {
+        CacheInfo info;
+        const std::string base = "/sys/devices/system/cpu/cpu0/cache/index";
+        for (int i = 0; ; ++i) {
+            std::string level, type, size, ways;
+            if (!read_line(base + std::to_string(i) + "/level", level)) break;
+            read_line(base + std::to_string(i) + "/type", type);
+            read_line(base + std::to_string(i) + "/size", size);
+            read_line(base + std::to_string(i) + "/ways_of_associativity", ways);
+            if (type == "Instruction") continue;
+
+            size_t bytes = parse_size(size);
+            unsigned w = static_cast<unsigned>(std::atoi(ways.c_str()));
+            int n = std::atoi(level.c_str());
+            if (n == 1) { info.l1d = bytes; info.l1d_ways = w; }
+            else if (n == 2) { info.l2 = bytes; info.l2_ways = w; }
+            else if (n >= 3 && bytes >= info.llc) { info.llc = bytes; info.llc_ways = w; }
+        }
+
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+        if (info.l1d == 0) info.l1d = sysconf_size(_SC_LEVEL1_DCACHE_SIZE);
+        if (info.l2 == 0) info.l2 = sysconf_size(_SC_LEVEL2_CACHE_SIZE);
+        if (info.llc == 0) info.llc = sysconf_size(_SC_LEVEL3_CACHE_SIZE);
+#endif
+        info.tlb_entries = detect_tlb_entries(info.tlb_ways);
+        return info;
+    }
+
+    /// 已知的层级，按容量从小到大
+    std::vector<std::pair<std::string, size_t>> levels() const {
+        std::vector<std::pair<std::string, size_t>> result;
+        if (l1d) result.emplace_back("L1d", l1d);
+        if (l2) result.emplace_back("L2", l2);
+        if (llc) result.emplace_back("LLC", llc);
+        if (tlb_entries) result.emplace_back("TLB", tlb_reach());
+        std::sort(result.begin(), result.end(),
+                  [](const auto& a, const auto& b) { return a.second < b.second; });
+        return result;
+    }
+
+    /// 能放下 bytes 的最小缓存层级名（不考虑 TLB），都放不下时为 "DRAM"
+    std::string fits(size_t bytes) const {
+        if (l1d && bytes <= l1d) return "L1d";
+        if (l2 && bytes <= l2) return "L2";
+        if (llc && bytes <= llc) return "LLC";
+        return "DRAM";
+    }
+
+    /// 48 KB / 2.0 MB / 1.50 GB
+    static std::string format_bytes(size_t bytes) {
+        std::ostringstream os;
+        os << std::fixed;
+        if (bytes < (size_t(1) << 20)) {
+            os << std::setprecision(0) << bytes / 1024.0 << " KB";
+        } else if (bytes < (size_t(1) << 30)) {
+            os << std::setprecision(1) << bytes / 1048576.0 << " MB";
+        } else {
+            os << std::setprecision(2) << bytes / 1073741824.0 << " GB";
+        }
+        return os.str();
+    }
+
+private:
+    static bool read_line(const std::string& path, std::string& line) {
+        std::ifstream file(path);
+        return static_cast<bool>(std::getline(file, line));
+    }
+
+    /// sysfs 的 "48K" / "2048K" / "32M"
+    static size_t parse_size(const std::string& s) {
+        if (s.empty()) return 0;
+        size_t value = std::strtoull(s.c_str(), nullptr, 10);
+        switch (s.back()) {
+            case 'K': return value << 10;
+            case 'M': return value << 20;
+            case 'G': return value << 30;
+            default:  return value;
+        }
+    }
+
+    static size_t sysconf_size(int name) {
+        long v = sysconf(name);
+        return v > 0 ? static_cast<size_t>(v) : 0;
+    }
+
+    static size_t detect_tlb_entries(unsigned& ways) {
+#if defined(__x86_64__) || defined(__i386__)
+        unsigned a, b, c, d;
+        size_t entries = 0;
+
+        // Intel：遍历 leaf 0x18 的各个子叶，取支持 4K 页的数据 / 统一 TLB 中层级最高的一个
+        if (__get_cpuid(0, &a, &b, &c, &d) && a >= 0x18) {
+            __cpuid_count(0x18, 0, a, b, c, d);
+            unsigned max_subleaf = a;
+            unsigned best_level = 0;
+            for (unsigned i = 0; i <= max_subleaf; ++i) {
+                __cpuid_count(0x18, i, a, b, c, d);
+                unsigned type = d & 0x1F, level = (d >> 5) & 0x7;
+                if ((type != 1 && type != 3) || !(b & 1)) continue;
+                if (level >= best_level) {
+                    best_level = level;
+                    entries = size_t(b >> 16) * c;
+                    ways = b >> 16;
+                }
+            }
+        }
+
+        // AMD：EBX[27:16] 为 L2 数据 TLB 的 4K 页项数
+        if (entries == 0 && __get_cpuid(0x80000000, &a, &b, &c, &d) && a >= 0x80000006) {
+            __get_cpuid(0x80000006, &a, &b, &c, &d);
+            entries = (b >> 16) & 0xFFF;
+        }
+        return entries;
+#else
+        (void)ways;
+        return 0;
+#endif
+    }
+};
+
+} // namespace utils
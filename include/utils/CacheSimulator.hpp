@@ -0,0 +1,287 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <array>
+#include <limits>
+#include <ostream>
+#include <algorithm>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "CacheInfo.hpp"
+
+namespace utils {
+
+/**
+ * 查找访存轨迹：作为 btree find_trace() 的 tracer，记录每次查找读到的地址范围
+ * 同一层上首尾相接的读（例如线性搜索依次比较的 key）合并为一条记录
+ */
+class NodeTrace {
+public:
+    struct Access {
+        uint64_t addr;
+        uint32_t bytes;
+        uint16_t depth;     // 节点所在层，根为 0
+    };
+
+    void touch(unsigned depth, const void* p, size_t bytes) {
+        uint64_t addr = reinterpret_cast<uintptr_t>(p);
+        if (m_accesses.size() > m_query_begin.back()) {
+            Access& last = m_accesses.back();
+            if (last.depth == depth && last.addr + last.bytes == addr) {
+                last.bytes += static_cast<uint32_t>(bytes);
+                return;
+            }
+        }
+        m_accesses.push_back({addr, static_cast<uint32_t>(bytes), static_cast<uint16_t>(depth)});
+    }
+
+    void done(unsigned /* depth */) {
+        m_query_begin.push_back(m_accesses.size());
+    }
+
+    size_t queries() const { return m_query_begin.size() - 1; }
+    const std::vector<Access>& accesses() const { return m_accesses; }
+
+    /// 第 q 次查找的记录为 accesses()[query_begin(q), query_begin(q + 1))
+    size_t query_begin(size_t q) const { return m_query_begin[q]; }
+
+    /// 每行一次读："<query> <depth> 0x<address> <bytes>"
+    void write(std::ostream& os) const {
+        for (size_t q = 0; q < queries(); ++q) {
+            for (size_t i = m_query_begin[q]; i < m_query_begin[q + 1]; ++i) {
+                const Access& a = m_accesses[i];
+                os << q << ' ' << a.depth << " 0x" << std::hex << a.addr << std::dec
+                   << ' ' << a.bytes << '\n';
+            }
+        }
+    }
+
+private:
+    std::vector<Access> m_accesses;
+    std::vector<size_t> m_query_begin{0};
+};
+
+/**
+ * 组相联 LRU 缓存的一级（或 TLB）：按 block 编号（地址 >> log2(block_bytes)）查找，
+ * 组号取 block % sets，缺失时替换组内最久未用的一路
+ */
+class SetAssociativeCache {
+public:
+    SetAssociativeCache(size_t bytes, unsigned ways, size_t block_bytes)
+        : m_ways(std::max(1u, ways)),
+          m_shift(log2(block_bytes)),
+          m_sets(std::max<size_t>(1, bytes / block_bytes / m_ways)),
+          m_tags(m_sets * m_ways, invalid),
+          m_stamps(m_sets * m_ways, 0) {}
+
+    /// 命中返回 true；缺失时装入
+    bool access(uint64_t addr) {
+        uint64_t block = addr >> m_shift;
+        size_t base = (block % m_sets) * m_ways;
+        ++m_clock;
+
+        size_t victim = base;
+        for (size_t w = base; w < base + m_ways; ++w) {
+            if (m_tags[w] == block) {
+                m_stamps[w] = m_clock;
+                return true;
+            }
+            if (m_stamps[w] < m_stamps[victim]) victim = w;
+        }
+        m_tags[victim] = block;
+        m_stamps[victim] = m_clock;
+        return false;
+    }
+
+    size_t capacity() const { return (m_sets * m_ways) << m_shift; }
+    unsigned ways() const { return m_ways; }
+
+private:
+    static constexpr uint64_t invalid = std::numeric_limits<uint64_t>::max();
+
+    static unsigned log2(size_t n) {
+        unsigned s = 0;
+        while ((size_t(2) << s) <= n) ++s;
+        return s;
+    }
+
+    unsigned m_ways;
+    unsigned m_shift;
+    size_t m_sets;
+    std::vector<uint64_t> m_tags;
+    std::vector<uint64_t> m_stamps;
+    uint64_t m_clock = 0;
+};
+
+/**
+ * 用 NodeTrace 回放 L1d / L2 / LLC 三级缓存和数据 TLB：
+ *   每条记录拆成它覆盖的 cache line（紧接着重复读同一行只算一次，例如节点头和第一个 key），
+ *   依次查 L1 -> L2 -> LLC，缺失的级别都装入该行（近似 inclusive 层次）；每行所在的页同时查 TLB。
+ *   同时统计重用距离：两次访问同一行之间访问过的不同行数（LRU 栈距离），
+ *   距离 × 64B 小于某级容量的访问在全相联 LRU 缓存中一定命中。
+ * 前 warmup 次查找只用来预热，不计入统计。
+ *
+ * 这是单核、虚拟地址、无预取的模型：不模拟物理地址索引、LLC 切片哈希、
+ * 硬件预取和其他核的干扰，结果用来比较不同配置的相对好坏，而不是预测绝对的计数器值。
+ */
+class CacheSimulator {
+public:
+    static constexpr size_t line_bytes = 64;
+    static constexpr size_t page_bytes = 4096;
+
+    enum Level { L1 = 0, L2 = 1, LLC = 2, TLB = 3, NumLevels = 4 };
+
+    struct Result {
+        size_t queries = 0;
+        uint64_t line_accesses = 0;
+        std::array<uint64_t, NumLevels> misses{};
+        std::vector<std::array<uint64_t, NumLevels>> depth_misses;     // 按树层
+        std::vector<uint64_t> reuse_histogram;      // 下标 k：距离在 [2^(k-1), 2^k) 行，下标 0 为距离 0
+        uint64_t cold = 0;                          // 第一次访问的行
+
+        double per_query(Level level) const {
+            return queries ? static_cast<double>(misses[level]) / queries : 0.0;
+        }
+
+        /// 重用距离小于 bytes 的访问比例（冷访问算作不命中）
+        double reuse_within(size_t bytes) const {
+            uint64_t hits = 0;
+            for (size_t k = 0; k < reuse_histogram.size(); ++k) {
+                size_t upper = (k == 0) ? 1 : (size_t(1) << k);     // 桶内距离 < upper 行
+                if (upper * line_bytes <= bytes) hits += reuse_histogram[k];
+            }
+            return line_accesses ? static_cast<double>(hits) / line_accesses : 0.0;
+        }
+    };
+
+    /// 各级容量 / 相联度取自 CacheInfo，取不到的用常见服务器 CPU 的值
+    explicit CacheSimulator(const CacheInfo& cache = CacheInfo::detect())
+        : m_caches{SetAssociativeCache(or_default(cache.l1d, size_t(48) << 10), or_default(cache.l1d_ways, 12u), line_bytes),
+                   SetAssociativeCache(or_default(cache.l2, size_t(2) << 20), or_default(cache.l2_ways, 16u), line_bytes),
+                   SetAssociativeCache(or_default(cache.llc, size_t(32) << 20), or_default(cache.llc_ways, 16u), line_bytes),
+                   SetAssociativeCache(or_default(cache.tlb_entries, size_t(1536)) * page_bytes,
+                                       or_default(cache.tlb_ways, 12u), page_bytes)} {}
+
+    /// 各级的模拟容量（TLB 为覆盖的字节数）
+    size_t capacity(Level level) const { return m_caches[level].capacity(); }
+    unsigned ways(Level level) const { return m_caches[level].ways(); }
+
+    static const char* name(Level level) {
+        static const char* names[] = {"L1d", "L2", "LLC", "TLB"};
+        return names[level];
+    }
+
+    Result replay(const NodeTrace& trace, size_t warmup = 0) {
+        const auto& accesses = trace.accesses();
+        warmup = std::min(warmup, trace.queries());
+
+        uint64_t total_lines = 0;
+        for (const auto& a : accesses) total_lines += lines_of(a);
+        ReuseDistance reuse(total_lines);
+
+        Result r;
+        r.queries = trace.queries() - warmup;
+        for (size_t q = 0; q < trace.queries(); ++q) {
+            bool count = q >= warmup;
+            uint64_t prev = std::numeric_limits<uint64_t>::max();
+            for (size_t i = trace.query_begin(q); i < trace.query_begin(q + 1); ++i) {
+                const auto& a = accesses[i];
+                if (count && a.depth >= r.depth_misses.size()) r.depth_misses.resize(a.depth + 1);
+
+                uint64_t first = a.addr / line_bytes;
+                for (uint64_t line = first; line < first + lines_of(a); ++line) {
+                    if (line == prev) continue;
+                    prev = line;
+                    uint64_t addr = line * line_bytes;
+                    size_t distance = reuse.access(line);
+                    bool tlb_hit = m_caches[TLB].access(addr);
+                    Level hit = NumLevels;
+                    for (int l = L1; l <= LLC; ++l) {
+                        if (m_caches[l].access(addr)) { hit = static_cast<Level>(l); break; }
+                    }
+                    if (!count) continue;
+
+                    r.line_accesses++;
+                    for (int l = L1; l <= LLC; ++l) {
+                        if (hit > l) { r.misses[l]++; r.depth_misses[a.depth][l]++; }
+                    }
+                    if (!tlb_hit) { r.misses[TLB]++; r.depth_misses[a.depth][TLB]++; }
+
+                    if (distance == ReuseDistance::cold) {
+                        r.cold++;
+                    } else {
+                        size_t k = bucket(distance);
+                        if (k >= r.reuse_histogram.size()) r.reuse_histogram.resize(k + 1, 0);
+                        r.reuse_histogram[k]++;
+                    }
+                }
+            }
+        }
+        return r;
+    }
+
+    /// 直方图第 k 个桶的距离下界（行数）
+    static size_t bucket_lower(size_t k) { return k == 0 ? 0 : (size_t(1) << (k - 1)); }
+
+private:
+    /**
+     * LRU 栈距离：Fenwick 树在每行最近一次访问的时刻上记 1，
+     * 两次访问之间不同行的个数 = 两个时刻之间 1 的个数
+     */
+    class ReuseDistance {
+    public:
+        static constexpr size_t cold = std::numeric_limits<size_t>::max();
+
+        explicit ReuseDistance(uint64_t accesses) : m_tree(accesses + 1, 0) {
+            m_last.reserve(accesses / 4);
+        }
+
+        size_t access(uint64_t line) {
+            size_t now = ++m_time;
+            size_t distance = cold;
+            auto it = m_last.find(line);
+            if (it != m_last.end()) {
+                distance = static_cast<size_t>(prefix(now - 1) - prefix(it->second));
+                add(it->second, -1);
+                it->second = now;
+            } else {
+                m_last.emplace(line, now);
+            }
+            add(now, 1);
+            return distance;
+        }
+
+    private:
+        void add(size_t i, int32_t v) {
+            for (; i < m_tree.size(); i += i & (~i + 1)) m_tree[i] += v;
+        }
+
+        int64_t prefix(size_t i) const {
+            int64_t sum = 0;
+            for (; i > 0; i -= i & (~i + 1)) sum += m_tree[i];
+            return sum;
+        }
+
+        std::vector<int32_t> m_tree;
+        std::unordered_map<uint64_t, size_t> m_last;
+        size_t m_time = 0;
+    };
+
+    template<typename T>
+    static T or_default(T value, T fallback) { return value ? value : fallback; }
+
+    static uint64_t lines_of(const NodeTrace::Access& a) {
+        return (a.addr + a.bytes - 1) / line_bytes - a.addr / line_bytes + 1;
+    }
+
+    static size_t bucket(size_t distance) {
+        size_t k = 0;
+        while (distance) { distance >>= 1; ++k; }
+        return k;
+    }
+
+    std::array<SetAssociativeCache, NumLevels> m_caches;
+};
+
+} // namespace utils
@@ -0,0 +1,198 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <mutex>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <sys/mman.h>
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+namespace utils {
+
+/**
+ * 测试框架缓冲区（key / 查询数组）使用的页大小
+ *   Default: 普通 4KB 页（与 std::allocator 相同）
+ *   THP:     2MB 对齐的匿名映射 + madvise(MADV_HUGEPAGE)
+ *   Huge2M:  MAP_HUGETLB 2MB 大页，失败退回 THP
+ *   Huge1G:  MAP_HUGETLB 1GB 大页，失败退回 2MB -> THP
+ * THP 也失败时退回普通 mmap。
+ */
+enum class PageMode { Default, THP, Huge2M, Huge1G };
+
+class PageConfig {
+public:
+    static PageMode& mode() {
+        static PageMode m = PageMode::Default;
+        return m;
+    }
+
+    /// 命令行参数（4k / thp / 2m / 1g）-> PageMode，无法识别返回 false
+    static bool parse(const std::string& s, PageMode& out) {
+        if (s == "4k")  { out = PageMode::Default; return true; }
+        if (s == "thp") { out = PageMode::THP;     return true; }
+        if (s == "2m")  { out = PageMode::Huge2M;  return true; }
+        if (s == "1g")  { out = PageMode::Huge1G;  return true; }
+        return false;
+    }
+
+    static const char* name(PageMode m) {
+        switch (m) {
+            case PageMode::Default: return "4KB";
+            case PageMode::THP:     return "THP";
+            case PageMode::Huge2M:  return "2MB";
+            case PageMode::Huge1G:  return "1GB";
+        }
+        return "?";
+    }
+};
+
+/**
+ * 记录每块大页映射的实际长度和最终使用的页类型（用于 munmap 和报告回退情况）
+ */
+class PageRegistry {
+public:
+    struct Mapping {
+        void* base;
+        size_t length;
+        PageMode backing;
+    };
+
+    static PageRegistry& instance() {
+        static PageRegistry registry;
+        return registry;
+    }
+
+    void add(void* p, const Mapping& m) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_mappings[p] = m;
+    }
+
+    bool remove(void* p, Mapping& m) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_mappings.find(p);
+        if (it == m_mappings.end()) return false;
+        m = it->second;
+        m_mappings.erase(it);
+        return true;
+    }
+
+    /// 缓冲区实际使用的页类型；不是大页映射（小块或 Default 模式）返回 "4KB"
+    std::string backing(const void* p) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_mappings.find(const_cast<void*>(p));
+        return it == m_mappings.end() ? "4KB" : PageConfig::name(it->second.backing);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<void*, Mapping> m_mappings;
+};
+
+/**
+ * 按 PageConfig::mode() 分配的 STL allocator
+ * 小于 2MB 的分配和 Default 模式直接走 operator new
+ */
+template<typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    static constexpr size_t huge_2m = size_t(1) << 21;
+    static constexpr size_t huge_1g = size_t(1) << 30;
+
+    HugePageAllocator() = default;
+    template<typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        PageMode mode = PageConfig::mode();
+
+        if (mode == PageMode::Default || bytes < huge_2m) {
+            return static_cast<T*>(::operator new(bytes));
+        }
+
+        void* p = nullptr;
+        if (mode == PageMode::Huge1G) {
+            p = map_hugetlb(bytes, huge_1g, MAP_HUGE_1GB, PageMode::Huge1G);
+            if (!p) mode = PageMode::Huge2M;
+        }
+        if (!p && mode == PageMode::Huge2M) {
+            p = map_hugetlb(bytes, huge_2m, MAP_HUGE_2MB, PageMode::Huge2M);
+            if (!p) mode = PageMode::THP;
+        }
+        if (!p) {
+            p = map_thp(bytes);
+        }
+        if (!p) throw std::bad_alloc();
+
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t) {
+        PageRegistry::Mapping m;
+        if (PageRegistry::instance().remove(p, m)) {
+            munmap(m.base, m.length);
+        } else {
+            ::operator delete(p);
+        }
+    }
+
+    template<typename U>
+    bool operator==(const HugePageAllocator<U>&) const { return true; }
+    template<typename U>
+    bool operator!=(const HugePageAllocator<U>&) const { return false; }
+
+private:
+    static size_t round_up(size_t bytes, size_t page) {
+        return (bytes + page - 1) / page * page;
+    }
+
+    static void* map_hugetlb(size_t bytes, size_t page, int flag, PageMode backing) {
+        size_t length = round_up(bytes, page);
+        void* p = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | flag, -1, 0);
+        if (p == MAP_FAILED) return nullptr;
+
+        PageRegistry::instance().add(p, {p, length, backing});
+        return p;
+    }
+
+    /**
+     * 多映射 2MB 以便把起始地址对齐到 2MB，然后 madvise 请求透明大页；
+     * madvise 失败时这块内存仍可用，只是按 4KB 页记录
+     */
+    static void* map_thp(size_t bytes) {
+        size_t length = round_up(bytes, huge_2m) + huge_2m;
+        void* base = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (base == MAP_FAILED) return nullptr;
+
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(base) + huge_2m - 1) & ~(huge_2m - 1);
+        void* p = reinterpret_cast<void*>(aligned);
+
+        PageMode backing = PageMode::THP;
+        if (madvise(p, round_up(bytes, huge_2m), MADV_HUGEPAGE) != 0) {
+            backing = PageMode::Default;
+        }
+
+        PageRegistry::instance().add(p, {base, length, backing});
+        return p;
+    }
+};
+
+template<typename T>
+using huge_vector = std::vector<T, HugePageAllocator<T>>;
+
+} // namespace utils
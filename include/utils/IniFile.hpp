@@ -0,0 +1,117 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstddef>
+
+namespace utils {
+
+/**
+ * 最小的 INI 文件解析：
+ *   [section]
+ *   key = value        ; 或 # 开头的注释（整行或行尾）
+ * 注释标记只在行首或空白之后生效，所以值中可以含有 ; 和 #（如 data/run#2.trace）
+ * 列表值用逗号分隔，首尾空白会被去掉；section 之前的键属于空名 section
+ */
+class IniFile {
+public:
+    /// 解析文件，出错时打印行号并返回 false
+    bool load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "Error: Cannot open file " << path << std::endl;
+            return false;
+        }
+
+        m_values.clear();
+        std::string section, line;
+        for (size_t lineno = 1; std::getline(file, line); ++lineno) {
+            line = trim(strip_comment(line));
+            if (line.empty()) continue;
+
+            if (line.front() == '[') {
+                if (line.back() != ']') {
+                    std::cerr << "Error: " << path << ":" << lineno << ": unterminated section" << std::endl;
+                    return false;
+                }
+                section = trim(line.substr(1, line.size() - 2));
+                continue;
+            }
+
+            size_t eq = line.find('=');
+            if (eq == std::string::npos || trim(line.substr(0, eq)).empty()) {
+                std::cerr << "Error: " << path << ":" << lineno << ": expected key = value" << std::endl;
+                return false;
+            }
+            m_values[section][trim(line.substr(0, eq))] = trim(line.substr(eq + 1));
+        }
+        return true;
+    }
+
+    bool has(const std::string& section, const std::string& key) const {
+        auto s = m_values.find(section);
+        return s != m_values.end() && s->second.count(key);
+    }
+
+    std::string get(const std::string& section, const std::string& key,
+                    const std::string& fallback = "") const {
+        auto s = m_values.find(section);
+        if (s == m_values.end()) return fallback;
+        auto v = s->second.find(key);
+        return v == s->second.end() ? fallback : v->second;
+    }
+
+    /// 逗号分隔的列表，键不存在时返回 fallback
+    std::vector<std::string> get_list(const std::string& section, const std::string& key,
+                                      const std::vector<std::string>& fallback = {}) const {
+        if (!has(section, key)) return fallback;
+
+        std::vector<std::string> items;
+        std::string value = get(section, key);
+        for (size_t pos = 0; pos <= value.size(); ) {
+            size_t comma = value.find(',', pos);
+            if (comma == std::string::npos) comma = value.size();
+            std::string item = trim(value.substr(pos, comma - pos));
+            if (!item.empty()) items.push_back(item);
+            pos = comma + 1;
+        }
+        return items;
+    }
+
+    /// section 中出现过但不在 known 中的键（用于提示拼写错误）
+    std::vector<std::string> unknown_keys(const std::string& section,
+                                          const std::vector<std::string>& known) const {
+        std::vector<std::string> unknown;
+        auto s = m_values.find(section);
+        if (s == m_values.end()) return unknown;
+        for (const auto& kv : s->second) {
+            bool found = false;
+            for (const auto& k : known) found = found || (k == kv.first);
+            if (!found) unknown.push_back(kv.first);
+        }
+        return unknown;
+    }
+
+private:
+    static std::string strip_comment(const std::string& line) {
+        for (size_t i = 0; i < line.size(); ++i) {
+            if ((line[i] == ';' || line[i] == '#') && (i == 0 || line[i - 1] == ' ' || line[i - 1] == '\t')) {
+                return line.substr(0, i);
+            }
+        }
+        return line;
+    }
+
+    static std::string trim(const std::string& s) {
+        size_t b = s.find_first_not_of(" \t\r\n");
+        if (b == std::string::npos) return "";
+        size_t e = s.find_last_not_of(" \t\r\n");
+        return s.substr(b, e - b + 1);
+    }
+
+    std::map<std::string, std::map<std::string, std::string>> m_values;
+};
+
+} // namespace utils
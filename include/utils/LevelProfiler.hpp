@@ -0,0 +1,77 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <x86intrin.h>
+
+namespace utils {
+
+// 前后各一个 lfence 的 rdtsc：之前的 load 完成后才读时间戳，之后的指令也不会提前执行
+inline uint64_t serialized_rdtsc() {
+    _mm_lfence();
+    uint64_t t = __rdtsc();
+    _mm_lfence();
+    return t;
+}
+
+/**
+ * 按树层统计查找耗时（TSC cycles）
+ *
+ * 作为 btree find_visit() 的 visitor：每个节点搜索前调用 enter()，
+ * 叶子搜索完调用 done()。第 d 层的耗时 = 进入下一层（或 done）的时间戳
+ * 减去进入第 d 层的时间戳，包含取节点的访存和节点内查找。
+ * 两次 rdtsc 本身的开销由 calibrate() 测出，avg_cycles() 中扣除。
+ */
+class LevelProfiler {
+public:
+    LevelProfiler() : m_overhead(calibrate()) {}
+
+    void enter(unsigned depth, const void* /* node */, size_t /* bytes */) {
+        uint64_t now = serialized_rdtsc();
+        if (depth > 0) add(depth - 1, now - m_last);
+        m_last = now;
+    }
+
+    void done(unsigned depth) {
+        add(depth, serialized_rdtsc() - m_last);
+        m_lookups++;
+    }
+
+    /// 第 level 层（根为 0）每次查找的平均 cycles
+    double avg_cycles(size_t level) const {
+        if (level >= m_cycles.size() || m_lookups == 0) return 0.0;
+        double avg = static_cast<double>(m_cycles[level]) / m_lookups - m_overhead;
+        return std::max(avg, 0.0);
+    }
+
+    size_t levels() const { return m_cycles.size(); }
+    size_t lookups() const { return m_lookups; }
+    double overhead_cycles() const { return m_overhead; }
+
+    /**
+     * 连续两次 serialized_rdtsc() 的平均间隔
+     */
+    static double calibrate(size_t rounds = 100'000) {
+        uint64_t total = 0;
+        for (size_t i = 0; i < rounds; ++i) {
+            uint64_t t0 = serialized_rdtsc();
+            uint64_t t1 = serialized_rdtsc();
+            total += t1 - t0;
+        }
+        return static_cast<double>(total) / rounds;
+    }
+
+private:
+    void add(size_t level, uint64_t cycles) {
+        if (level >= m_cycles.size()) m_cycles.resize(level + 1, 0);
+        m_cycles[level] += cycles;
+    }
+
+    std::vector<uint64_t> m_cycles;
+    size_t m_lookups = 0;
+    uint64_t m_last = 0;
+    double m_overhead;
+};
+
+} // namespace utils
@@ -0,0 +1,268 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <random>
+#include <optional>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include "CacheInfo.hpp"
+#include "HugePageAllocator.hpp"
+#include "Parallel.hpp"
+#include "Timer.hpp"
+
+namespace utils {
+
+/**
+ * 本机访存延迟 / 并行度 / 带宽校准，用来解释 ns/query：
+ *   延迟：在 L1 / L2 / LLC / DRAM 大小的工作集上做随机指针追逐（每个 cache line 一个节点，
+ *         访问顺序为一个随机大环，下一次访问依赖上一次的结果，硬件预取无效）
+ *   MLP： 在 DRAM 工作集上同时追逐 K 条独立的链，每次访问的平均耗时降到 DRAM 延迟的 1/K 以下时
+ *         说明 K 个缺失可以重叠；有效 MLP = DRAM 延迟 / 最小每次访问耗时
+ *   带宽：顺序读整个 DRAM 工作集（单线程和全部线程）
+ * 工作集按 PageConfig 的页大小分配，所以 DRAM 延迟包含与查询缓冲区相同的 TLB 开销。
+ *
+ * 全局选项 --calibrate 在运行测试前测量一次并存入 current()，
+ * 之后查询延迟可以折算成 "每次查找相当于几次 DRAM 缺失"（dram_equivalent()）。
+ */
+struct MemoryCalibration {
+    struct Level {
+        std::string name;
+        size_t bytes;
+        double ns;
+    };
+
+    std::vector<Level> levels;                          // L1 / L2 / LLC / DRAM
+    std::vector<std::pair<unsigned, double>> mlp_curve; // (并行链数, 每次访问 ns)
+    double dram_ns = 0.0;
+    double mlp = 0.0;
+    unsigned mlp_chains = 0;
+    double bandwidth_gbs = 0.0;         // 单线程顺序读
+    double bandwidth_all_gbs = 0.0;     // 全部线程顺序读
+    unsigned threads = 0;
+
+    bool valid() const { return dram_ns > 0.0; }
+
+    /// 把一次查找的延迟折算成 DRAM 缺失次数
+    double dram_equivalent(double ns) const {
+        return valid() ? ns / dram_ns : 0.0;
+    }
+
+    /// 当前运行的校准结果（--calibrate 或 calibrate 模式设置）
+    static std::optional<MemoryCalibration>& current() {
+        static std::optional<MemoryCalibration> calibration;
+        return calibration;
+    }
+
+    static MemoryCalibration measure(const CacheInfo& cache = CacheInfo::detect()) {
+        MemoryCalibration c;
+
+        size_t l1 = cache.l1d ? cache.l1d : (size_t(32) << 10);
+        size_t l2 = cache.l2 ? cache.l2 : (size_t(1) << 20);
+        size_t llc = cache.llc ? cache.llc : (size_t(32) << 20);
+        size_t dram = std::min(std::max(llc * 4, size_t(256) << 20), size_t(1) << 30);
+
+        // 工作集取各级容量的一半，避免和相邻数据、页表争用
+        const std::pair<const char*, size_t> sets[] = {
+            {"L1", l1 / 2}, {"L2", l2 / 2}, {"LLC", llc / 2}, {"DRAM", dram}};
+        for (const auto& s : sets) {
+            ChaseBuffer buffer(s.second);
+            size_t steps = (s.first == std::string("DRAM")) ? 2'000'000 : 10'000'000;
+            ChaseBuffer::sink(buffer.chase(buffer.head(), buffer.lines()));   // 预热
+            c.levels.push_back({s.first, buffer.lines() * line_bytes, buffer.latency_ns(steps)});
+
+            if (s.first == std::string("DRAM")) {
+                c.dram_ns = c.levels.back().ns;
+                c.measure_mlp(buffer);
+                c.measure_bandwidth(buffer);
+            }
+        }
+        return c;
+    }
+
+    void print() const {
+        std::cout << "\n  ╔═══════════════════════════════════════════════╗" << std::endl;
+        std::cout << "  ║  Level     Working Set  Latency(ns)    vs L1  ║" << std::endl;
+        std::cout << "  ╠═══════════════════════════════════════════════╣" << std::endl;
+        for (const auto& l : levels) {
+            std::cout << std::fixed << std::setprecision(2);
+            std::cout << "  ║  " << std::left << std::setw(8) << l.name << std::right
+                      << std::setw(13) << CacheInfo::format_bytes(l.bytes)
+                      << std::setw(13) << l.ns
+                      << std::setw(8) << l.ns / levels.front().ns << "x  ║" << std::endl;
+        }
+        std::cout << "  ╚═══════════════════════════════════════════════╝" << std::endl;
+
+        std::cout << "\n  ╔══════════════════════════════════════╗" << std::endl;
+        std::cout << "  ║  Chains    ns/access  Effective MLP  ║" << std::endl;
+        std::cout << "  ╠══════════════════════════════════════╣" << std::endl;
+        for (const auto& m : mlp_curve) {
+            std::cout << std::fixed << std::setprecision(2);
+            std::cout << "  ║  " << std::left << std::setw(8) << m.first << std::right
+                      << std::setw(11) << m.second
+                      << std::setw(15) << dram_ns / m.second << "  ║" << std::endl;
+        }
+        std::cout << "  ╚══════════════════════════════════════╝" << std::endl;
+
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "\n  DRAM Latency:     " << dram_ns << " ns" << std::endl;
+        std::cout << "  Max MLP:          " << mlp << " (" << mlp_chains << " chains)" << std::endl;
+        std::cout << "  Read Bandwidth:   " << bandwidth_gbs << " GB/s (1 thread), "
+                  << bandwidth_all_gbs << " GB/s (" << threads << " threads)" << std::endl;
+    }
+
+    /// 写成 "<prefix>calib_<name>=<value>" 形式的元数据行（CSV 头部注释等）
+    void write_metadata(std::ostream& os, const std::string& prefix = "# ") const {
+        os << std::fixed << std::setprecision(3);
+        for (const auto& l : levels) {
+            os << prefix << "calib_" << l.name << "_ns=" << l.ns
+               << " calib_" << l.name << "_bytes=" << l.bytes << "\n";
+        }
+        os << prefix << "calib_mlp=" << mlp << " calib_mlp_chains=" << mlp_chains << "\n";
+        os << prefix << "calib_bandwidth_gbs=" << bandwidth_gbs
+           << " calib_bandwidth_all_gbs=" << bandwidth_all_gbs << " calib_threads=" << threads << "\n";
+    }
+
+private:
+    static constexpr size_t line_bytes = 64;
+    static constexpr size_t line_words = line_bytes / sizeof(uint64_t);
+
+    /**
+     * 按 cache line 组织的随机环：每行第一个字存下一行的地址
+     * order 为环上的访问顺序，用来给多条并行链挑选均匀分布的起点
+     */
+    class ChaseBuffer {
+    public:
+        explicit ChaseBuffer(size_t bytes)
+            : m_lines(std::max<size_t>(bytes / line_bytes, 16)),
+              m_words((m_lines + 1) * line_words),
+              m_order(m_lines) {
+            // operator new 只保证 16 字节对齐，手动对齐到 cache line
+            uintptr_t addr = reinterpret_cast<uintptr_t>(m_words.data());
+            m_base = m_words.data() + ((line_bytes - addr % line_bytes) % line_bytes) / sizeof(uint64_t);
+
+            for (size_t i = 0; i < m_lines; ++i) m_order[i] = static_cast<uint32_t>(i);
+            std::mt19937_64 rng(42);
+            std::shuffle(m_order.begin(), m_order.end(), rng);
+            for (size_t i = 0; i < m_lines; ++i) {
+                m_base[m_order[i] * line_words] =
+                    reinterpret_cast<uint64_t>(line(m_order[(i + 1) % m_lines]));
+            }
+        }
+
+        size_t lines() const { return m_lines; }
+        const uint64_t* head() const { return line(m_order[0]); }
+
+        /// 环上第 k * lines / parts 个节点
+        const uint64_t* start(unsigned k, unsigned parts) const {
+            return line(m_order[size_t(k) * m_lines / parts]);
+        }
+
+        static const uint64_t* chase(const uint64_t* p, size_t steps) {
+            for (size_t i = 0; i < steps; ++i) {
+                p = reinterpret_cast<const uint64_t*>(*p);
+            }
+            return p;
+        }
+
+        double latency_ns(size_t steps) const {
+            Timer timer;
+            const uint64_t* p = chase(head(), steps);
+            double ns = (timer.elapsed_ms() * 1e6) / steps;
+            sink(p);
+            return ns;
+        }
+
+        /// K 条独立的链交替前进，返回每次访问的平均耗时
+        template<unsigned K>
+        double parallel_ns(size_t steps) const {
+            const uint64_t* p[K];
+            for (unsigned k = 0; k < K; ++k) p[k] = start(k, K);
+
+            Timer timer;
+            for (size_t i = 0; i < steps; ++i) {
+                for (unsigned k = 0; k < K; ++k) {
+                    p[k] = reinterpret_cast<const uint64_t*>(*p[k]);
+                }
+            }
+            double ns = (timer.elapsed_ms() * 1e6) / (steps * K);
+            for (unsigned k = 0; k < K; ++k) sink(p[k]);
+            return ns;
+        }
+
+        /// 顺序读 [lo, hi) 行的所有字
+        uint64_t sum(size_t lo, size_t hi) const {
+            uint64_t acc = 0;
+            const uint64_t* w = m_base + lo * line_words;
+            for (size_t i = 0, n = (hi - lo) * line_words; i < n; ++i) acc += w[i];
+            return acc;
+        }
+
+        /// 让编译器保留追逐 / 求和的结果
+        static void sink(uint64_t v) {
+            asm volatile("" : : "r"(v) : "memory");
+        }
+
+        static void sink(const void* p) {
+            sink(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p)));
+        }
+
+    private:
+        const uint64_t* line(size_t i) const { return m_base + i * line_words; }
+
+        size_t m_lines;
+        huge_vector<uint64_t> m_words;
+        uint64_t* m_base;
+        std::vector<uint32_t> m_order;
+    };
+
+    /// 总访问次数固定，链数越多每条链越短
+    template<unsigned K>
+    void measure_chains(const ChaseBuffer& buffer) {
+        double ns = buffer.parallel_ns<K>(2'000'000 / K);
+        mlp_curve.emplace_back(K, ns);
+        if (dram_ns / ns > mlp) {
+            mlp = dram_ns / ns;
+            mlp_chains = K;
+        }
+    }
+
+    void measure_mlp(const ChaseBuffer& buffer) {
+        measure_chains<1>(buffer);
+        measure_chains<2>(buffer);
+        measure_chains<4>(buffer);
+        measure_chains<6>(buffer);
+        measure_chains<8>(buffer);
+        measure_chains<12>(buffer);
+        measure_chains<16>(buffer);
+        measure_chains<24>(buffer);
+        measure_chains<32>(buffer);
+    }
+
+    void measure_bandwidth(const ChaseBuffer& buffer) {
+        const double bytes = double(buffer.lines()) * line_bytes;
+        const size_t n = buffer.lines();
+
+        // 取两遍中较快的一遍
+        for (int pass = 0; pass < 2; ++pass) {
+            Timer timer;
+            ChaseBuffer::sink(buffer.sum(0, n));
+            bandwidth_gbs = std::max(bandwidth_gbs, bytes / (timer.elapsed_ms() * 1e6));
+        }
+
+        threads = hardware_threads();
+        std::vector<uint64_t> partial(threads);
+        for (int pass = 0; pass < 2; ++pass) {
+            Timer timer;
+            run_parallel(threads, [&](unsigned t) {
+                partial[t] = buffer.sum(chunk_begin(n, threads, t), chunk_begin(n, threads, t + 1));
+            });
+            bandwidth_all_gbs = std::max(bandwidth_all_gbs, bytes / (timer.elapsed_ms() * 1e6));
+            for (uint64_t acc : partial) ChaseBuffer::sink(acc);
+        }
+    }
+};
+
+} // namespace utils
@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstddef>
+
+namespace utils {
+
+/// 硬件线程数（取不到时为 1）
+inline unsigned hardware_threads() {
+    unsigned t = std::thread::hardware_concurrency();
+    return t ? t : 1;
+}
+
+/// 把 [0, n) 均分成 parts 段时第 t 段的起点，chunk_begin(n, parts, parts) == n
+inline size_t chunk_begin(size_t n, unsigned parts, unsigned t) {
+    return n / parts * t + std::min<size_t>(t, n % parts);
+}
+
+/// 在 threads 个线程上运行 f(t)，t = 0 在当前线程执行，返回时全部完成
+template<typename F>
+void run_parallel(unsigned threads, F f) {
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back([&f, t] { f(t); });
+    }
+    f(0);
+    for (auto& w : workers) w.join();
+}
+
+} // namespace utils
@@ -0,0 +1,95 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+namespace utils {
+
+/**
+ * 基于 perf_event_open 的硬件计数器（只统计用户态）
+ *   L1DMiss: L1 数据缓存读缺失
+ *   LLCMiss: 最后一级缓存缺失
+ *   DTLBMiss: 数据 TLB 读缺失
+ * 虚拟机 / 容器中常常没有权限或没有 PMU，此时 available() 为 false，
+ * 调用方打印 "n/a" 即可，start()/stop() 仍可安全调用。
+ */
+class PerfCounters {
+public:
+    enum Event { L1DMiss, LLCMiss, DTLBMiss, NumEvents };
+
+    PerfCounters() {
+        m_fd[L1DMiss] = open_event(PERF_TYPE_HW_CACHE,
+                                   PERF_COUNT_HW_CACHE_L1D
+                                   | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                   | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+        m_fd[LLCMiss] = open_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+        m_fd[DTLBMiss] = open_event(PERF_TYPE_HW_CACHE,
+                                    PERF_COUNT_HW_CACHE_DTLB
+                                    | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    }
+
+    ~PerfCounters() {
+        for (int e = 0; e < NumEvents; ++e) {
+            if (m_fd[e] >= 0) close(m_fd[e]);
+        }
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available(Event e) const { return m_fd[e] >= 0; }
+
+    void start() {
+        for (int e = 0; e < NumEvents; ++e) {
+            m_count[e] = 0;
+            if (m_fd[e] < 0) continue;
+            ioctl(m_fd[e], PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    void stop() {
+        for (int e = 0; e < NumEvents; ++e) {
+            if (m_fd[e] < 0) continue;
+            ioctl(m_fd[e], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t value = 0;
+            if (read(m_fd[e], &value, sizeof(value)) == sizeof(value)) {
+                m_count[e] = value;
+            }
+        }
+    }
+
+    /// 最近一次 start() 到 stop() 之间的计数
+    uint64_t count(Event e) const { return m_count[e]; }
+
+    static const char* name(Event e) {
+        switch (e) {
+            case L1DMiss: return "L1D miss";
+            case LLCMiss: return "LLC miss";
+            case DTLBMiss: return "dTLB miss";
+            default:      return "?";
+        }
+    }
+
+private:
+    static int open_event(uint32_t type, uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    int m_fd[NumEvents];
+    uint64_t m_count[NumEvents] = {};
+};
+
+} // namespace utils
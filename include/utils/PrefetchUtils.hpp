@@ -1,8 +1,85 @@
 #pragma once
 #include <xmmintrin.h>
+#include <cstddef>
+#include <cstdint>
 
 // prefetch 操作
 inline void do_prefetch(const void* p) {
     // 使用 T0 （将位于p位置的数据读取到所有缓存层级（优先L1））
     _mm_prefetch((const char*)p, _MM_HINT_T0);
-}
\ No newline at end of file
+}
+
+// ==================== 预取策略 ====================
+
+/**
+ * 预取提示
+ *   T0 / T1 / T2: 取到 L1 / L2 / L3 及以下各级
+ *   NTA:          非时间局部性，尽量不污染缓存
+ *   W:            带写意图（PREFETCHW），用于插入等写路径，直接取得独占状态
+ */
+enum class PrefetchHint { T0, T1, T2, NTA, W };
+
+/**
+ * 预取范围
+ *   KeyArray:  节点头部 + key 数组（查找只需要这一段）
+ *   WholeNode: 整个节点（包括 value 数组 / 孩子指针）
+ */
+enum class PrefetchScope { KeyArray, WholeNode };
+
+constexpr size_t cache_line_bytes = 64;
+
+template<PrefetchHint Hint>
+inline void prefetch_line(const void* p) {
+    const char* c = static_cast<const char*>(p);
+    switch (Hint) {
+        case PrefetchHint::T0:  _mm_prefetch(c, _MM_HINT_T0);  break;
+        case PrefetchHint::T1:  _mm_prefetch(c, _MM_HINT_T1);  break;
+        case PrefetchHint::T2:  _mm_prefetch(c, _MM_HINT_T2);  break;
+        case PrefetchHint::NTA: _mm_prefetch(c, _MM_HINT_NTA); break;
+        // 支持 PRFCHW 时编译为 prefetchw，否则退化为 prefetcht0
+        case PrefetchHint::W:   __builtin_prefetch(c, 1, 3);   break;
+    }
+}
+
+/**
+ * 预取 [p, p + bytes) 覆盖的所有 cache line
+ */
+template<PrefetchHint Hint>
+inline void prefetch_range(const void* p, size_t bytes) {
+    uintptr_t line = reinterpret_cast<uintptr_t>(p) & ~(cache_line_bytes - 1);
+    uintptr_t end = reinterpret_cast<uintptr_t>(p) + bytes;
+    for (; line < end; line += cache_line_bytes) {
+        prefetch_line<Hint>(reinterpret_cast<const void*>(line));
+    }
+}
+
+/**
+ * 节点预取策略，作为编译期参数交给树的配置（CustomBTree 的 Prefetch 参数）
+ * prefetch_node() 的 key_bytes 为节点起始到 key 数组末尾的字节数，node_bytes 为整个节点大小
+ */
+template<PrefetchScope Scope, PrefetchHint Hint>
+struct PrefetchPolicy {
+    static constexpr PrefetchScope scope = Scope;
+    static constexpr PrefetchHint hint = Hint;
+
+    static void prefetch_node(const void* node, size_t key_bytes, size_t node_bytes) {
+        prefetch_range<Hint>(node, Scope == PrefetchScope::WholeNode ? node_bytes : key_bytes);
+    }
+
+    static const char* scope_name() {
+        return Scope == PrefetchScope::WholeNode ? "node" : "keys";
+    }
+
+    static const char* hint_name() {
+        switch (Hint) {
+            case PrefetchHint::T0:  return "T0";
+            case PrefetchHint::T1:  return "T1";
+            case PrefetchHint::T2:  return "T2";
+            case PrefetchHint::NTA: return "NTA";
+            case PrefetchHint::W:   return "W";
+        }
+        return "?";
+    }
+};
+
+using DefaultPrefetchPolicy = PrefetchPolicy<PrefetchScope::KeyArray, PrefetchHint::T0>;
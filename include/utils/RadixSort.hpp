@@ -0,0 +1,245 @@
+#pragma once
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "HugePageAllocator.hpp"
+#include "Parallel.hpp"
+
+namespace utils {
+
+/**
+ * 并行基数排序和去重（uint32 / uint64 key），bulk_load 之前的排序 + 去重阶段使用
+ *
+ * 每轮按 8 位分桶：每个线程负责一段连续数据，先各自统计直方图，
+ * 再按 (桶, 线程) 顺序求前缀和得到每个线程在每个桶中的写入位置，最后并行 scatter（稳定）。
+ * 所有 key 在某一字节上都相同时跳过这一轮（SOSD key 的高位常常全部相同）。
+ *
+ *   lsd_sort: 从低字节到高字节，每轮都是整块数据的并行 scatter
+ *   msd_sort: 先按最高的非平凡字节并行划分成 256 个桶，
+ *             各线程再动态领取桶，桶内用单线程 LSD 排剩余字节（桶能放进缓存时更快，
+ *             但 key 集中在少数几个桶时并行度下降）
+ *   unique:   两遍：先并行统计每段的不重复 key 数，前缀和后并行写出
+ *
+ * threads 为 0 时使用全部硬件线程；数据较少时退化为单线程。
+ */
+class ParallelRadixSort {
+public:
+    static unsigned default_threads() {
+        return hardware_threads();
+    }
+
+    template<typename T>
+    static void lsd_sort(T* data, size_t n, unsigned threads = 0) {
+        check_key_type<T>();
+        threads = thread_count(n, threads);
+        T diff = differing_bits(data, n, threads);
+        if (diff == 0) return;
+
+        Buffer<T> tmp(n);
+        T* src = data;
+        T* dst = tmp.data;
+        for (unsigned shift = 0; shift < sizeof(T) * 8; shift += 8) {
+            if (((diff >> shift) & 0xFF) == 0) continue;
+            scatter(src, dst, n, shift, threads, nullptr);
+            std::swap(src, dst);
+        }
+
+        // 轮数为奇数时结果在临时缓冲区中
+        if (src != data) parallel_copy(src, data, n, threads);
+    }
+
+    template<typename T>
+    static void msd_sort(T* data, size_t n, unsigned threads = 0) {
+        check_key_type<T>();
+        threads = thread_count(n, threads);
+        T diff = differing_bits(data, n, threads);
+        if (diff == 0) return;
+
+        unsigned top = sizeof(T) * 8 - 8;
+        while (((diff >> top) & 0xFF) == 0) top -= 8;
+
+        // 1. 按最高的非平凡字节划分到临时缓冲区
+        Buffer<T> tmp(n);
+        size_t bounds[257];
+        scatter(data, tmp.data, n, top, threads, bounds);
+
+        // 2. 大桶先领，桶内排好后写回 data 中相同的区间
+        std::vector<unsigned> order(256);
+        for (unsigned b = 0; b < 256; ++b) order[b] = b;
+        std::sort(order.begin(), order.end(), [&bounds](unsigned a, unsigned b) {
+            return bounds[a + 1] - bounds[a] > bounds[b + 1] - bounds[b];
+        });
+
+        std::atomic<size_t> next{0};
+        run_parallel(threads, [&](unsigned) {
+            for (size_t i = next++; i < 256; i = next++) {
+                size_t lo = bounds[order[i]], len = bounds[order[i] + 1] - lo;
+                if (len == 0) continue;
+                sort_bucket(tmp.data + lo, data + lo, len, top);
+            }
+        });
+    }
+
+    /// 默认排序（LSD）
+    template<typename T>
+    static void sort(T* data, size_t n, unsigned threads = 0) {
+        lsd_sort(data, n, threads);
+    }
+
+    /**
+     * 对已排序的 in 去重，每个不重复的 key 调用一次 emit(输出位置, key)，返回不重复 key 数
+     * emit 会被多个线程并发调用，但输出位置互不相同
+     */
+    template<typename T, typename Emit>
+    static size_t unique(const T* in, size_t n, Emit emit, unsigned threads = 0) {
+        threads = thread_count(n, threads);
+        std::vector<size_t> counts(threads + 1, 0);
+
+        run_parallel(threads, [&](unsigned t) {
+            size_t lo = chunk_begin(n, threads, t), hi = chunk_begin(n, threads, t + 1);
+            size_t c = 0;
+            for (size_t i = lo; i < hi; ++i) {
+                c += (i == 0 || in[i] != in[i - 1]);
+            }
+            counts[t + 1] = c;
+        });
+        for (unsigned t = 0; t < threads; ++t) counts[t + 1] += counts[t];
+
+        run_parallel(threads, [&](unsigned t) {
+            size_t lo = chunk_begin(n, threads, t), hi = chunk_begin(n, threads, t + 1);
+            size_t pos = counts[t];
+            for (size_t i = lo; i < hi; ++i) {
+                if (i == 0 || in[i] != in[i - 1]) emit(pos++, in[i]);
+            }
+        });
+        return counts[threads];
+    }
+
+    /// 去重并拷贝到 out（容量至少为 n），返回不重复 key 数
+    template<typename T>
+    static size_t unique_copy(const T* in, size_t n, T* out, unsigned threads = 0) {
+        return unique(in, n, [out](size_t i, T key) { out[i] = key; }, threads);
+    }
+
+private:
+    /// 少于这个数量的 key 不值得开线程
+    static constexpr size_t min_parallel = size_t(1) << 16;
+
+    /// 桶内少于这个数量时直接 std::sort
+    static constexpr size_t small_bucket = 256;
+
+    /// 不做初始化的临时缓冲区，按 PageConfig 的页大小分配，由 scatter 并行首次写入
+    template<typename T>
+    struct Buffer {
+        HugePageAllocator<T> alloc;
+        size_t n;
+        T* data;
+
+        explicit Buffer(size_t count) : n(count), data(alloc.allocate(count)) {}
+        ~Buffer() { alloc.deallocate(data, n); }
+
+        Buffer(const Buffer&) = delete;
+        Buffer& operator=(const Buffer&) = delete;
+    };
+
+    template<typename T>
+    static void check_key_type() {
+        static_assert(std::is_same<T, uint32_t>::value || std::is_same<T, uint64_t>::value,
+                      "ParallelRadixSort supports uint32_t and uint64_t keys");
+    }
+
+    static unsigned thread_count(size_t n, unsigned threads) {
+        if (threads == 0) threads = default_threads();
+        if (n < min_parallel) return 1;
+        return static_cast<unsigned>(std::min<size_t>(threads, n / (min_parallel / 4)));
+    }
+
+    /// 与第一个 key 不同的所有位：某字节为 0 表示所有 key 在该字节上相同
+    template<typename T>
+    static T differing_bits(const T* data, size_t n, unsigned threads) {
+        if (n < 2) return 0;
+        std::vector<T> partial(threads, 0);
+        run_parallel(threads, [&](unsigned t) {
+            size_t lo = chunk_begin(n, threads, t), hi = chunk_begin(n, threads, t + 1);
+            T acc = 0;
+            for (size_t i = lo; i < hi; ++i) acc |= data[i] ^ data[0];
+            partial[t] = acc;
+        });
+        T diff = 0;
+        for (T p : partial) diff |= p;
+        return diff;
+    }
+
+    /**
+     * 按 (key >> shift) & 0xFF 把 src 稳定地分桶写到 dst
+     * bounds 非空时返回 257 个桶边界
+     */
+    template<typename T>
+    static void scatter(const T* src, T* dst, size_t n, unsigned shift, unsigned threads, size_t* bounds) {
+        std::vector<size_t> pos(size_t(threads) * 256, 0);
+
+        run_parallel(threads, [&](unsigned t) {
+            size_t lo = chunk_begin(n, threads, t), hi = chunk_begin(n, threads, t + 1);
+            size_t* hist = &pos[size_t(t) * 256];
+            for (size_t i = lo; i < hi; ++i) hist[(src[i] >> shift) & 0xFF]++;
+        });
+
+        size_t offset = 0;
+        for (unsigned d = 0; d < 256; ++d) {
+            if (bounds) bounds[d] = offset;
+            for (unsigned t = 0; t < threads; ++t) {
+                size_t c = pos[size_t(t) * 256 + d];
+                pos[size_t(t) * 256 + d] = offset;
+                offset += c;
+            }
+        }
+        if (bounds) bounds[256] = offset;
+
+        run_parallel(threads, [&](unsigned t) {
+            size_t lo = chunk_begin(n, threads, t), hi = chunk_begin(n, threads, t + 1);
+            size_t local[256];
+            std::memcpy(local, &pos[size_t(t) * 256], sizeof(local));
+            for (size_t i = lo; i < hi; ++i) {
+                T key = src[i];
+                dst[local[(key >> shift) & 0xFF]++] = key;
+            }
+        });
+    }
+
+    template<typename T>
+    static void parallel_copy(const T* src, T* dst, size_t n, unsigned threads) {
+        run_parallel(threads, [&](unsigned t) {
+            size_t lo = chunk_begin(n, threads, t), hi = chunk_begin(n, threads, t + 1);
+            std::memcpy(dst + lo, src + lo, (hi - lo) * sizeof(T));
+        });
+    }
+
+    /**
+     * 单线程排序 MSD 划分出的一个桶：key 在 in 中，结果写到 out，
+     * 只处理低于 top 的字节，in / out 轮流作为临时缓冲区
+     */
+    template<typename T>
+    static void sort_bucket(T* in, T* out, size_t n, unsigned top) {
+        if (n < small_bucket) {
+            std::sort(in, in + n);
+            std::memcpy(out, in, n * sizeof(T));
+            return;
+        }
+
+        T diff = differing_bits(in, n, 1);
+        T* src = in;
+        T* dst = out;
+        for (unsigned shift = 0; shift < top; shift += 8) {
+            if (((diff >> shift) & 0xFF) == 0) continue;
+            scatter(src, dst, n, shift, 1, nullptr);
+            std::swap(src, dst);
+        }
+        if (src != out) std::memcpy(out, src, n * sizeof(T));
+    }
+};
+
+} // namespace utils
@@ -0,0 +1,100 @@
+#pragma once
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include "CacheInfo.hpp"
+#include "HugePageAllocator.hpp"
+
+namespace utils {
+
+/**
+ * 查询之间插入的合成应用负载：
+ *   compute: 一条依赖链上的整数乘法 / 移位迭代次数（纯计算，不访存）
+ *   pollute: 每次写多少字节的污染缓冲区（按 cache line 顺序推进，循环使用一块大于 LLC 的缓冲区，
+ *            每次写到的行都不在缓存中，并把查询用到的行挤出去）
+ * run(x) 的结果依赖 x，调用方把上一次查找的结果喂进去，负载和查找之间就有真实的数据依赖。
+ */
+class SyntheticWork {
+public:
+    SyntheticWork(unsigned compute = 0, size_t pollute_bytes = 0)
+        : m_compute(compute),
+          m_lines(pollute_bytes / line_bytes) {
+        if (m_lines == 0) return;
+        CacheInfo cache = CacheInfo::detect();
+        size_t llc = cache.llc ? cache.llc : (size_t(32) << 20);
+        m_buffer.assign(std::max(llc * 2, size_t(64) << 20) / sizeof(uint64_t), 0);
+    }
+
+    bool enabled() const { return m_compute > 0 || m_lines > 0; }
+    unsigned compute() const { return m_compute; }
+    size_t pollute_bytes() const { return m_lines * line_bytes; }
+
+    uint64_t run(uint64_t x) {
+        for (unsigned i = 0; i < m_compute; ++i) {
+            x ^= x >> 29;
+            x *= 0xBF58476D1CE4E5B9ull;
+        }
+        for (size_t i = 0; i < m_lines; ++i) {
+            m_buffer[m_cursor] += x;
+            m_cursor += line_words;
+            if (m_cursor >= m_buffer.size()) m_cursor = 0;
+        }
+        return x;
+    }
+
+    /// "200"、"200:4k"、"0:64k"（计算迭代次数[:每次污染的字节数]），无法识别返回 false
+    static bool parse(const std::string& s, unsigned& compute, size_t& pollute_bytes) {
+        size_t colon = s.find(':');
+        std::string c = s.substr(0, colon);
+        std::string p = (colon == std::string::npos) ? "0" : s.substr(colon + 1);
+        if (c.empty() || c.find_first_not_of("0123456789") != std::string::npos || p.empty()) return false;
+
+        char* end = nullptr;
+        unsigned long long bytes = std::strtoull(p.c_str(), &end, 10);
+        std::string suffix = end;
+        if (suffix == "k" || suffix == "K") bytes <<= 10;
+        else if (suffix == "m" || suffix == "M") bytes <<= 20;
+        else if (!suffix.empty() || end == p.c_str()) return false;
+
+        compute = static_cast<unsigned>(std::stoul(c));
+        pollute_bytes = static_cast<size_t>(bytes);
+        return true;
+    }
+
+    std::string describe() const {
+        std::ostringstream os;
+        os << m_compute << " compute iters";
+        if (m_lines) os << " + " << CacheInfo::format_bytes(pollute_bytes()) << " polluted";
+        return os.str();
+    }
+
+private:
+    static constexpr size_t line_bytes = 64;
+    static constexpr size_t line_words = line_bytes / sizeof(uint64_t);
+
+    unsigned m_compute;
+    size_t m_lines;
+    huge_vector<uint64_t> m_buffer;
+    size_t m_cursor = 0;
+};
+
+/**
+ * 全局选项 --work=<compute>[:<bytes>]：单数据集测试的查询循环中每次查找后执行的合成负载
+ */
+class WorkConfig {
+public:
+    static unsigned& compute() {
+        static unsigned iters = 0;
+        return iters;
+    }
+
+    static size_t& pollute_bytes() {
+        static size_t bytes = 0;
+        return bytes;
+    }
+};
+
+} // namespace utils
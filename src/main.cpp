@@ -7,49 +7,153 @@
 #include <vector>
 #include <string>
 #include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <random>
+#include <cmath>
+#include <thread>
+#include <chrono>
+#include <tuple>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
 #include "../include/utils/Timer.hpp"
 #include "../include/utils/Statistics.hpp"
+#include "../include/utils/LevelProfiler.hpp"
+#include "../include/utils/HugePageAllocator.hpp"
+#include "../include/utils/PerfCounters.hpp"
+#include "../include/utils/RadixSort.hpp"
+#include "../include/utils/IniFile.hpp"
+#include "../include/utils/CacheInfo.hpp"
+#include "../include/utils/MemoryCalibration.hpp"
+#include "../include/utils/BandwidthNoise.hpp"
+#include "../include/utils/SyntheticWork.hpp"
+#include "../include/utils/CacheSimulator.hpp"
 #include "../include/data/DataGenerator.hpp"
 #include "../include/data/SOSDDataLoader.hpp"
+#include "../include/data/SyntheticGenerator.hpp"
+#include "../include/data/QueryTrace.hpp"
 #include "../include/structures/btree/BTree.hpp"
 #include "../include/structures/btree/BTreeStatistics.hpp"
+#include "../include/structures/btree/BTreeSnapshot.hpp"
+#include "../include/structures/csbtree/CSBTree.hpp"
+#include "../include/structures/stree/STree.hpp"
+#include "../include/structures/array/SortedArray.hpp"
+#include "../include/structures/array/EytzingerArray.hpp"
+#include "../include/structures/learned/RMIIndex.hpp"
+#include "../include/structures/learned/PGMIndex.hpp"
+#include "../include/structures/art/ART.hpp"
+#include "../include/structures/compressed/CompressedBTree.hpp"
+#include "../include/structures/IndexStatistics.hpp"
 
 using namespace utils;
 using namespace data;
 using namespace structures:: btree;
+using namespace structures::csbtree;
+using namespace structures::stree;
+using namespace structures::array;
+using namespace structures::learned;
+using namespace structures::art;
+using namespace structures::compressed;
+using structures::IndexStatistics;
 
-// ==================== 辅助函数：测试特定 slot size ====================
+// ==================== 辅助函数：构建索引 ====================
 
-template<int SlotSize>
-BenchmarkResult test_with_slot_size(const std:: string& dataset_name,
-                                    const std::vector<uint64_t>& keys,
-                                    const std::vector<uint64_t>& queries) {
-    using BTree = typename CustomBTree<uint64_t, uint64_t, SlotSize, SlotSize>::type;
+/**
+ * 静态结构声明 bulk_load_only = true，只能从有序序列构建；
+ * 其余结构（STX B+ 树、ART）按原方式逐个 insert
+ */
+template<typename Index, typename = void>
+struct is_bulk_load_only : std::false_type {};
+
+template<typename Index>
+struct is_bulk_load_only<Index, std::void_t<decltype(Index::bulk_load_only)>>
+    : std::integral_constant<bool, Index::bulk_load_only> {};
+
+/**
+ * STX B+ 树提供 get_stats()，用 TreeStatistics 统计；其余结构用 IndexStatistics
+ */
+template<typename Index, typename = void>
+struct has_tree_stats : std::false_type {};
+
+template<typename Index>
+struct has_tree_stats<Index, std::void_t<decltype(std::declval<const Index&>().get_stats())>>
+    : std::true_type {};
+
+/**
+ * 构建索引，返回构建耗时（ms）
+ * bulk_load 构建前先排序 + 去重，这一阶段单独计时，写入 sort_ms（非空时）
+ */
+template<typename Index>
+double build_index(Index& index, const KeyVector& keys, double* sort_ms = nullptr) {
+    if constexpr (is_bulk_load_only<Index>::value) {
+        Timer sort_timer;
+        auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+        if (sort_ms) *sort_ms = sort_timer.elapsed_ms();
+        
+        Timer build_timer;
+        index.bulk_load(pairs.begin(), pairs.end());
+        return build_timer.elapsed_ms();
+    } else {
+        Timer build_timer;
+        
+        size_t count = 0;
+        for (const auto& key : keys) {
+            index.insert(std::make_pair(key, key));
+            count++;
+            if (count % 20'000'000 == 0) {
+                std::cout << "    Inserted " << count / 1'000'000 << "M keys..." << std::endl;
+            }
+        }
+        
+        return build_timer.elapsed_ms();
+    }
+}
+
+// ==================== 辅助函数：内存校准 ====================
+
+/**
+ * 测量访存延迟 / MLP / 带宽并存为本次运行的校准结果（--calibrate 或 calibrate 模式）
+ */
+void run_memory_calibration() {
+    OutputFormatter::print_header("Memory Calibration");
+    
+    CacheInfo cache = CacheInfo::detect();
+    std::cout << "\n  Pointer chase (random cycle over 64B lines), " << PageConfig::name(PageConfig::mode())
+              << " pages..." << std::endl;
     
+    MemoryCalibration::current() = MemoryCalibration::measure(cache);
+    MemoryCalibration::current()->print();
+}
+
+/**
+ * 查询延迟折合的 DRAM 缺失次数，没有校准时为 0
+ */
+inline double dram_equivalent(double ns) {
+    const auto& calibration = MemoryCalibration::current();
+    return calibration ? calibration->dram_equivalent(ns) : 0.0;
+}
+
+// ==================== 辅助函数：测试特定 slot size ====================
+
+template<typename BTree>
+BenchmarkResult run_index_benchmark(const std::string& test_name,
+                                   const KeyVector& keys,
+                                   const KeyVector& queries) {
     BenchmarkResult result;
-    result.test_name = dataset_name + " [Slot=" + std::to_string(SlotSize) + "]";
+    result.test_name = test_name;
     result.data_size = keys.size();
     result.query_count = queries.size();
     
     std::cout << "\n  ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
-    std::cout << "  Testing Slot Size: " << SlotSize << std::endl;
+    std::cout << "  Testing: " << test_name << std::endl;
     std::cout << "  ━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
     
     // 构建 B+ 树
     BTree btree;
-    Timer build_timer;
-    
-    size_t count = 0;
-    for (const auto& key : keys) {
-        btree.insert(std::make_pair(key, key));
-        count++;
-        if (count % 20'000'000 == 0) {
-            std::cout << "    Inserted " << count / 1'000'000 << "M keys..." << std::endl;
-        }
-    }
-    
-    result.build_time_ms = build_timer.elapsed_ms();
+    result.build_time_ms = build_index(btree, keys, &result.sort_time_ms);
     result.insert_throughput = (keys.size() / result.build_time_ms) * 1000.0 / 1e6;
     
     // 执行查询
@@ -64,6 +168,7 @@ BenchmarkResult test_with_slot_size(const std:: string& dataset_name,
     result.query_time_ms = query_timer.elapsed_ms();
     result.search_throughput = (queries.size() / result.query_time_ms) * 1000.0 / 1e6;
     result.avg_latency_ns = (result.query_time_ms * 1e6) / queries.size();
+    result.dram_equivalent = dram_equivalent(result.avg_latency_ns);
     result.hits = found;
     result.hit_rate = (found * 100.0) / queries.size();
     
@@ -73,22 +178,41 @@ BenchmarkResult test_with_slot_size(const std:: string& dataset_name,
     std::cout << "    Query Time:         " << result.query_time_ms << " ms" << std:: endl;
     std::cout << "    Avg Latency:         " << result.avg_latency_ns << " ns/query" << std::endl;
     std::cout << "    Query Throughput:   " << result.search_throughput << " M ops/s" << std::endl;
+    if (result.dram_equivalent > 0) {
+        std::cout << "    DRAM Misses Eq.:    " << result.dram_equivalent << " per lookup" << std::endl;
+    }
     
     return result;
 }
 
+/**
+ * 按结构名选择树实现：stx（默认）或 csb
+ */
+template<int SlotSize>
+BenchmarkResult test_with_slot_size(const std:: string& dataset_name,
+                                    const KeyVector& keys,
+                                    const KeyVector& queries,
+                                    const std::string& structure = "stx") {
+    std::string test_name = dataset_name + " [" + structure + " Slot=" + std::to_string(SlotSize) + "]";
+    
+    if (structure == "csb") {
+        using Tree = typename CustomCSBTree<uint64_t, uint64_t, SlotSize, SlotSize>::type;
+        return run_index_benchmark<Tree>(test_name, keys, queries);
+    }
+    
+    using Tree = typename CustomBTree<uint64_t, uint64_t, SlotSize, SlotSize>::type;
+    return run_index_benchmark<Tree>(test_name, keys, queries);
+}
+
 // ==================== Slot Size 对比测试 ====================
 
-void compare_slot_sizes(const std::string& dataset_name, size_t query_count = 10'000'000) {
-    OutputFormatter::print_header("B+ Tree Slot Size Comparison - " + dataset_name);
+void compare_slot_sizes(const std::string& dataset_name, const std::string& structure = "stx",
+                        size_t query_count = 10'000'000) {
+    OutputFormatter::print_header("B+ Tree Slot Size Comparison - " + dataset_name + " (" + structure + ")");
     
     // 1. 加载数据
     std::cout << "\n[1] Loading Data..." << std::endl;
-    std::string data_file = "data/" + dataset_name;
-    if (data_file.find("_uint64") == std::string::npos) {
-        data_file += "_uint64";
-    }
-    
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
     auto keys = SOSDDataLoader::load_binary_file(data_file);
     if (keys.empty()) {
         std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
@@ -100,7 +224,8 @@ void compare_slot_sizes(const std::string& dataset_name, size_t query_count = 10
     std::cout << "\n[2] Generating Queries..." << std::endl;
     query_count = std::min(query_count, keys.size());
     auto queries = SOSDDataLoader::generate_queries(keys, query_count);
-    std::cout << "    ✓ Generated " << queries.size() << " queries" << std::endl;
+    std::cout << "    ✓ Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
     
     // 3. 测试多种 slot 配置
     std::cout << "\n[3] Testing Different Slot Sizes..." << std::endl;
@@ -109,35 +234,35 @@ void compare_slot_sizes(const std::string& dataset_name, size_t query_count = 10
     std::vector<int> slot_sizes;
     
     // 测试各种 slot size（通过模板展开）
-    results.push_back(test_with_slot_size<16>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<16>(dataset_name, keys, queries, structure));
     slot_sizes.push_back(16);
     
-    results.push_back(test_with_slot_size<24>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<24>(dataset_name, keys, queries, structure));
     slot_sizes.push_back(24);
     
-    results.push_back(test_with_slot_size<32>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<32>(dataset_name, keys, queries, structure));
     slot_sizes.push_back(32);
     
-    results.push_back(test_with_slot_size<40>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<40>(dataset_name, keys, queries, structure));
     slot_sizes.push_back(40);
     
-    results.push_back(test_with_slot_size<48>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<48>(dataset_name, keys, queries, structure));
     slot_sizes.push_back(48);
     
-    results.push_back(test_with_slot_size<56>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<56>(dataset_name, keys, queries, structure));
     slot_sizes.push_back(56);
     
-    results.push_back(test_with_slot_size<64>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<64>(dataset_name, keys, queries, structure));
     slot_sizes.push_back(64);
     
-    results.push_back(test_with_slot_size<80>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<80>(dataset_name, keys, queries, structure));
     slot_sizes.push_back(80);
     
     // 4. 汇总对比
     std::cout << "\n" << std::endl;
     OutputFormatter::print_header("Performance Summary");
     
-    std::cout << "\n  Dataset: " << dataset_name << std::endl;
+    std::cout << "\n  Dataset: " << dataset_name << " | Structure: " << structure << std::endl;
     std::cout << "  Total Keys: " << keys.size() << " | Query Count: " << queries.size() << std::endl;
     
     std::cout << "\n  ╔═══════════════════════════════════════════════════════════════════╗" << std::endl;
@@ -205,179 +330,3747 @@ void compare_slot_sizes(const std::string& dataset_name, size_t query_count = 10
     std::cout << std::endl;
 }
 
-// ==================== 单个数据集测试 ====================
+// ==================== 数组基线对比测试 ====================
 
-BenchmarkResult test_sosd_dataset(const std::string& dataset_name, size_t query_count = 10'000'000) {
-    BenchmarkResult result;
-    result.test_name = dataset_name;
-    
-    OutputFormatter::print_header("Test:  SOSD Dataset - " + dataset_name);
+/**
+ * Eytzinger 布局 vs 有序数组 std::lower_bound vs 所有 CustomBTree slot size
+ */
+void compare_array_baselines(const std::string& dataset_name, size_t query_count = 10'000'000) {
+    OutputFormatter::print_header("Eytzinger Baseline Comparison - " + dataset_name);
     
     // 1. 加载数据
-    OutputFormatter::print_subheader("[1] Loading Data");
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    
+    // 2. 生成查询
+    std::cout << "\n[2] Generating Queries..." << std::endl;
+    query_count = std::min(query_count, keys.size());
+    auto queries = SOSDDataLoader::generate_queries(keys, query_count);
+    std::cout << "    ✓ Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+    
+    // 3. 测试各结构
+    std::cout << "\n[3] Testing Structures..." << std::endl;
+    
+    std::vector<BenchmarkResult> results;
+    
+    results.push_back(run_index_benchmark<SortedArray64>("std::lower_bound", keys, queries));
+    results.push_back(run_index_benchmark<Eytzinger64NoPrefetch>("Eytzinger", keys, queries));
+    results.push_back(run_index_benchmark<Eytzinger64>("Eytzinger+Prefetch", keys, queries));
+    
+    results.push_back(test_with_slot_size<16>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<24>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<32>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<40>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<48>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<56>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<64>(dataset_name, keys, queries));
+    results.push_back(test_with_slot_size<80>(dataset_name, keys, queries));
+    
+    // 4. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Baseline Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << std::endl;
+    std::cout << "  Total Keys: " << keys.size() << " | Query Count: " << queries.size() << std::endl;
     
-    std::string data_file = "data/" + dataset_name;
-    if (data_file. find("_uint64") == std::string::npos) {
-        data_file += "_uint64";
+    size_t best = 0;
+    for (size_t i = 1; i < results.size(); ++i) {
+        if (results[i].avg_latency_ns < results[best].avg_latency_ns) best = i;
     }
     
-    auto keys = SOSDDataLoader:: load_binary_file(data_file);
+    std::cout << "\n  ╔══════════════════════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Structure                        Build(ms)   Latency(ns)   Throughput(Mops)     ║" << std::endl;
+    std::cout << "  ╠══════════════════════════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        std::string name = r.test_name;
+        if (name.rfind(dataset_name + " ", 0) == 0) name = name.substr(dataset_name.size() + 1);
+        
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::left << std::setw(30) << name << std::right
+                  << std::setw(12) << r.build_time_ms
+                  << std::setw(14) << r.avg_latency_ns
+                  << std::setw(19) << r.search_throughput
+                  << (i == best ? "  ⭐ ║" : "     ║") << std::endl;
+    }
+    
+    std::cout << "  ╚══════════════════════════════════════════════════════════════════════════════════╝" << std::endl;
+    
+    std::cout << "\n  Eytzinger+Prefetch vs std::lower_bound: "
+              << std::fixed << std::setprecision(2)
+              << (results[0].avg_latency_ns / results[2].avg_latency_ns) << "x" << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 批量插入对比测试 ====================
+
+/**
+ * 在预构建的树上对比逐个 insert() 与 insert_batch()
+ * 每个批次大小都从同一棵 bulk_load 的基础树开始，保证公平
+ */
+void compare_batch_insert(const std::string& dataset_name) {
+    OutputFormatter::print_header("Batch Insert vs Per-Key Insert - " + dataset_name);
     
+    // 1. 加载数据
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
     if (keys.empty()) {
-        OutputFormatter::print_error("Failed to load:   " + data_file);
-        result.data_size = 0;
-        return result;
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
     }
+    auto base = SOSDDataLoader::to_sorted_pairs(keys);
+    std::cout << "    ✓ Base tree: " << base.size() << " unique keys" << std::endl;
     
-    std::cout << "    Loaded " << keys.size() << " keys" << std::endl;
-    result.data_size = keys.size();
-    result.query_count = std::min(query_count, keys.size());
+    // 2. 逐个批次大小测试
+    std::cout << "\n[2] Inserting Batches..." << std::endl;
     
-    // 2. 生成查询
-    OutputFormatter::print_subheader("[2] Generating Queries");
-    auto queries = SOSDDataLoader::generate_queries(keys, result.query_count);
-    std::cout << "    Generated " << queries.size() << " queries" << std::endl;
+    const size_t batch_sizes[] = {1'000, 10'000, 100'000, 1'000'000, 10'000'000};
     
-    // 3. 构建 B+ 树（使用默认配置）
-    OutputFormatter::print_subheader("[3] Building B+ Tree (Default:  16 slots)");
-    BTree64 btree;
+    struct BatchResult {
+        size_t batch_size;
+        size_t inserted;
+        double single_ms;
+        double batch_ms;
+    };
+    std::vector<BatchResult> results;
     
-    Timer build_timer;
-    size_t count = 0;
-    for (const auto& key :  keys) {
-        btree.insert(std::make_pair(key, key));
+    for (size_t batch_size : batch_sizes) {
+        auto batch = SOSDDataLoader::generate_insert_batch(keys, batch_size);
+        BatchResult r{batch_size, 0, 0, 0};
+        
+        std::cout << "\n  ━━━ Batch Size: " << batch_size << " ━━━" << std::endl;
+        
+        {
+            BTree64 btree;
+            btree.bulk_load(base.begin(), base.end());
+            
+            Timer timer;
+            size_t inserted = 0;
+            for (const auto& kv : batch) {
+                if (btree.insert(kv).second) inserted++;
+            }
+            r.single_ms = timer.elapsed_ms();
+            r.inserted = inserted;
+        }
         
-        count++;
-        if (count % 20'000'000 == 0) {
-            std::cout << "    Inserted " << count / 1'000'000 << "M keys..." << std::endl;
+        {
+            BTree64 btree;
+            btree.bulk_load(base.begin(), base.end());
+            
+            Timer timer;
+            size_t inserted = btree.insert_batch(batch.begin(), batch.end());
+            r.batch_ms = timer.elapsed_ms();
+            
+            if (inserted != r.inserted) {
+                OutputFormatter::print_error("Inserted count mismatch: " + std::to_string(inserted) +
+                                             " vs " + std::to_string(r.inserted));
+            }
         }
+        
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "    Per-Key Insert:     " << r.single_ms << " ms" << std::endl;
+        std::cout << "    Batch Insert:       " << r.batch_ms << " ms" << std::endl;
+        std::cout << "    New Keys:           " << r.inserted << std::endl;
+        
+        results.push_back(r);
     }
-    double build_time_ms = build_timer.elapsed_ms();
     
-    result.build_time_ms = build_time_ms;
-    result.insert_throughput = (keys.size() / build_time_ms) * 1000.0 / 1e6;
+    // 3. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Batch Insert Summary");
     
-    std::cout << std::fixed << std::setprecision(2);
-    std::cout << "    Build Time:  " << build_time_ms << " ms" << std::endl;
-    std::cout << "    Insert Throughput: " << result.insert_throughput << " M ops/s" << std::endl;
+    std::cout << "\n  Dataset: " << dataset_name << " | Base Keys: " << base.size() << std::endl;
+    
+    std::cout << "\n  ╔═════════════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║     Batch   PerKey(ms)   Batch(ms)   PerKey(Mops)  Batch(Mops)  Speedup ║" << std::endl;
+    std::cout << "  ╠═════════════════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    for (const auto& r : results) {
+        double single_mops = (r.batch_size / r.single_ms) * 1000.0 / 1e6;
+        double batch_mops = (r.batch_size / r.batch_ms) * 1000.0 / 1e6;
+        
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::setw(8) << r.batch_size
+                  << std::setw(13) << r.single_ms
+                  << std::setw(12) << r.batch_ms
+                  << std::setw(15) << single_mops
+                  << std::setw(13) << batch_mops
+                  << std::setw(8) << (r.single_ms / r.batch_ms) << "x ║" << std::endl;
+    }
+    
+    std::cout << "  ╚═════════════════════════════════════════════════════════════════════════╝" << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 基数表下降对比测试 ====================
+
+/**
+ * 在同一棵 bulk_load 的 BTree64 上比较不同 bits / depth 的基数表，
+ * 报告每次查询节省的时间和表大小
+ */
+void compare_radix_table(const std::string& dataset_name, size_t query_count = 10'000'000) {
+    OutputFormatter::print_header("Radix Table Descent - " + dataset_name);
+    
+    // 1. 加载数据
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    
+    // 2. 生成查询
+    std::cout << "\n[2] Generating Queries..." << std::endl;
+    query_count = std::min(query_count, keys.size());
+    auto queries = SOSDDataLoader::generate_queries(keys, query_count);
+    std::cout << "    ✓ Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
     
-    // 4. 树统计
-    OutputFormatter::print_subheader("[4] Tree Structure");
-    auto tree_stats = TreeStatistics:: collect(btree);
+    // 3. 构建树
+    std::cout << "\n[3] Building BTree64..." << std::endl;
+    BTree64 btree;
+    {
+        auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+        btree.bulk_load(pairs.begin(), pairs.end());
+    }
+    auto tree_stats = TreeStatistics::collect(btree);
     tree_stats.print();
     
-    // 5. 执行查询
-    OutputFormatter::print_subheader("[5] Running Queries");
+    // 4. 逐个配置测试
+    std::cout << "\n[4] Running Queries..." << std::endl;
     
-    Timer query_timer;
-    size_t found = 0;
+    struct RadixResult {
+        unsigned bits;
+        unsigned depth;
+        size_t table_bytes;
+        double skipped_levels;
+        double avg_latency_ns;
+    };
+    std::vector<RadixResult> results;
     
-    for (const auto& q :  queries) {
-        auto it = btree.find(q);
-        if (it != btree. end()) {
-            found++;
+    auto run_queries = [&](unsigned bits, unsigned depth) {
+        if (bits == 0) {
+            btree.disable_radix_table();
+        } else {
+            btree.enable_radix_table(bits, depth);
+        }
+        
+        // 表在 enable_radix_table() 中构建，不计入查找时间
+        RadixResult r{bits, depth, btree.radix_table_bytes(), btree.radix_avg_skipped_levels(), 0};
+        
+        Timer timer;
+        size_t found = 0;
+        for (const auto& q : queries) {
+            if (btree.find(q) != btree.end()) found++;
+        }
+        r.avg_latency_ns = (timer.elapsed_ms() * 1e6) / queries.size();
+        
+        if (found != queries.size()) {
+            OutputFormatter::print_error("Missing keys: " + std::to_string(queries.size() - found));
+        }
+        
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "    bits=" << std::setw(2) << bits << " depth=" << depth
+                  << "  " << r.avg_latency_ns << " ns/query" << std::endl;
+        results.push_back(r);
+    };
+    
+    run_queries(0, 0);
+    
+    const unsigned depths[] = {1, 2, 3};
+    const unsigned bit_counts[] = {8, 12, 16, 20, 24};
+    
+    for (unsigned depth : depths) {
+        for (unsigned bits : bit_counts) {
+            run_queries(bits, depth);
         }
     }
     
-    double query_time_ms = query_timer.elapsed_ms();
+    // 5. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Radix Table Summary");
     
-    result.query_time_ms = query_time_ms;
-    result.search_throughput = (queries.size() / query_time_ms) * 1000.0 / 1e6;
-    result.avg_latency_ns = (query_time_ms * 1e6) / queries.size();
-    result.hits = found;
-    result.hit_rate = (found * 100.0) / queries.size();
+    std::cout << "\n  Dataset: " << dataset_name << " | Leaves: " << tree_stats.leaf_nodes
+              << " | Inner Nodes: " << tree_stats.inner_nodes << std::endl;
     
-    std::cout << "\n  ┌─ Query Performance ─────────────────────" << std::endl;
-    std::cout << "  │ Total Time:       " << query_time_ms << " ms" << std::endl;
-    std::cout << "  │ Query Count:      " << queries.size() << std::endl;
-    std::cout << "  │ Throughput:       " << result.search_throughput << " M ops/s" << std::endl;
-    std::cout << "  │ Avg Latency:      " << result.avg_latency_ns << " ns/query" << std::endl;
-    std::cout << "  │ Hit Rate:         " << result.hit_rate << " %" << std::endl;
-    std::cout << "  │ Hits:             " << found << " / " << queries.size() << std::endl;
-    std::cout << "  └─────────────────────────────────────────" << std::endl;
+    const double baseline = results.front().avg_latency_ns;
     
-    std::cout << "\n  Verification:   " << (found > 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+    std::cout << "\n  ╔════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Bits  Depth   Table(KB)   Skipped   Latency(ns)   Saving(ns)  ║" << std::endl;
+    std::cout << "  ╠════════════════════════════════════════════════════════════════╣" << std::endl;
     
-    return result;
+    for (const auto& r : results) {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::setw(4) << (r.bits ? std::to_string(r.bits) : "off")
+                  << std::setw(7) << (r.bits ? std::to_string(r.depth) : "-")
+                  << std::setw(12) << r.table_bytes / 1024.0
+                  << std::setw(10) << r.skipped_levels
+                  << std::setw(14) << r.avg_latency_ns
+                  << std::setw(13) << (baseline - r.avg_latency_ns) << "  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚════════════════════════════════════════════════════════════════╝" << std::endl;
+    std::cout << std::endl;
 }
 
-// ==================== 主程序 ====================
+// ==================== 按层耗时分解测试 ====================
 
-int main(int argc, char* argv[]) {
-    OutputFormatter::print_header("B+ Tree Performance Benchmark Framework");
+struct LevelProfile {
+    int slot_size;
+    std::vector<double> cycles;   // 每层平均 cycles，下标 0 为根
+    double total_cycles;
+    double plain_latency_ns;      // 不插桩 find() 的平均延迟，作参考
+};
+
+/**
+ * 用 find_visit() + LevelProfiler 统计指定 slot size 的每层查找耗时
+ */
+template<int SlotSize>
+LevelProfile profile_levels(const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                            const KeyVector& queries) {
+    using Tree = typename CustomBTree<uint64_t, uint64_t, SlotSize, SlotSize>::type;
     
-    std::cout << "\n  SOSD B+ Tree (STX) Performance Testing" << std::endl;
-    std::cout << "  Default Slot Size: 16" << std::endl;
-    std::cout << "  ────────────────────────────────────────" << std::endl;
+    std::cout << "\n  ━━━ Slot Size: " << SlotSize << " ━━━" << std::endl;
     
-    if (argc > 1) {
-        std::string arg = argv[1];
+    Tree btree;
+    btree.bulk_load(pairs.begin(), pairs.end());
+    
+    LevelProfile profile{SlotSize, {}, 0.0, 0.0};
+    
+    Timer timer;
+    size_t found = 0;
+    for (const auto& q : queries) {
+        if (btree.find(q) != btree.end()) found++;
+    }
+    profile.plain_latency_ns = (timer.elapsed_ms() * 1e6) / queries.size();
+    
+    LevelProfiler profiler;
+    size_t found_visit = 0;
+    for (const auto& q : queries) {
+        if (btree.find_visit(q, profiler) != btree.end()) found_visit++;
+    }
+    
+    if (found_visit != found) {
+        OutputFormatter::print_error("find_visit() hit count mismatch");
+    }
+    
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t level = 0; level < profiler.levels(); ++level) {
+        profile.cycles.push_back(profiler.avg_cycles(level));
+        profile.total_cycles += profile.cycles.back();
         
-        // 生成数据
-        if (arg == "generate") {
-            if (argc < 4) {
-                std::cout << "\n  Usage: ./prefetch_bench generate <size> <type>" << std::endl;
-                std::cout << "  Types: random, sorted, partial" << std::endl;
-                std::cout << "  Example: ./prefetch_bench generate 200000000 random" << std::endl;
-                return 1;
-            }
-            
-            size_t size = std::stoull(argv[2]);
-            std::string type = argv[3];
-            std::string filename = "data/custom_" + type + "_" + std::to_string(size) + "_uint64";
-            
-            std:: cout << "\n  Generating custom dataset..." << std::endl;
-            
-            if (type == "random") {
-                DataGenerator::generate_and_save_random(size, filename);
-            } else if (type == "sorted") {
-                DataGenerator::generate_and_save_sorted(size, filename);
-            } else if (type == "partial") {
-                DataGenerator::generate_and_save_partial(size, filename);
-            } else {
-                std::cerr << "  Unknown type: " << type << std:: endl;
-                return 1;
-            }
-            
-            std::cout << "  ✓ Dataset generated successfully!" << std::endl;
-            std::cout << "\n  To test it:" << std::endl;
-            std::cout << "    ./prefetch_bench custom_" << type << "_" << size << std::endl;
-            std::cout << "  To compare slot sizes:" << std::endl;
-            std::cout << "    ./prefetch_bench compare custom_" << type << "_" << size << std::endl;
-            
-            return 0;
+        std::cout << "    L" << level << (level + 1 == profiler.levels() ? " (leaf)" : "       ")
+                  << std::setw(10) << profile.cycles.back() << " cycles" << std::endl;
+    }
+    std::cout << "    Total    " << std::setw(10) << profile.total_cycles << " cycles"
+              << "  (rdtsc overhead " << profiler.overhead_cycles() << " / level removed)" << std::endl;
+    std::cout << "    find()   " << std::setw(10) << profile.plain_latency_ns << " ns" << std::endl;
+    
+    return profile;
+}
+
+/**
+ * 逐个 slot size 统计每层查找耗时，看 cache miss 落在哪一层
+ */
+void compare_level_cycles(const std::string& dataset_name, size_t query_count = 10'000'000) {
+    OutputFormatter::print_header("Per-Level Lookup Cycles - " + dataset_name);
+    
+    // 1. 加载数据
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+    
+    // 2. 生成查询
+    std::cout << "\n[2] Generating Queries..." << std::endl;
+    query_count = std::min(query_count, keys.size());
+    auto queries = SOSDDataLoader::generate_queries(keys, query_count);
+    std::cout << "    ✓ Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+    
+    // 3. 逐个 slot size 测试（bulk_load 构建）
+    std::cout << "\n[3] Profiling Lookups..." << std::endl;
+    
+    std::vector<LevelProfile> profiles;
+    profiles.push_back(profile_levels<16>(pairs, queries));
+    profiles.push_back(profile_levels<24>(pairs, queries));
+    profiles.push_back(profile_levels<32>(pairs, queries));
+    profiles.push_back(profile_levels<40>(pairs, queries));
+    profiles.push_back(profile_levels<48>(pairs, queries));
+    profiles.push_back(profile_levels<56>(pairs, queries));
+    profiles.push_back(profile_levels<64>(pairs, queries));
+    profiles.push_back(profile_levels<80>(pairs, queries));
+    
+    // 4. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Per-Level Cycles Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Query Count: " << queries.size() << std::endl;
+    
+    size_t max_levels = 0;
+    for (const auto& p : profiles) max_levels = std::max(max_levels, p.cycles.size());
+    
+    // 列数随树高变化，边框宽度按列数计算
+    size_t width = 2 + 4 + 9 * max_levels + 10 + 11 + 2;
+    std::string bar;
+    for (size_t i = 0; i < width; ++i) bar += "═";
+    
+    std::cout << "\n  ╔" << bar << "╗" << std::endl;
+    std::cout << "  ║  Slot";
+    for (size_t level = 0; level < max_levels; ++level) {
+        std::cout << std::setw(9) << ("L" + std::to_string(level));
+    }
+    std::cout << std::setw(10) << "Total" << std::setw(11) << "find(ns)" << "  ║" << std::endl;
+    std::cout << "  ╠" << bar << "╣" << std::endl;
+    
+    for (const auto& p : profiles) {
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "  ║  " << std::setw(4) << p.slot_size;
+        for (size_t level = 0; level < max_levels; ++level) {
+            if (level < p.cycles.size()) {
+                std::cout << std::setw(9) << p.cycles[level];
+            } else {
+                std::cout << std::setw(9) << "-";
+            }
+        }
+        std::cout << std::setw(10) << p.total_cycles
+                  << std::setw(11) << p.plain_latency_ns << "  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚" << bar << "╝" << std::endl;
+    std::cout << "\n  Cycles per lookup and level, L0 = root; the last level of each row is the leaf." << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 插入构建 vs 批量构建对比测试 ====================
+
+struct BuildFillResult {
+    std::string build;
+    int slot_size;
+    TreeStatistics stats;
+    double build_time_ms;
+    double avg_latency_ns;
+};
+
+/**
+ * 同一 slot size 分别用逐个插入和 bulk_load 构建，比较填充率、内存和查询延迟
+ */
+template<int SlotSize>
+void compare_build_fill_for_slot(std::vector<BuildFillResult>& results,
+                                 const KeyVector& keys,
+                                 const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                                 const KeyVector& queries) {
+    using Tree = typename CustomBTree<uint64_t, uint64_t, SlotSize, SlotSize>::type;
+    
+    auto measure = [&](const std::string& build, Tree& btree, double build_time_ms) {
+        BuildFillResult r{build, SlotSize, TreeStatistics::collect(btree), build_time_ms, 0.0};
+        
+        std::cout << "\n  ━━━ Slot Size: " << SlotSize << " | " << build << " ━━━" << std::endl;
+        r.stats.print();
+        
+        Timer timer;
+        size_t found = 0;
+        for (const auto& q : queries) {
+            if (btree.find(q) != btree.end()) found++;
+        }
+        r.avg_latency_ns = (timer.elapsed_ms() * 1e6) / queries.size();
+        
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "    Avg Latency: " << r.avg_latency_ns << " ns/query"
+                  << " | Hits: " << found << " / " << queries.size() << std::endl;
+        results.push_back(r);
+    };
+    
+    {
+        Tree btree;
+        double build_time_ms = build_index(btree, keys);
+        measure("insert", btree, build_time_ms);
+    }
+    
+    {
+        Tree btree;
+        Timer timer;
+        btree.bulk_load(pairs.begin(), pairs.end());
+        measure("bulk", btree, timer.elapsed_ms());
+    }
+}
+
+void compare_build_fill(const std::string& dataset_name, size_t query_count = 10'000'000) {
+    OutputFormatter::print_header("Insert-Built vs Bulk-Loaded Trees - " + dataset_name);
+    
+    // 1. 加载数据
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+    
+    // 2. 生成查询
+    std::cout << "\n[2] Generating Queries..." << std::endl;
+    query_count = std::min(query_count, keys.size());
+    auto queries = SOSDDataLoader::generate_queries(keys, query_count);
+    std::cout << "    ✓ Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+    
+    // 3. 构建并测试
+    std::cout << "\n[3] Building Trees..." << std::endl;
+    
+    std::vector<BuildFillResult> results;
+    compare_build_fill_for_slot<16>(results, keys, pairs, queries);
+    compare_build_fill_for_slot<32>(results, keys, pairs, queries);
+    compare_build_fill_for_slot<64>(results, keys, pairs, queries);
+    
+    // 4. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Build Fill Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Keys: " << keys.size()
+              << " | Query Count: " << queries.size() << std::endl;
+    
+    std::cout << "\n  ╔═════════════════════════════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Slot   Build   Height   Leaf%   Inner%   Memory(MB)   B/Key   Build(ms)   Latency(ns)  ║" << std::endl;
+    std::cout << "  ╠═════════════════════════════════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    for (const auto& r : results) {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::setw(4) << r.slot_size
+                  << std::setw(8) << r.build
+                  << std::setw(9) << r.stats.height
+                  << std::setw(8) << r.stats.leaf_fill * 100.0
+                  << std::setw(9) << r.stats.inner_fill * 100.0
+                  << std::setw(13) << r.stats.memory_bytes / (1024.0 * 1024.0)
+                  << std::setw(8) << r.stats.bytes_per_key()
+                  << std::setw(12) << r.build_time_ms
+                  << std::setw(14) << r.avg_latency_ns << "  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚═════════════════════════════════════════════════════════════════════════════════════════╝" << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 软件流水查找测试 ====================
+
+/**
+ * 软件流水查找：处理第 i 个查询时，预取第 i + distance 个查询的目标叶子
+ * distance = 0 即普通 find() 循环
+ */
+template<typename Tree>
+double run_pipelined_lookups(const Tree& btree, const KeyVector& queries, size_t distance,
+                             size_t& found) {
+    const size_t n = queries.size();
+    found = 0;
+    
+    Timer timer;
+    for (size_t i = 0; i < n; ++i) {
+        if (distance && i + distance < n) {
+            btree.prefetch_leaf(queries[i + distance]);
+        }
+        if (btree.find(queries[i]) != btree.end()) found++;
+    }
+    
+    return (timer.elapsed_ms() * 1e6) / n;
+}
+
+struct PipelineResult {
+    int slot_size;
+    double baseline_ns;
+    size_t best_distance;
+    double best_ns;
+};
+
+/**
+ * 对指定 slot size 扫描预取距离，distances 为空时使用默认扫描范围
+ */
+template<int SlotSize>
+PipelineResult sweep_prefetch_distance(const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                                       const KeyVector& queries,
+                                       const std::vector<size_t>& distances) {
+    using Tree = typename CustomBTree<uint64_t, uint64_t, SlotSize, SlotSize>::type;
+    
+    std::cout << "\n  ━━━ Slot Size: " << SlotSize << " ━━━" << std::endl;
+    
+    Tree btree;
+    btree.bulk_load(pairs.begin(), pairs.end());
+    
+    size_t found = 0;
+    PipelineResult r{SlotSize, run_pipelined_lookups(btree, queries, 0, found), 0, 0.0};
+    r.best_ns = r.baseline_ns;
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    D = " << std::setw(3) << 0 << "  " << std::setw(9) << r.baseline_ns
+              << " ns/query  (no prefetch)" << std::endl;
+    
+    for (size_t distance : distances) {
+        size_t hits = 0;
+        double ns = run_pipelined_lookups(btree, queries, distance, hits);
+        
+        if (hits != found) {
+            OutputFormatter::print_error("Hit count mismatch at D = " + std::to_string(distance));
+        }
+        
+        std::cout << "    D = " << std::setw(3) << distance << "  " << std::setw(9) << ns
+                  << " ns/query  " << (r.baseline_ns / ns) << "x" << std::endl;
+        
+        if (ns < r.best_ns) {
+            r.best_ns = ns;
+            r.best_distance = distance;
+        }
+    }
+    
+    return r;
+}
+
+/**
+ * 软件流水查找：distance 为 0 时自动扫描预取距离，否则只测该距离
+ */
+void compare_prefetch_distance(const std::string& dataset_name, size_t distance = 0,
+                               size_t query_count = 10'000'000) {
+    OutputFormatter::print_header("Software-Pipelined Lookups - " + dataset_name);
+    
+    // 1. 加载数据
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+    
+    // 2. 生成查询
+    std::cout << "\n[2] Generating Queries..." << std::endl;
+    query_count = std::min(query_count, keys.size());
+    auto queries = SOSDDataLoader::generate_queries(keys, query_count);
+    std::cout << "    ✓ Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+    
+    // 3. 逐个 slot size 扫描预取距离（bulk_load 构建）
+    std::cout << "\n[3] Sweeping Prefetch Distance..." << std::endl;
+    
+    std::vector<size_t> distances;
+    if (distance > 0) {
+        distances.push_back(distance);
+    } else {
+        distances = {1, 2, 4, 6, 8, 12, 16, 24, 32, 48, 64};
+    }
+    
+    std::vector<PipelineResult> results;
+    results.push_back(sweep_prefetch_distance<16>(pairs, queries, distances));
+    results.push_back(sweep_prefetch_distance<32>(pairs, queries, distances));
+    results.push_back(sweep_prefetch_distance<64>(pairs, queries, distances));
+    
+    // 4. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Prefetch Distance Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Query Count: " << queries.size() << std::endl;
+    
+    std::cout << "\n  ╔═════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Slot   Baseline(ns)   Best D   Best(ns)   Speedup  ║" << std::endl;
+    std::cout << "  ╠═════════════════════════════════════════════════════╣" << std::endl;
+    
+    for (const auto& r : results) {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::setw(4) << r.slot_size
+                  << std::setw(15) << r.baseline_ns
+                  << std::setw(9) << r.best_distance
+                  << std::setw(11) << r.best_ns
+                  << std::setw(9) << (r.baseline_ns / r.best_ns) << "x  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚═════════════════════════════════════════════════════╝" << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 预取策略对比测试 ====================
+
+/**
+ * 软件流水插入：插入第 i 个 key 时预取第 i + distance 个 key 的目标叶子
+ */
+template<typename Tree>
+double run_pipelined_inserts(Tree& btree, const std::vector<std::pair<uint64_t, uint64_t>>& batch,
+                             size_t distance) {
+    const size_t n = batch.size();
+    
+    Timer timer;
+    for (size_t i = 0; i < n; ++i) {
+        if (distance && i + distance < n) {
+            btree.prefetch_leaf(batch[i + distance].first);
+        }
+        btree.insert(batch[i]);
+    }
+    
+    return (timer.elapsed_ms() * 1e6) / n;
+}
+
+struct PolicyResult {
+    int slot_size;
+    std::string scope;
+    std::string hint;
+    double lookup_ns;
+    double insert_ns;
+};
+
+/**
+ * 用指定预取策略配置的树测试流水查找和流水插入
+ * Policy 为 void 时不预取（distance = 0），作为基线
+ */
+template<int SlotSize, typename Policy>
+PolicyResult measure_prefetch_policy(const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                                     const KeyVector& queries,
+                                     const std::vector<std::pair<uint64_t, uint64_t>>& batch,
+                                     size_t distance) {
+    constexpr bool baseline = std::is_void<Policy>::value;
+    using TreePolicy = std::conditional_t<baseline, DefaultPrefetchPolicy, Policy>;
+    using Tree = typename CustomBTree<uint64_t, uint64_t, SlotSize, SlotSize, TreePolicy>::type;
+    
+    PolicyResult r{SlotSize, baseline ? "-" : TreePolicy::scope_name(),
+                   baseline ? "none" : TreePolicy::hint_name(), 0.0, 0.0};
+    
+    Tree btree;
+    btree.bulk_load(pairs.begin(), pairs.end());
+    
+    size_t found = 0;
+    r.lookup_ns = run_pipelined_lookups(btree, queries, baseline ? 0 : distance, found);
+    r.insert_ns = run_pipelined_inserts(btree, batch, baseline ? 0 : distance);
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    " << std::left << std::setw(6) << r.scope << std::setw(6) << r.hint << std::right
+              << "  lookup " << std::setw(9) << r.lookup_ns << " ns"
+              << "  insert " << std::setw(9) << r.insert_ns << " ns" << std::endl;
+    
+    return r;
+}
+
+template<int SlotSize, PrefetchScope Scope>
+void measure_prefetch_hints(std::vector<PolicyResult>& results,
+                            const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                            const KeyVector& queries,
+                            const std::vector<std::pair<uint64_t, uint64_t>>& batch,
+                            size_t distance) {
+    results.push_back(measure_prefetch_policy<SlotSize, PrefetchPolicy<Scope, PrefetchHint::T0>>(pairs, queries, batch, distance));
+    results.push_back(measure_prefetch_policy<SlotSize, PrefetchPolicy<Scope, PrefetchHint::T1>>(pairs, queries, batch, distance));
+    results.push_back(measure_prefetch_policy<SlotSize, PrefetchPolicy<Scope, PrefetchHint::T2>>(pairs, queries, batch, distance));
+    results.push_back(measure_prefetch_policy<SlotSize, PrefetchPolicy<Scope, PrefetchHint::NTA>>(pairs, queries, batch, distance));
+    results.push_back(measure_prefetch_policy<SlotSize, PrefetchPolicy<Scope, PrefetchHint::W>>(pairs, queries, batch, distance));
+}
+
+template<int SlotSize>
+void measure_prefetch_policies(std::vector<PolicyResult>& results,
+                               const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                               const KeyVector& queries,
+                               const std::vector<std::pair<uint64_t, uint64_t>>& batch,
+                               size_t distance) {
+    std::cout << "\n  ━━━ Slot Size: " << SlotSize << " ━━━" << std::endl;
+    
+    results.push_back(measure_prefetch_policy<SlotSize, void>(pairs, queries, batch, distance));
+    measure_prefetch_hints<SlotSize, PrefetchScope::KeyArray>(results, pairs, queries, batch, distance);
+    measure_prefetch_hints<SlotSize, PrefetchScope::WholeNode>(results, pairs, queries, batch, distance);
+}
+
+/**
+ * 比较预取范围（key 数组 / 整个节点）和预取提示（T0/T1/T2/NTA/W）的组合
+ * 查找和插入都用距离为 distance 的软件流水循环
+ */
+void compare_prefetch_policies(const std::string& dataset_name, size_t distance = 16,
+                               size_t query_count = 10'000'000) {
+    OutputFormatter::print_header("Prefetch Policy Comparison - " + dataset_name);
+    
+    // 1. 加载数据
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+    
+    // 2. 生成查询和插入批次
+    std::cout << "\n[2] Generating Queries..." << std::endl;
+    query_count = std::min(query_count, keys.size());
+    auto queries = SOSDDataLoader::generate_queries(keys, query_count);
+    auto batch = SOSDDataLoader::generate_insert_batch(keys, std::max<size_t>(1, std::min<size_t>(1'000'000, keys.size() / 10)));
+    std::cout << "    ✓ Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages), "
+              << batch.size() << " inserts" << std::endl;
+    
+    // 3. 逐个策略测试
+    std::cout << "\n[3] Testing Policies (D = " << distance << ")..." << std::endl;
+    
+    std::vector<PolicyResult> results;
+    measure_prefetch_policies<16>(results, pairs, queries, batch, distance);
+    measure_prefetch_policies<64>(results, pairs, queries, batch, distance);
+    
+    // 4. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Prefetch Policy Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Query Count: " << queries.size()
+              << " | Inserts: " << batch.size() << " | D = " << distance << std::endl;
+    
+    std::cout << "\n  ╔════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Slot   Scope    Hint    Lookup(ns)    Insert(ns)  ║" << std::endl;
+    std::cout << "  ╠════════════════════════════════════════════════════╣" << std::endl;
+    
+    for (const auto& r : results) {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::setw(4) << r.slot_size
+                  << std::setw(8) << r.scope
+                  << std::setw(8) << r.hint
+                  << std::setw(14) << r.lookup_ns
+                  << std::setw(14) << r.insert_ns << "  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚════════════════════════════════════════════════════╝" << std::endl;
+    
+    // 每个 slot size 的最佳组合（第一行为不预取基线）
+    for (size_t begin = 0; begin < results.size(); ) {
+        size_t end = begin;
+        while (end < results.size() && results[end].slot_size == results[begin].slot_size) ++end;
+        
+        size_t best_lookup = begin, best_insert = begin;
+        for (size_t i = begin; i < end; ++i) {
+            if (results[i].lookup_ns < results[best_lookup].lookup_ns) best_lookup = i;
+            if (results[i].insert_ns < results[best_insert].insert_ns) best_insert = i;
+        }
+        
+        const auto& base = results[begin];
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "\n  Slot " << base.slot_size << ":" << std::endl;
+        std::cout << "    Best lookup policy: " << results[best_lookup].scope << " / " << results[best_lookup].hint
+                  << "  (" << (base.lookup_ns / results[best_lookup].lookup_ns) << "x vs no prefetch)" << std::endl;
+        std::cout << "    Best insert policy: " << results[best_insert].scope << " / " << results[best_insert].hint
+                  << "  (" << (base.insert_ns / results[best_insert].insert_ns) << "x vs no prefetch)" << std::endl;
+        
+        begin = end;
+    }
+    std::cout << std::endl;
+}
+
+// ==================== 叶子布局对比测试 ====================
+
+struct LayoutResult {
+    int slot_size;
+    std::string layout;
+    size_t leaf_bytes;
+    double build_ms;
+    double hit_ns;
+    double l1d_misses;
+    double llc_misses;
+    bool has_l1d;
+    bool has_llc;
+};
+
+inline const char* leaf_layout_name(int layout) {
+    switch (layout) {
+        case stx::btree_leaf_split:       return "split";
+        case stx::btree_leaf_interleaved: return "interleaved";
+        case stx::btree_leaf_blocked:     return "blocked";
+    }
+    return "?";
+}
+
+/**
+ * 用指定叶子布局的树做命中查找：每次命中都读 value，
+ * 这样 split 布局要多取一条 value 所在的 cache line，交错 / 分块布局则可能和 key 同一行
+ */
+template<int SlotSize, int Layout>
+LayoutResult measure_leaf_layout(const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                                 const KeyVector& queries) {
+    using Tree = typename CustomBTree<uint64_t, uint64_t, SlotSize, SlotSize,
+                                      DefaultPrefetchPolicy, Layout>::type;
+    
+    LayoutResult r{SlotSize, leaf_layout_name(Layout), Tree::leaf_node_bytes,
+                   0.0, 0.0, 0.0, 0.0, false, false};
+    
+    Tree btree;
+    Timer build_timer;
+    btree.bulk_load(pairs.begin(), pairs.end());
+    r.build_ms = build_timer.elapsed_ms();
+    
+    PerfCounters counters;
+    size_t hits = 0;
+    uint64_t checksum = 0;
+    
+    counters.start();
+    Timer timer;
+    for (uint64_t q : queries) {
+        auto it = btree.find(q);
+        if (it != btree.end()) {
+            checksum += it->second;
+            ++hits;
+        }
+    }
+    double elapsed_ms = timer.elapsed_ms();
+    counters.stop();
+    
+    r.hit_ns = hits ? (elapsed_ms * 1e6) / hits : 0.0;
+    r.has_l1d = counters.available(PerfCounters::L1DMiss);
+    r.has_llc = counters.available(PerfCounters::LLCMiss);
+    r.l1d_misses = static_cast<double>(counters.count(PerfCounters::L1DMiss)) / queries.size();
+    r.llc_misses = static_cast<double>(counters.count(PerfCounters::LLCMiss)) / queries.size();
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    " << std::left << std::setw(12) << r.layout << std::right
+              << "  leaf " << std::setw(5) << r.leaf_bytes << " B"
+              << "  hit " << std::setw(8) << r.hit_ns << " ns"
+              << "  (" << hits << " hits, checksum " << (checksum & 0xffff) << ")" << std::endl;
+    
+    return r;
+}
+
+template<int SlotSize>
+void measure_leaf_layouts(std::vector<LayoutResult>& results,
+                          const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                          const KeyVector& queries) {
+    std::cout << "\n  ━━━ Slot Size: " << SlotSize << " ━━━" << std::endl;
+    
+    results.push_back(measure_leaf_layout<SlotSize, stx::btree_leaf_split>(pairs, queries));
+    results.push_back(measure_leaf_layout<SlotSize, stx::btree_leaf_interleaved>(pairs, queries));
+    results.push_back(measure_leaf_layout<SlotSize, stx::btree_leaf_blocked>(pairs, queries));
+}
+
+/**
+ * 比较叶子中 key / value 的三种排布：split（key 数组 + value 数组）、
+ * interleaved（(key, value) 交错）、blocked（8 个 key + 8 个 value 一块）
+ * 报告每次命中的延迟和每次查找的 L1D / LLC 缺失数（perf 不可用时为 n/a）
+ */
+void compare_leaf_layouts(const std::string& dataset_name, size_t query_count = 10'000'000) {
+    OutputFormatter::print_header("Leaf Layout Comparison - " + dataset_name);
+    
+    // 1. 加载数据
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+    
+    // 2. 生成查询
+    std::cout << "\n[2] Generating Queries..." << std::endl;
+    query_count = std::min(query_count, keys.size());
+    auto queries = SOSDDataLoader::generate_queries(keys, query_count);
+    std::cout << "    ✓ Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+    
+    // 3. 逐个布局测试
+    std::cout << "\n[3] Testing Leaf Layouts..." << std::endl;
+    
+    std::vector<LayoutResult> results;
+    measure_leaf_layouts<16>(results, pairs, queries);
+    measure_leaf_layouts<64>(results, pairs, queries);
+    
+    // 4. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Leaf Layout Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Query Count: " << queries.size() << std::endl;
+    
+    std::cout << "\n  ╔══════════════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Slot  Layout         Leaf(B)   Build(ms)   Hit(ns)    L1D/op    LLC/op  ║" << std::endl;
+    std::cout << "  ╠══════════════════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    for (const auto& r : results) {
+        std::ostringstream l1d, llc;
+        l1d << std::fixed << std::setprecision(2);
+        llc << std::fixed << std::setprecision(2);
+        if (r.has_l1d) l1d << r.l1d_misses; else l1d << "n/a";
+        if (r.has_llc) llc << r.llc_misses; else llc << "n/a";
+        
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::setw(4) << r.slot_size << "  "
+                  << std::left << std::setw(13) << r.layout << std::right
+                  << std::setw(9) << r.leaf_bytes
+                  << std::setw(12) << r.build_ms
+                  << std::setw(10) << r.hit_ns
+                  << std::setw(10) << l1d.str()
+                  << std::setw(10) << llc.str() << "  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚══════════════════════════════════════════════════════════════════════════╝" << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 孩子指针压缩对比测试 ====================
+
+struct ChildRefResult {
+    int leaf_slots;
+    int inner_slots;
+    std::string child;
+    size_t inner_bytes;
+    size_t height;
+    size_t inner_nodes;
+    double inner_kb;
+    double bytes_per_key;
+    double lookup_ns;
+    double scan_ns;
+};
+
+/**
+ * 测试一种孩子引用方式：ptr（8 字节指针）或 idx32（节点池中的 32 位下标）
+ * 查找会读 value；scan 用迭代器沿叶子链表遍历全部 key，检验叶子链在节点池下的表现
+ */
+template<int LeafSlots, int InnerSlots, bool Pooled>
+ChildRefResult measure_child_refs(const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                                  const KeyVector& queries) {
+    using Tree = typename CustomBTree<uint64_t, uint64_t, LeafSlots, InnerSlots,
+                                      DefaultPrefetchPolicy, stx::btree_leaf_split, Pooled>::type;
+    
+    Tree btree;
+    btree.bulk_load(pairs.begin(), pairs.end());
+    auto stat = TreeStatistics::collect(btree);
+    
+    ChildRefResult r{LeafSlots, InnerSlots, Pooled ? "idx32" : "ptr", Tree::inner_node_bytes,
+                     stat.height, stat.inner_nodes,
+                     stat.inner_nodes * Tree::inner_node_bytes / 1024.0, stat.bytes_per_key(),
+                     0.0, 0.0};
+    
+    uint64_t checksum = 0;
+    Timer timer;
+    for (uint64_t q : queries) {
+        auto it = btree.find(q);
+        if (it != btree.end()) checksum += it->second;
+    }
+    r.lookup_ns = (timer.elapsed_ms() * 1e6) / queries.size();
+    
+    timer.reset();
+    for (auto it = btree.begin(); it != btree.end(); ++it) {
+        checksum += it->first;
+    }
+    r.scan_ns = (timer.elapsed_ms() * 1e6) / pairs.size();
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    " << std::left << std::setw(6) << r.child << std::right
+              << "  inner " << std::setw(3) << InnerSlots << " slots / " << std::setw(4) << r.inner_bytes << " B"
+              << "  height " << r.height
+              << "  lookup " << std::setw(8) << r.lookup_ns << " ns"
+              << "  scan " << std::setw(6) << r.scan_ns << " ns/key"
+              << "  (checksum " << (checksum & 0xffff) << ")" << std::endl;
+    
+    return r;
+}
+
+/**
+ * 同一叶子大小下的三种配置：
+ *   ptr   S 个 slot 的指针内部节点（基线）
+ *   idx32 S 个 slot，内部节点更小
+ *   idx32 S * 4/3 个 slot，内部节点字节数与基线相当，扇出更大
+ */
+template<int SlotSize>
+void measure_child_ref_variants(std::vector<ChildRefResult>& results,
+                                const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                                const KeyVector& queries) {
+    std::cout << "\n  ━━━ Leaf Slots: " << SlotSize << " ━━━" << std::endl;
+    
+    results.push_back(measure_child_refs<SlotSize, SlotSize, false>(pairs, queries));
+    results.push_back(measure_child_refs<SlotSize, SlotSize, true>(pairs, queries));
+    results.push_back(measure_child_refs<SlotSize, SlotSize * 4 / 3, true>(pairs, queries));
+}
+
+/**
+ * 比较 8 字节孩子指针和节点池 32 位下标：内部节点大小、树高、内部节点内存、查找和顺序扫描耗时
+ */
+void compare_child_pointers(const std::string& dataset_name, size_t query_count = 10'000'000) {
+    OutputFormatter::print_header("Child Pointer Compression - " + dataset_name);
+    
+    // 1. 加载数据
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+    
+    // 2. 生成查询
+    std::cout << "\n[2] Generating Queries..." << std::endl;
+    query_count = std::min(query_count, keys.size());
+    auto queries = SOSDDataLoader::generate_queries(keys, query_count);
+    std::cout << "    ✓ Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+    
+    // 3. 逐个配置测试
+    std::cout << "\n[3] Testing Child References..." << std::endl;
+    
+    std::vector<ChildRefResult> results;
+    measure_child_ref_variants<16>(results, pairs, queries);
+    measure_child_ref_variants<32>(results, pairs, queries);
+    measure_child_ref_variants<64>(results, pairs, queries);
+    
+    // 4. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Child Pointer Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Query Count: " << queries.size() << std::endl;
+    
+    std::cout << "\n  ╔═════════════════════════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Leaf  Inner  Child  Inner(B)  Height  InnerKB     Bytes/Key  Lookup(ns)  Scan(ns)  ║" << std::endl;
+    std::cout << "  ╠═════════════════════════════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    for (const auto& r : results) {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::setw(4) << r.leaf_slots
+                  << std::setw(7) << r.inner_slots << "  "
+                  << std::left << std::setw(5) << r.child << std::right
+                  << std::setw(10) << r.inner_bytes
+                  << std::setw(8) << r.height
+                  << std::setw(9) << static_cast<size_t>(r.inner_kb)
+                  << std::setw(14) << r.bytes_per_key
+                  << std::setw(12) << r.lookup_ns
+                  << std::setw(10) << r.scan_ns << "  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚═════════════════════════════════════════════════════════════════════════════════════╝" << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 压缩叶子对比测试 ====================
+
+struct CompressionResult {
+    std::string dataset;
+    std::string index;
+    double width_pct[4];    // 8 / 16 / 32 / 64 位差值叶子的占比
+    double ratio;           // key 压缩比，未压缩的基线为 0
+    double bytes_per_key;
+    double lookup_ns;
+};
+
+/**
+ * 差值压缩叶子的静态树：统计各宽度叶子占比和压缩比，查找会读 value
+ */
+template<size_t LeafKeys>
+CompressionResult measure_compressed_tree(const std::string& dataset_name,
+                                          const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                                          const KeyVector& queries) {
+    using Tree = CompressedBTree<uint64_t, LeafKeys>;
+    
+    Tree tree;
+    tree.bulk_load(pairs.begin(), pairs.end());
+    
+    CompressionResult r{dataset_name, "cbtree" + std::to_string(LeafKeys), {},
+                        tree.compression_ratio(),
+                        static_cast<double>(tree.memory_bytes()) / tree.size(), 0.0};
+    const unsigned widths[4] = {1, 2, 4, 8};
+    for (int w = 0; w < 4; ++w) {
+        r.width_pct[w] = tree.leaves_with_width(widths[w]) * 100.0 / tree.leaf_count();
+    }
+    
+    uint64_t checksum = 0;
+    Timer timer;
+    for (uint64_t q : queries) {
+        auto it = tree.find(q);
+        if (it != tree.end()) checksum += *it;
+    }
+    r.lookup_ns = (timer.elapsed_ms() * 1e6) / queries.size();
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    " << std::left << std::setw(10) << r.index << std::right
+              << "  height " << tree.height()
+              << "  ratio " << std::setw(5) << r.ratio
+              << "  bytes/key " << std::setw(6) << r.bytes_per_key
+              << "  lookup " << std::setw(8) << r.lookup_ns << " ns"
+              << "  (checksum " << (checksum & 0xffff) << ")" << std::endl;
+    
+    return r;
+}
+
+/**
+ * 未压缩的基线：64 slot 的 STX B+ 树
+ */
+CompressionResult measure_uncompressed_tree(const std::string& dataset_name,
+                                            const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                                            const KeyVector& queries) {
+    using Tree = typename CustomBTree<uint64_t, uint64_t, 64, 64>::type;
+    
+    Tree btree;
+    btree.bulk_load(pairs.begin(), pairs.end());
+    auto stat = TreeStatistics::collect(btree);
+    
+    CompressionResult r{dataset_name, "stx64", {}, 0.0, stat.bytes_per_key(), 0.0};
+    
+    uint64_t checksum = 0;
+    Timer timer;
+    for (uint64_t q : queries) {
+        auto it = btree.find(q);
+        if (it != btree.end()) checksum += it->second;
+    }
+    r.lookup_ns = (timer.elapsed_ms() * 1e6) / queries.size();
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    " << std::left << std::setw(10) << r.index << std::right
+              << "  height " << stat.height
+              << "  ratio     -"
+              << "  bytes/key " << std::setw(6) << r.bytes_per_key
+              << "  lookup " << std::setw(8) << r.lookup_ns << " ns"
+              << "  (checksum " << (checksum & 0xffff) << ")" << std::endl;
+    
+    return r;
+}
+
+/**
+ * 逐个数据集比较差值压缩叶子（每叶 64 / 128 个 key）和未压缩的 STX B+ 树：
+ * 各差值宽度的叶子占比、key 压缩比、每 key 总字节数（含 value）和查找延迟
+ */
+void compare_compressed_leaves(const std::vector<std::string>& datasets, size_t query_count = 10'000'000) {
+    std::vector<CompressionResult> results;
+    
+    for (const auto& dataset_name : datasets) {
+        OutputFormatter::print_header("Compressed Leaves - " + dataset_name);
+        
+        // 1. 加载数据
+        std::cout << "\n[1] Loading Data..." << std::endl;
+        std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+        auto keys = SOSDDataLoader::load_binary_file(data_file);
+        if (keys.empty()) {
+            std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+            continue;
+        }
+        auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+        
+        // 2. 生成查询
+        std::cout << "\n[2] Generating Queries..." << std::endl;
+        auto queries = SOSDDataLoader::generate_queries(keys, std::min(query_count, keys.size()));
+        std::cout << "    ✓ Generated " << queries.size() << " queries ("
+                  << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+        
+        // 3. 逐个结构测试
+        std::cout << "\n[3] Testing Leaf Compression..." << std::endl;
+        results.push_back(measure_uncompressed_tree(dataset_name, pairs, queries));
+        results.push_back(measure_compressed_tree<64>(dataset_name, pairs, queries));
+        results.push_back(measure_compressed_tree<128>(dataset_name, pairs, queries));
+    }
+    
+    if (results.empty()) return;
+    
+    // 4. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Compressed Leaves Summary");
+    
+    std::cout << "\n  ╔══════════════════════════════════════════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Dataset                       Index        8b%   16b%   32b%   64b%   Ratio  Bytes/Key  Lookup(ns)  ║" << std::endl;
+    std::cout << "  ╠══════════════════════════════════════════════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    for (const auto& r : results) {
+        std::string name = r.dataset.size() > 28 ? r.dataset.substr(0, 27) + "~" : r.dataset;
+        
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "  ║  " << std::left << std::setw(30) << name << std::setw(9) << r.index << std::right;
+        for (int w = 0; w < 4; ++w) {
+            if (r.ratio > 0) std::cout << std::setw(7) << r.width_pct[w];
+            else std::cout << std::setw(7) << "-";
+        }
+        std::cout << std::setprecision(2);
+        if (r.ratio > 0) std::cout << std::setw(8) << r.ratio;
+        else std::cout << std::setw(8) << "-";
+        std::cout << std::setw(11) << r.bytes_per_key
+                  << std::setw(12) << r.lookup_ns << "  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚══════════════════════════════════════════════════════════════════════════════════════════════════════╝" << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 快照启动对比测试 ====================
+
+struct StartupResult {
+    std::string method;
+    double startup_ms;
+    double file_mb;
+    double first_ns;    // 启动后第一轮查询（含缺页 / 页面载入）
+    double warm_ns;     // 第二轮查询
+    bool verified;
+};
+
+/**
+ * 把文件写回磁盘并从页缓存中清除，使下一次读取为冷启动
+ */
+void drop_page_cache(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+}
+
+double file_mb(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? st.st_size / (1024.0 * 1024.0) : 0.0;
+}
+
+/// 命中时 value 的读取方式：btree_map 迭代器 / 快照返回的 value 指针
+template<typename Iterator>
+uint64_t found_value(const Iterator& it) { return it->second; }
+
+inline uint64_t found_value(const uint64_t* it) { return *it; }
+
+/**
+ * 连续跑两轮查询，返回两轮各自的平均延迟和第二轮的 checksum
+ */
+template<typename Index>
+uint64_t time_two_passes(const Index& index, const KeyVector& queries, double& first_ns, double& warm_ns) {
+    uint64_t checksum = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        checksum = 0;
+        Timer timer;
+        for (uint64_t q : queries) {
+            auto it = index.find(q);
+            if (it != index.end()) checksum += found_value(it);
+        }
+        (pass == 0 ? first_ns : warm_ns) = (timer.elapsed_ms() * 1e6) / queries.size();
+    }
+    return checksum;
+}
+
+/**
+ * 比较三种得到可查询索引的方式的启动时间和之后的查询延迟：
+ *   rebuild   读 key 文件、排序、bulk_load（现在每次测试都这样做）
+ *   restore   STX dump() / restore()：逐节点读流并分配
+ *   snapshot  与地址无关的镜像文件，mmap 后原地查询（按需缺页 / MAP_POPULATE）
+ * 镜像文件已存在时直接从它启动，只测 snapshot 的启动和查询；
+ * 镜像不存在或 rewrite 为 true 时才重建树、写出镜像，并同时测 rebuild / restore。
+ * 冷启动前会把对应文件从页缓存中清除
+ */
+void compare_snapshot_startup(const std::string& dataset_name, std::string snapshot_path = "",
+                              bool rewrite = false, size_t query_count = 10'000'000) {
+    using Tree = typename CustomBTree<uint64_t, uint64_t, 64, 64>::type;
+    using Snapshot = BTreeSnapshot<Tree>;
+    
+    OutputFormatter::print_header("Tree Snapshot Startup - " + dataset_name);
+    
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    if (snapshot_path.empty()) snapshot_path = data_file + ".snap";
+    std::string dump_path = snapshot_path + ".dump";
+    bool reuse = !rewrite && std::ifstream(snapshot_path).good();
+    
+    std::vector<StartupResult> results;
+    KeyVector queries;
+    uint64_t expected = 0;
+    
+    if (reuse) {
+        std::cout << "\n  Using existing image " << snapshot_path
+                  << " (--rewrite rebuilds it and adds rebuild / restore)" << std::endl;
+        
+        // 1. key 文件只用来生成查询和校验值，不计入启动时间
+        std::cout << "\n[1] Loading Keys for Queries..." << std::endl;
+        auto keys = SOSDDataLoader::load_binary_file(data_file);
+        if (keys.empty()) {
+            std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+            return;
+        }
+        queries = SOSDDataLoader::generate_queries(keys, std::min(query_count, keys.size()));
+        std::cout << "    ✓ Generated " << queries.size() << " queries ("
+                  << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+        
+        auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+        for (uint64_t q : queries) {
+            auto it = std::lower_bound(pairs.begin(), pairs.end(), std::make_pair(q, uint64_t(0)));
+            if (it != pairs.end() && it->first == q) expected += it->second;
+        }
+        
+        std::cout << "\n[2] Starting Up..." << std::endl;
+    } else {
+        // 1. 重建：加载 + 排序 + bulk_load
+        std::cout << "\n[1] Rebuilding From Data File..." << std::endl;
+        drop_page_cache(data_file);
+        Timer timer;
+        auto keys = SOSDDataLoader::load_binary_file(data_file);
+        if (keys.empty()) {
+            std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+            return;
+        }
+        auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+        Tree btree;
+        btree.bulk_load(pairs.begin(), pairs.end());
+        double rebuild_ms = timer.elapsed_ms();
+        std::cout << "    ✓ " << btree.size() << " keys in " << std::fixed << std::setprecision(2)
+                  << rebuild_ms << " ms" << std::endl;
+        
+        // 2. 生成查询
+        std::cout << "\n[2] Generating Queries..." << std::endl;
+        queries = SOSDDataLoader::generate_queries(keys, std::min(query_count, keys.size()));
+        std::cout << "    ✓ Generated " << queries.size() << " queries ("
+                  << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+        
+        StartupResult rebuild{"rebuild", rebuild_ms, file_mb(data_file), 0.0, 0.0, true};
+        expected = time_two_passes(btree, queries, rebuild.first_ns, rebuild.warm_ns);
+        results.push_back(rebuild);
+        
+        // 3. 写出 dump 和快照
+        std::cout << "\n[3] Writing Images..." << std::endl;
+        timer.reset();
+        {
+            std::ofstream os(dump_path, std::ios::binary | std::ios::trunc);
+            btree.dump(os);
+        }
+        std::cout << "    dump():     " << std::setw(10) << timer.elapsed_ms() << " ms  "
+                  << std::setw(9) << file_mb(dump_path) << " MB  " << dump_path << std::endl;
+        
+        timer.reset();
+        if (!Snapshot::save(btree, snapshot_path)) {
+            std::cerr << "  ✗ Error: Failed to write " << snapshot_path << std::endl;
+            std::remove(dump_path.c_str());
+            return;
+        }
+        std::cout << "    snapshot:   " << std::setw(10) << timer.elapsed_ms() << " ms  "
+                  << std::setw(9) << file_mb(snapshot_path) << " MB  " << snapshot_path << std::endl;
+        
+        btree.clear();
+        decltype(keys)().swap(keys);
+        decltype(pairs)().swap(pairs);
+        
+        // 4. 各种方式启动
+        std::cout << "\n[4] Starting Up..." << std::endl;
+        drop_page_cache(dump_path);
+        timer.reset();
+        Tree restored;
+        std::ifstream is(dump_path, std::ios::binary);
+        bool ok = restored.restore(is);
+        StartupResult r{"restore", timer.elapsed_ms(), file_mb(dump_path), 0.0, 0.0, false};
+        if (ok) r.verified = time_two_passes(restored, queries, r.first_ns, r.warm_ns) == expected;
+        results.push_back(r);
+        std::remove(dump_path.c_str());
+    }
+    
+    // 两种映射方式都从冷页缓存开始：populate 测的是整个文件读入 + 映射的时间
+    for (bool populate : {false, true}) {
+        drop_page_cache(snapshot_path);
+        Timer timer;
+        Snapshot snapshot;
+        bool ok = snapshot.open(snapshot_path, populate);
+        StartupResult r{populate ? "snapshot (populate)" : "snapshot (lazy)", timer.elapsed_ms(),
+                        file_mb(snapshot_path), 0.0, 0.0, false};
+        if (ok) {
+            r.verified = time_two_passes(snapshot, queries, r.first_ns, r.warm_ns) == expected;
+        } else {
+            std::cerr << "  ✗ Error: " << snapshot_path << " is not a snapshot of this tree configuration"
+                      << " (--rewrite replaces it)" << std::endl;
+        }
+        results.push_back(r);
+    }
+    
+    for (const auto& r : results) {
+        std::cout << "    " << std::left << std::setw(20) << r.method << std::right
+                  << "  startup " << std::setw(10) << r.startup_ms << " ms"
+                  << "  first pass " << std::setw(8) << r.first_ns << " ns"
+                  << "  warm " << std::setw(8) << r.warm_ns << " ns"
+                  << "  " << (r.verified ? "✓" : "✗") << std::endl;
+    }
+    
+    // 5. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Tree Snapshot Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Query Count: " << queries.size() << std::endl;
+    
+    std::cout << "\n  ╔════════════════════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Method                 Startup(ms)   File(MB)    First(ns)  Warm(ns)   Valid  ║" << std::endl;
+    std::cout << "  ╠════════════════════════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    for (const auto& r : results) {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::left << std::setw(21) << r.method << std::right
+                  << std::setw(13) << r.startup_ms
+                  << std::setw(11) << r.file_mb
+                  << std::setw(13) << r.first_ns
+                  << std::setw(10) << r.warm_ns
+                  << std::setw(10) << (r.verified ? "✓" : "✗") << "  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚════════════════════════════════════════════════════════════════════════════════╝" << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 排序 + 去重阶段对比测试 ====================
+
+struct SortResult {
+    std::string method;
+    unsigned threads;
+    double sort_ms;
+    double dedup_ms;
+    size_t unique_keys;
+    bool verified;
+};
+
+/**
+ * 在 keys 的副本上测一种排序方法，再用并行去重（std 基线用 std::unique），
+ * 结果与 expected 比较
+ */
+template<typename Sort>
+SortResult measure_sort(const std::string& method, unsigned threads, const KeyVector& keys,
+                        const std::vector<uint64_t>& expected, Sort sort) {
+    std::vector<uint64_t> data(keys.begin(), keys.end());
+    std::vector<uint64_t> out(data.size());
+    SortResult r{method, threads, 0.0, 0.0, 0, false};
+    
+    Timer timer;
+    sort(data);
+    r.sort_ms = timer.elapsed_ms();
+    
+    timer.reset();
+    if (method == "std::sort") {
+        r.unique_keys = std::unique_copy(data.begin(), data.end(), out.begin()) - out.begin();
+    } else {
+        r.unique_keys = ParallelRadixSort::unique_copy(data.data(), data.size(), out.data(), threads);
+    }
+    r.dedup_ms = timer.elapsed_ms();
+    
+    out.resize(r.unique_keys);
+    r.verified = (out == expected);
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    " << std::left << std::setw(10) << method << std::right
+              << "  threads " << std::setw(3) << threads
+              << "  sort " << std::setw(10) << r.sort_ms << " ms"
+              << "  dedup " << std::setw(8) << r.dedup_ms << " ms"
+              << "  " << (r.verified ? "✓" : "✗") << std::endl;
+    return r;
+}
+
+/**
+ * 比较 bulk_load 前排序 + 去重阶段的实现：std::sort + std::unique（单线程基线）、
+ * 并行 LSD / MSD 基数排序 + 并行去重，线程数从 1 倍增到 max_threads
+ */
+void compare_sort_pipeline(const std::string& dataset_name, unsigned max_threads = 0) {
+    OutputFormatter::print_header("Sort + Dedup Pipeline - " + dataset_name);
+    
+    if (max_threads == 0) max_threads = ParallelRadixSort::default_threads();
+    
+    // 1. 加载数据
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    
+    // 2. 逐个方法测试
+    std::cout << "\n[2] Sorting..." << std::endl;
+    std::vector<SortResult> results;
+    
+    std::vector<uint64_t> expected(keys.begin(), keys.end());
+    std::sort(expected.begin(), expected.end());
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    
+    results.push_back(measure_sort("std::sort", 1, keys, expected, [](std::vector<uint64_t>& v) {
+        std::sort(v.begin(), v.end());
+    }));
+    
+    std::vector<unsigned> thread_counts;
+    for (unsigned t = 1; t < max_threads; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(max_threads);
+    
+    for (unsigned t : thread_counts) {
+        results.push_back(measure_sort("lsd", t, keys, expected, [t](std::vector<uint64_t>& v) {
+            ParallelRadixSort::lsd_sort(v.data(), v.size(), t);
+        }));
+    }
+    for (unsigned t : thread_counts) {
+        results.push_back(measure_sort("msd", t, keys, expected, [t](std::vector<uint64_t>& v) {
+            ParallelRadixSort::msd_sort(v.data(), v.size(), t);
+        }));
+    }
+    
+    // 3. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Sort + Dedup Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Keys: " << keys.size()
+              << " | Unique: " << expected.size() << std::endl;
+    
+    std::cout << "\n  ╔═══════════════════════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Method     Threads    Sort(ms)  Dedup(ms)   Total(ms)   Mkeys/s  Speedup  Valid  ║" << std::endl;
+    std::cout << "  ╠═══════════════════════════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    double baseline = results.front().sort_ms + results.front().dedup_ms;
+    for (const auto& r : results) {
+        double total = r.sort_ms + r.dedup_ms;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::left << std::setw(11) << r.method << std::right
+                  << std::setw(7) << r.threads
+                  << std::setw(12) << r.sort_ms
+                  << std::setw(11) << r.dedup_ms
+                  << std::setw(12) << total
+                  << std::setw(10) << keys.size() / (total * 1000.0)
+                  << std::setw(9) << baseline / total
+                  << std::setw(9) << (r.verified ? "✓" : "✗") << "  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚═══════════════════════════════════════════════════════════════════════════════════╝" << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 查询 trace 录制 / 回放 ====================
+
+/**
+ * 在数据集上录制一条混合 trace：range_pct% 的操作为覆盖约 range_size 个 key 的范围查询，
+ * 其余为点查；操作顺序由固定种子决定，同一数据集上每次录制结果相同
+ */
+void record_query_trace(const std::string& dataset_name, const std::string& trace_path,
+                        size_t op_count = 10'000'000, double range_pct = 0.0, size_t range_size = 100) {
+    OutputFormatter::print_header("Record Query Trace - " + dataset_name);
+    
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    KeyVector sorted_keys(keys.begin(), keys.end());
+    ParallelRadixSort::sort(sorted_keys.data(), sorted_keys.size());
+    
+    std::cout << "\n[2] Generating Operations..." << std::endl;
+    auto points = SOSDDataLoader::generate_queries(keys, op_count);
+    auto ranges = SOSDDataLoader::generate_range_queries(sorted_keys, op_count, range_size, 43);
+    
+    std::vector<uint64_t> starts(op_count), ends(op_count);
+    std::vector<TraceOp> ops(op_count);
+    std::mt19937_64 rng(44);
+    size_t range_ops = 0;
+    for (size_t i = 0; i < op_count; ++i) {
+        bool range = (rng() % 10000) < range_pct * 100;
+        ops[i] = range ? TraceOp::Range : TraceOp::Lookup;
+        starts[i] = range ? ranges[i].first : points[i % points.size()];
+        ends[i] = range ? ranges[i].second : starts[i];
+        range_ops += range;
+    }
+    
+    std::cout << "\n[3] Writing Trace..." << std::endl;
+    bool ok = range_ops ? QueryTrace::write(trace_path, starts.data(), op_count, ends.data(), ops.data())
+                        : QueryTrace::write(trace_path, starts.data(), op_count);
+    if (!ok) {
+        std::cerr << "  ✗ Error: Failed to write " << trace_path << std::endl;
+        return;
+    }
+    std::cout << "    ✓ " << op_count - range_ops << " lookups, " << range_ops << " ranges -> "
+              << trace_path << std::endl;
+}
+
+struct ReplayResult {
+    size_t ops = 0;
+    size_t hits = 0;            // 点查命中 / 范围查询返回的 key 数 / 插入和删除成功数
+    double time_ms = 0.0;
+};
+
+/**
+ * 把 trace 直接从映射上流式回放到 STX B+ 树（64 slots，bulk_load 构建）
+ * 先按原顺序整体回放一次，只计总时间；再把每种操作按原相对顺序各自放在一个计时循环中回放，
+ * 得到每种操作的平均耗时（混合 trace 中同类操作的连续段很短，逐段计时会被读时钟的开销淹没）。
+ * 不认识的操作类型跳过
+ */
+void replay_query_trace(const std::string& dataset_name, const std::string& trace_path) {
+    using Tree = typename CustomBTree<uint64_t, uint64_t, 64, 64>::type;
+    
+    OutputFormatter::print_header("Replay Query Trace - " + dataset_name);
+    
+    // 1. 加载数据并构建
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+    Tree btree;
+    btree.bulk_load(pairs.begin(), pairs.end());
+    
+    // 2. 打开 trace，按操作类型分组
+    std::cout << "\n[2] Opening Trace..." << std::endl;
+    QueryTrace trace;
+    if (!trace.open(trace_path)) {
+        std::cerr << "  ✗ Error: Failed to open trace " << trace_path << std::endl;
+        return;
+    }
+    std::cout << "    ✓ " << trace.size() << " operations"
+              << (trace.has_ranges() ? ", with range ends" : "")
+              << (trace.has_op_tags() ? ", with op tags" : "") << std::endl;
+    
+    const uint64_t* k = trace.keys();
+    const uint64_t* e = trace.ends();
+    
+    std::vector<size_t> by_op[4];
+    size_t skipped = 0;
+    for (size_t i = 0; i < trace.size(); ++i) {
+        TraceOp op = trace.op(i);
+        if (op > TraceOp::Erase || (op == TraceOp::Range && !e)) {
+            skipped++;
+            continue;
+        }
+        by_op[static_cast<int>(op)].push_back(i);
+    }
+    
+    uint64_t checksum = 0;
+    
+    // 执行第 i 个操作，返回命中数（点查命中 / 范围查询返回的 key 数 / 插入和删除成功数）
+    auto apply = [&](TraceOp op, size_t i) -> size_t {
+        switch (op) {
+            case TraceOp::Lookup: {
+                auto it = btree.find(k[i]);
+                if (it == btree.end()) return 0;
+                checksum += it->second;
+                return 1;
+            }
+            case TraceOp::Range: {
+                size_t n = 0;
+                for (auto it = btree.lower_bound(k[i]); it != btree.end() && it->first <= e[i]; ++it) {
+                    checksum += it->second;
+                    n++;
+                }
+                return n;
+            }
+            case TraceOp::Insert:
+                return btree.insert(std::make_pair(k[i], k[i])).second;
+            case TraceOp::Erase:
+                return btree.erase(k[i]);
+        }
+        return 0;
+    };
+    
+    // 3. 按原顺序整体回放
+    std::cout << "\n[3] Replaying In Order..." << std::endl;
+    ReplayResult results[4];
+    size_t replayed = trace.size() - skipped;
+    
+    Timer total_timer;
+    for (size_t i = 0; i < trace.size(); ++i) {
+        TraceOp op = trace.op(i);
+        if (op > TraceOp::Erase || (op == TraceOp::Range && !e)) continue;
+        results[static_cast<int>(op)].hits += apply(op, i);
+    }
+    double total_ms = total_timer.elapsed_ms();
+    std::cout << "    ✓ " << replayed << " operations in " << std::fixed << std::setprecision(2)
+              << total_ms << " ms" << std::endl;
+    
+    // 4. 按操作类型分别回放；有插入 / 删除时先重建，让每种操作都从相同的初始树开始
+    std::cout << "\n[4] Replaying Per Operation Type..." << std::endl;
+    bool mutated = !by_op[static_cast<int>(TraceOp::Insert)].empty() ||
+                   !by_op[static_cast<int>(TraceOp::Erase)].empty();
+    
+    for (int op = 0; op < 4; ++op) {
+        ReplayResult& r = results[op];
+        r.ops = by_op[op].size();
+        if (r.ops == 0) continue;
+        
+        if (mutated) {
+            btree.clear();
+            btree.bulk_load(pairs.begin(), pairs.end());
+        }
+        
+        Timer timer;
+        for (size_t i : by_op[op]) apply(static_cast<TraceOp>(op), i);
+        r.time_ms = timer.elapsed_ms();
+    }
+    
+    // 5. 汇总
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Trace Replay Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Trace: " << trace_path
+              << " | In Order: " << std::fixed << std::setprecision(2) << total_ms << " ms, "
+              << (replayed ? total_ms * 1e6 / replayed : 0.0) << " ns/op"
+              << " (checksum " << (checksum & 0xffff) << ")" << std::endl;
+    if (skipped) std::cout << "  Skipped " << skipped << " operations of unknown type" << std::endl;
+    
+    std::cout << "\n  ╔══════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Op               Count   Hits/Keys    Time(ms)       ns/op  ║" << std::endl;
+    std::cout << "  ╠══════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    for (int op = 0; op < 4; ++op) {
+        const ReplayResult& r = results[op];
+        if (r.ops == 0) continue;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::left << std::setw(10) << QueryTrace::op_name(static_cast<TraceOp>(op)) << std::right
+                  << std::setw(12) << r.ops
+                  << std::setw(12) << r.hits
+                  << std::setw(12) << r.time_ms
+                  << std::setw(12) << r.time_ms * 1e6 / r.ops << "  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚══════════════════════════════════════════════════════════════╝" << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 实验矩阵 ====================
+
+/**
+ * 让 B+ 树走 build_index() 的 bulk_load 分支（排序 + 去重后批量构建）
+ */
+template<typename Tree>
+struct BulkLoadedTree : Tree {
+    static constexpr bool bulk_load_only = true;
+};
+
+template<typename Index, typename = void>
+struct has_prefetch_leaf : std::false_type {};
+
+template<typename Index>
+struct has_prefetch_leaf<Index, std::void_t<decltype(std::declval<const Index&>().prefetch_leaf(uint64_t()))>>
+    : std::true_type {};
+
+template<typename Index, typename = void>
+struct has_radix_table : std::false_type {};
+
+template<typename Index>
+struct has_radix_table<Index, std::void_t<decltype(std::declval<Index&>().enable_radix_table(0u, 0u))>>
+    : std::true_type {};
+
+/**
+ * 查找引擎：
+ *   find               普通 find() 循环
+ *   pipeline（D > 0）  软件流水，处理第 i 个查询时预取第 i + D 个查询的叶子
+ *   radix:<bits>:<depth>  从基数表项开始下降（表在计时前建好）
+ */
+struct MatrixEngine {
+    std::string name;
+    size_t distance = 0;
+    unsigned radix_bits = 0;
+    unsigned radix_depth = 0;
+    
+    std::string label() const {
+        if (name == "pipeline") return name + ":" + std::to_string(distance);
+        if (name == "radix") return name + ":" + std::to_string(radix_bits) + ":" + std::to_string(radix_depth);
+        return name;
+    }
+};
+
+/**
+ * 实验描述文件（INI），列表项用逗号分隔：
+ *
+ *   [experiment]
+ *   queries = 10000000              ; 每个负载的查询数（默认 10M）
+ *   output  = results.csv           ; 可选，每跑完一格写一行 CSV
+ *   pages   = 2m                    ; 可选，同 --pages=
+ *
+ *   [matrix]
+ *   datasets   = books_200M, fb_200M
+ *   structures = btree, btree_bulk, stree, pgm   ; btree / btree_bulk 按 slots 展开，其余同单数据集测试
+ *   slots      = 16, 32, 64         ; 16 / 32 / 64 / 128
+ *   engines    = find, pipeline, radix:16:2
+ *   prefetch   = 8, 16              ; pipeline 的预取距离
+ *   threads    = 1, 4               ; 查询均分给各线程
+ *   workloads  = uniform, uniform:7, trace:data/books.trace
+ *
+ * 展开顺序为 数据集 → 结构（× slots）→ 负载 → 引擎 → 线程数：
+ * 每个数据集只加载一次，负载在数据集内只生成一次，每个结构只构建一次，后面的格都复用。
+ * 不支持某个引擎的结构（pipeline / radix 只适用于 STX B+ 树）跳过对应的格。
+ */
+struct ExperimentMatrix {
+    std::vector<std::string> datasets;
+    std::vector<std::string> structures;
+    std::vector<size_t> slots;
+    std::vector<MatrixEngine> engines;
+    std::vector<unsigned> threads;
+    std::vector<std::string> workloads;
+    size_t query_count = 10'000'000;
+    std::string output;
+    
+    static bool uses_slots(const std::string& structure) {
+        return structure == "btree" || structure == "btree_bulk";
+    }
+    
+    /// 结构展开后的 (结构, slots) 组合，slots 为 0 表示不适用
+    std::vector<std::pair<std::string, size_t>> index_configs() const {
+        std::vector<std::pair<std::string, size_t>> configs;
+        for (const auto& s : structures) {
+            if (!uses_slots(s)) {
+                configs.emplace_back(s, 0);
+                continue;
+            }
+            for (size_t slot : slots) configs.emplace_back(s, slot);
+        }
+        return configs;
+    }
+
+    /// 计划运行的格数（不含结构不支持的引擎）
+    size_t cell_count() const;
+};
+
+struct MatrixCell {
+    std::string dataset;
+    std::string workload;
+    std::string structure;
+    std::string engine;
+    unsigned threads;
+    double build_ms;
+    double sort_ms;
+    double ns_per_query;
+    double mops;
+    size_t hits;
+    size_t queries;
+};
+
+/// pipeline 需要 prefetch_leaf()，radix 需要基数表，find 所有结构都支持
+template<typename Index>
+bool supports_engine(const MatrixEngine& engine) {
+    if (engine.name == "pipeline") return has_prefetch_leaf<Index>::value;
+    if (engine.name == "radix") return has_radix_table<Index>::value;
+    return true;
+}
+
+template<typename T>
+struct index_tag { using type = T; };
+
+template<int SlotSize, typename F>
+void with_btree_slots(bool bulk, F& f) {
+    using Tree = typename CustomBTree<uint64_t, uint64_t, SlotSize, SlotSize>::type;
+    if (bulk) {
+        f(index_tag<BulkLoadedTree<Tree>>{});
+    } else {
+        f(index_tag<Tree>{});
+    }
+}
+
+/**
+ * 按结构名和 slots 选出索引类型，调用 f(index_tag<Index>{})；不认识的组合返回 false
+ */
+template<typename F>
+bool dispatch_matrix_index(const std::string& structure, size_t slots, F&& f) {
+    if (ExperimentMatrix::uses_slots(structure)) {
+        bool bulk = (structure == "btree_bulk");
+        switch (slots) {
+            case 16:  with_btree_slots<16>(bulk, f);  return true;
+            case 32:  with_btree_slots<32>(bulk, f);  return true;
+            case 64:  with_btree_slots<64>(bulk, f);  return true;
+            case 128: with_btree_slots<128>(bulk, f); return true;
+            default:  return false;
+        }
+    }
+    
+    if (structure == "stx") {
+        f(index_tag<BTree64>{});
+    } else if (structure == "stree") {
+        f(index_tag<STree64>{});
+    } else if (structure == "eytzinger") {
+        f(index_tag<Eytzinger64>{});
+    } else if (structure == "rmi") {
+        f(index_tag<RMI64>{});
+    } else if (structure == "rmi_prefetch") {
+        f(index_tag<RMI64Prefetch>{});
+    } else if (structure == "pgm") {
+        f(index_tag<PGM64>{});
+    } else if (structure == "pgm_prefetch") {
+        f(index_tag<PGM64Prefetch>{});
+    } else if (structure == "art") {
+        f(index_tag<ART64>{});
+    } else if (structure == "art_bulk") {
+        f(index_tag<BulkART64>{});
+    } else if (structure == "cbtree") {
+        f(index_tag<CompressedBTree64>{});
+    } else {
+        return false;
+    }
+    return true;
+}
+
+size_t ExperimentMatrix::cell_count() const {
+    size_t per_dataset = 0;
+    for (const auto& config : index_configs()) {
+        dispatch_matrix_index(config.first, config.second, [&](auto tag) {
+            for (const auto& engine : engines) {
+                per_dataset += supports_engine<typename decltype(tag)::type>(engine);
+            }
+        });
+    }
+    return datasets.size() * per_dataset * workloads.size() * threads.size();
+}
+
+/**
+ * 从 INI 文件读出实验矩阵，任何一项不合法都在加载数据之前报错
+ */
+bool load_experiment_matrix(const std::string& path, ExperimentMatrix& m) {
+    IniFile ini;
+    if (!ini.load(path)) return false;
+    
+    for (const auto& key : ini.unknown_keys("experiment", {"queries", "output", "pages"})) {
+        std::cerr << "  Warning: unknown key [experiment] " << key << std::endl;
+    }
+    for (const auto& key : ini.unknown_keys("matrix", {"datasets", "structures", "slots", "engines",
+                                                       "prefetch", "threads", "workloads"})) {
+        std::cerr << "  Warning: unknown key [matrix] " << key << std::endl;
+    }
+    
+    auto to_sizes = [](const std::vector<std::string>& items, std::vector<size_t>& out) {
+        for (const auto& s : items) {
+            if (s.empty() || s.find_first_not_of("0123456789") != std::string::npos) {
+                std::cerr << "  Invalid number: " << s << std::endl;
+                return false;
+            }
+            out.push_back(std::stoull(s));
+        }
+        return true;
+    };
+    
+    std::vector<size_t> distances, threads, query_count;
+    if (!to_sizes(ini.get_list("experiment", "queries", {"10000000"}), query_count) ||
+        !to_sizes(ini.get_list("matrix", "slots", {"16"}), m.slots) ||
+        !to_sizes(ini.get_list("matrix", "prefetch", {"16"}), distances) ||
+        !to_sizes(ini.get_list("matrix", "threads", {"1"}), threads)) {
+        return false;
+    }
+    
+    m.query_count = query_count.empty() ? 0 : query_count.front();
+    m.output = ini.get("experiment", "output");
+    m.datasets = ini.get_list("matrix", "datasets");
+    m.structures = ini.get_list("matrix", "structures", {"btree_bulk"});
+    m.workloads = ini.get_list("matrix", "workloads", {"uniform"});
+    
+    if (ini.has("experiment", "pages")) {
+        PageMode mode;
+        if (!PageConfig::parse(ini.get("experiment", "pages"), mode)) {
+            std::cerr << "  Unknown page size: " << ini.get("experiment", "pages") << " (4k, thp, 2m, 1g)" << std::endl;
+            return false;
+        }
+        PageConfig::mode() = mode;
+    }
+    
+    for (size_t t : threads) {
+        if (t == 0) {
+            std::cerr << "  Thread count must be at least 1" << std::endl;
+            return false;
+        }
+        m.threads.push_back(static_cast<unsigned>(t));
+    }
+    
+    for (const auto& e : ini.get_list("matrix", "engines", {"find"})) {
+        MatrixEngine engine;
+        engine.name = e.substr(0, e.find(':'));
+        if (e == "find") {
+            m.engines.push_back(engine);
+        } else if (e == "pipeline") {
+            for (size_t d : distances) {
+                engine.distance = d;
+                m.engines.push_back(engine);
+            }
+        } else if (engine.name == "radix") {
+            unsigned bits = 16, depth = 2;
+            if (e.size() > 5 && std::sscanf(e.c_str(), "radix:%u:%u", &bits, &depth) < 1) bits = 0;
+            if (bits == 0 || bits > 24 || depth == 0) {
+                std::cerr << "  Invalid radix engine: " << e << " (radix[:bits[:depth]])" << std::endl;
+                return false;
+            }
+            engine.radix_bits = bits;
+            engine.radix_depth = depth;
+            m.engines.push_back(engine);
+        } else {
+            std::cerr << "  Unknown engine: " << e << " (find, pipeline, radix[:bits[:depth]])" << std::endl;
+            return false;
+        }
+    }
+    
+    for (const auto& w : m.workloads) {
+        // 种子须是十进制整数，且不超过 19 位，保证 std::stoull 不会在运行中途抛出
+        bool seeded = w.rfind("uniform:", 0) == 0 && w.size() > 8 && w.size() <= 8 + 19 &&
+                      w.find_first_not_of("0123456789", 8) == std::string::npos;
+        if (w != "uniform" && !seeded && w.rfind("trace:", 0) != 0) {
+            std::cerr << "  Unknown workload: " << w << " (uniform[:seed], trace:<file>)" << std::endl;
+            return false;
+        }
+    }
+    
+    for (const auto& config : m.index_configs()) {
+        if (!dispatch_matrix_index(config.first, config.second, [](auto) {})) {
+            std::cerr << "  Unknown structure: " << config.first;
+            if (config.second) std::cerr << " with " << config.second << " slots (16, 32, 64, 128)";
+            std::cerr << std::endl;
+            return false;
+        }
+    }
+    
+    if (m.datasets.empty() || m.structures.empty() || m.slots.empty() || m.engines.empty() ||
+        m.threads.empty() || m.workloads.empty() || m.query_count == 0) {
+        std::cerr << "  Empty matrix: datasets, structures, engines, threads, workloads and queries must be set" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 把查询均分给 threads 个线程执行，返回每个查询的平均耗时（各线程忙碌时间之和 / 查询数），
+ * wall_ms 为全部线程完成的墙钟时间
+ */
+template<typename Index>
+double run_matrix_lookups(const Index& index, const KeyVector& queries, size_t distance,
+                          unsigned threads, size_t& found, double& wall_ms) {
+    const size_t n = queries.size();
+    std::vector<size_t> hits(threads, 0);
+    std::vector<double> busy_ms(threads, 0.0);
+    
+    Timer wall;
+    run_parallel(threads, [&](unsigned t) {
+        size_t lo = chunk_begin(n, threads, t), hi = chunk_begin(n, threads, t + 1);
+        size_t f = 0;
+        
+        Timer timer;
+        for (size_t i = lo; i < hi; ++i) {
+            if constexpr (has_prefetch_leaf<Index>::value) {
+                if (distance && i + distance < hi) index.prefetch_leaf(queries[i + distance]);
+            }
+            if (index.find(queries[i]) != index.end()) f++;
+        }
+        busy_ms[t] = timer.elapsed_ms();
+        hits[t] = f;
+    });
+    wall_ms = wall.elapsed_ms();
+    
+    found = 0;
+    double busy = 0.0;
+    for (unsigned t = 0; t < threads; ++t) {
+        found += hits[t];
+        busy += busy_ms[t];
+    }
+    return (busy * 1e6) / n;
+}
+
+/**
+ * 构建一次索引，在其上跑完该 (数据集, 结构) 下的所有 负载 × 引擎 × 线程数 格
+ */
+template<typename Index>
+void run_matrix_index(const ExperimentMatrix& m, const std::string& dataset, const std::string& structure,
+                      const KeyVector& keys, const std::vector<std::pair<std::string, KeyVector>>& workloads,
+                      std::vector<MatrixCell>& cells, std::ofstream& csv) {
+    std::cout << "\n  ━━━ " << structure << " ━━━" << std::endl;
+    
+    Index index;
+    double sort_ms = 0.0;
+    double build_ms = build_index(index, keys, &sort_ms);
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    Build: " << build_ms << " ms";
+    if constexpr (is_bulk_load_only<Index>::value) std::cout << " (+ " << sort_ms << " ms sort + dedup)";
+    std::cout << std::endl;
+    
+    for (const auto& workload : workloads) {
+        const KeyVector& queries = workload.second;
+        size_t expected_hits = SIZE_MAX;
+        
+        for (const auto& engine : m.engines) {
+            if (!supports_engine<Index>(engine)) continue;
+            if constexpr (has_radix_table<Index>::value) {
+                if (engine.name == "radix") {
+                    index.enable_radix_table(engine.radix_bits, engine.radix_depth);
+                }
+            }
+            
+            for (unsigned threads : m.threads) {
+                MatrixCell cell{dataset, workload.first, structure, engine.label(), threads,
+                                build_ms, sort_ms, 0.0, 0.0, 0, queries.size()};
+                
+                double wall_ms = 0.0;
+                cell.ns_per_query = run_matrix_lookups(index, queries, engine.distance, threads, cell.hits, wall_ms);
+                cell.mops = (queries.size() / wall_ms) / 1e3;
+                
+                if (expected_hits == SIZE_MAX) expected_hits = cell.hits;
+                if (cell.hits != expected_hits) {
+                    OutputFormatter::print_error("Hit count mismatch: " + cell.engine + " x" + std::to_string(threads));
+                }
+                
+                std::cout << "    " << std::left << std::setw(14) << workload.first << std::setw(14) << cell.engine
+                          << std::right << "x" << std::setw(3) << threads
+                          << std::setw(10) << cell.ns_per_query << " ns/query"
+                          << std::setw(9) << cell.mops << " M ops/s" << std::endl;
+                
+                if (csv.is_open()) {
+                    csv << cell.dataset << ',' << cell.workload << ',' << cell.structure << ','
+                        << cell.engine << ',' << cell.threads << ',' << cell.queries << ','
+                        << cell.hits << ',' << cell.build_ms << ',' << cell.sort_ms << ','
+                        << cell.ns_per_query << ',' << cell.mops << ',' << dram_equivalent(cell.ns_per_query) << '\n';
+                    csv.flush();
+                }
+                cells.push_back(cell);
+            }
+            
+            if constexpr (has_radix_table<Index>::value) {
+                if (engine.name == "radix") index.disable_radix_table();
+            }
+        }
+    }
+}
+
+/**
+ * 按实验描述文件展开并运行实验矩阵，见 ExperimentMatrix
+ */
+void run_experiment_matrix(const std::string& path) {
+    OutputFormatter::print_header("Experiment Matrix - " + path);
+    
+    ExperimentMatrix m;
+    if (!load_experiment_matrix(path, m)) return;
+    
+    std::cout << "\n  Datasets: " << m.datasets.size() << " | Index Configs: " << m.index_configs().size()
+              << " | Workloads: " << m.workloads.size() << " | Engines: " << m.engines.size()
+              << " | Thread Counts: " << m.threads.size() << " | Cells: " << m.cell_count() << std::endl;
+    
+    std::ofstream csv;
+    if (!m.output.empty()) {
+        csv.open(m.output, std::ios::trunc);
+        if (!csv) {
+            std::cerr << "  ✗ Error: Cannot create " << m.output << std::endl;
+            return;
+        }
+        if (MemoryCalibration::current()) MemoryCalibration::current()->write_metadata(csv);
+        csv << "dataset,workload,structure,engine,threads,queries,hits,build_ms,sort_ms,ns_per_query,mops,dram_equiv\n";
+        csv << std::fixed << std::setprecision(3);
+    }
+    
+    std::vector<MatrixCell> cells;
+    for (size_t d = 0; d < m.datasets.size(); ++d) {
+        const std::string& dataset = m.datasets[d];
+        
+        // 1. 加载数据（每个数据集一次）
+        std::cout << "\n[" << d + 1 << "/" << m.datasets.size() << "] " << dataset << std::endl;
+        std::cout << "\n  Loading Data..." << std::endl;
+        std::string data_file = SOSDDataLoader::dataset_path(dataset);
+        auto keys = SOSDDataLoader::load_binary_file(data_file);
+        if (keys.empty()) {
+            std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+            continue;
+        }
+        
+        // 2. 生成全部负载（所有结构共用）
+        std::cout << "\n  Generating Workloads..." << std::endl;
+        size_t query_count = std::min(m.query_count, keys.size());
+        std::vector<std::pair<std::string, KeyVector>> workloads;
+        for (const auto& w : m.workloads) {
+            KeyVector queries;
+            if (w.rfind("trace:", 0) == 0) {
+                queries = SOSDDataLoader::load_trace_queries(w.substr(6), query_count);
+            } else {
+                uint64_t seed = (w == "uniform") ? 42 : std::stoull(w.substr(8));
+                queries = SOSDDataLoader::generate_queries(keys, query_count, seed);
+            }
+            if (queries.empty()) {
+                std::cerr << "  ✗ Error: Empty workload " << w << ", skipped" << std::endl;
+                continue;
+            }
+            std::cout << "    ✓ " << w << ": " << queries.size() << " queries ("
+                      << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+            workloads.emplace_back(w, std::move(queries));
+        }
+        
+        // 3. 每个结构构建一次，跑完它的所有格
+        for (const auto& config : m.index_configs()) {
+            std::string label = config.first;
+            if (config.second) label += "/" + std::to_string(config.second);
+            
+            dispatch_matrix_index(config.first, config.second, [&](auto tag) {
+                using Index = typename decltype(tag)::type;
+                run_matrix_index<Index>(m, dataset, label, keys, workloads, cells, csv);
+            });
+        }
+    }
+    
+    // 4. 汇总
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Experiment Matrix Summary");
+    
+    std::cout << "\n  Cells Run: " << cells.size() << " / " << m.cell_count();
+    if (!m.output.empty()) std::cout << " | CSV: " << m.output;
+    std::cout << std::endl;
+    
+    auto fit = [](const std::string& s, size_t width) {
+        return s.size() < width ? s : s.substr(0, width - 2) + "~";
+    };
+    
+    std::cout << "\n  ╔════════════════════════════════════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Dataset           Workload    Structure      Engine        Thr  Build(ms)  ns/query   Mops/s  ║" << std::endl;
+    std::cout << "  ╠════════════════════════════════════════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    for (const auto& c : cells) {
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::left << std::setw(18) << fit(c.dataset, 18)
+                  << std::setw(12) << fit(c.workload, 12)
+                  << std::setw(15) << fit(c.structure, 15)
+                  << std::setw(13) << fit(c.engine, 13) << std::right
+                  << std::setw(4) << c.threads
+                  << std::setw(11) << c.build_ms
+                  << std::setw(10) << c.ns_per_query
+                  << std::setw(9) << c.mops << "  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚════════════════════════════════════════════════════════════════════════════════════════════════╝" << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 数据规模扫描测试 ====================
+
+/**
+ * 索引占用的内存：B+ 树遍历节点统计，其余结构用 memory_bytes()
+ */
+template<typename Index>
+size_t index_memory_bytes(const Index& index) {
+    if constexpr (has_tree_stats<Index>::value) {
+        return TreeStatistics::collect(index).memory_bytes;
+    } else {
+        return index.memory_bytes();
+    }
+}
+
+struct SweepPoint {
+    std::string structure;
+    size_t keys = 0;
+    size_t memory_bytes = 0;
+    double ns_per_query = 0.0;
+    double mops = 0.0;
+    double l1d_misses = 0.0;
+    double llc_misses = 0.0;
+    double dtlb_misses = 0.0;
+    bool has_l1d = false;
+    bool has_llc = false;
+    bool has_dtlb = false;
+    bool cliff = false;
+    std::string crossed;    // 这一步内存越过的已知缓存 / TLB 容量
+};
+
+/**
+ * 在一个样本上构建索引，先预热一遍再计时，同时统计每次查找的 L1D / LLC / dTLB 缺失
+ */
+template<typename Index>
+SweepPoint measure_sweep_point(const std::string& structure, const KeyVector& sample, const KeyVector& queries) {
+    Index index;
+    build_index(index, sample);
+    
+    SweepPoint p;
+    p.structure = structure;
+    p.keys = sample.size();
+    p.memory_bytes = index_memory_bytes(index);
+    
+    // 预热：小样本的稳态是整棵树都在缓存中
+    size_t warm = 0;
+    for (uint64_t q : queries) {
+        if (index.find(q) != index.end()) warm++;
+    }
+    
+    PerfCounters counters;
+    size_t found = 0;
+    
+    counters.start();
+    Timer timer;
+    for (uint64_t q : queries) {
+        if (index.find(q) != index.end()) found++;
+    }
+    double elapsed_ms = timer.elapsed_ms();
+    counters.stop();
+    
+    if (found != warm || found != queries.size()) {
+        OutputFormatter::print_error("Missing keys: " + std::to_string(queries.size() - found));
+    }
+    
+    p.ns_per_query = (elapsed_ms * 1e6) / queries.size();
+    p.mops = (queries.size() / elapsed_ms) / 1e3;
+    p.has_l1d = counters.available(PerfCounters::L1DMiss);
+    p.has_llc = counters.available(PerfCounters::LLCMiss);
+    p.has_dtlb = counters.available(PerfCounters::DTLBMiss);
+    p.l1d_misses = static_cast<double>(counters.count(PerfCounters::L1DMiss)) / queries.size();
+    p.llc_misses = static_cast<double>(counters.count(PerfCounters::LLCMiss)) / queries.size();
+    p.dtlb_misses = static_cast<double>(counters.count(PerfCounters::DTLBMiss)) / queries.size();
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    " << std::left << std::setw(15) << structure << std::right
+              << std::setw(11) << CacheInfo::format_bytes(p.memory_bytes)
+              << std::setw(10) << p.ns_per_query << " ns/query" << std::endl;
+    
+    return p;
+}
+
+/**
+ * 从 1K 到 n 的对数间隔规模，每 10 倍 points_per_decade 个点，最后一个点为 n
+ */
+std::vector<size_t> log_spaced_sizes(size_t n, int points_per_decade = 4) {
+    std::vector<size_t> sizes;
+    for (int i = 0; ; ++i) {
+        size_t s = static_cast<size_t>(std::llround(1000.0 * std::pow(10.0, double(i) / points_per_decade)));
+        if (s >= n) break;
+        sizes.push_back(s);
+    }
+    sizes.push_back(n);
+    return sizes;
+}
+
+/**
+ * 标出一个结构的延迟曲线上的断崖：
+ *   相邻两点的延迟比 >= 1.2，比所有相邻比值的中位数高 0.1 以上
+ *   （正常情况下每一步只多一点树高，比值接近中位数），且不小于前后两步的比值
+ *   （连续几步都在变慢时只标最陡的一步）
+ * 同时记录每一步内存越过了哪些已知的缓存 / TLB 容量
+ */
+void mark_cache_cliffs(std::vector<SweepPoint>& series, const CacheInfo& cache) {
+    if (series.size() < 2) return;
+    
+    std::vector<double> growth;
+    for (size_t i = 1; i < series.size(); ++i) {
+        growth.push_back(series[i].ns_per_query / series[i - 1].ns_per_query);
+    }
+    std::vector<double> sorted = growth;
+    std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+    double median = sorted[sorted.size() / 2];
+    
+    for (size_t i = 1; i < series.size(); ++i) {
+        double g = growth[i - 1];
+        bool local_max = (i < 2 || g >= growth[i - 2]) && (i >= growth.size() || g >= growth[i]);
+        series[i].cliff = g >= 1.2 && g >= median + 0.1 && local_max;
+        for (const auto& level : cache.levels()) {
+            if (series[i - 1].memory_bytes < level.second && series[i].memory_bytes >= level.second) {
+                if (!series[i].crossed.empty()) series[i].crossed += "+";
+                series[i].crossed += level.first;
+            }
+        }
+    }
+}
+
+/**
+ * 数据规模扫描：从数据集中均匀随机抽样（不是取前缀），在对数间隔的规模上构建索引，
+ * 报告每个规模的延迟、吞吐和每次查找的缺失数，并标出缓存层级造成的断崖。
+ * 结果同时写成 CSV（# 开头的行为元数据），可直接画图。
+ *
+ * 抽样：排序去重后整体打乱一次，规模 n 的样本取打乱后的前 n 个，
+ * 因此各规模的样本是嵌套的，曲线不会因为抽样差异而抖动。
+ */
+void compare_size_sweep(const std::string& dataset_name, const std::vector<std::string>& structures,
+                        std::string csv_path = "", size_t query_count = 1'000'000) {
+    OutputFormatter::print_header("Dataset Size Sweep - " + dataset_name);
+    
+    // 0. 缓存层级
+    CacheInfo cache = CacheInfo::detect();
+    std::cout << "\n  Cache Hierarchy:";
+    for (const auto& level : cache.levels()) {
+        std::cout << "  " << level.first << " " << CacheInfo::format_bytes(level.second);
+    }
+    if (!cache.tlb_entries) std::cout << "  (TLB reach unknown)";
+    std::cout << std::endl;
+    
+    // 1. 加载数据，排序去重后打乱
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    
+    KeyVector pool(keys.size());
+    ParallelRadixSort::sort(keys.data(), keys.size());
+    pool.resize(ParallelRadixSort::unique_copy(keys.data(), keys.size(), pool.data()));
+    KeyVector().swap(keys);
+    
+    std::mt19937_64 rng(42);
+    std::shuffle(pool.begin(), pool.end(), rng);
+    std::cout << "    ✓ " << pool.size() << " unique keys, shuffled for sampling" << std::endl;
+    
+    auto sizes = log_spaced_sizes(pool.size());
+    std::cout << "    ✓ " << sizes.size() << " sizes: " << sizes.front() << " .. " << sizes.back() << std::endl;
+    
+    // 2. 逐个规模抽样、构建、查询
+    std::cout << "\n[2] Sweeping Sizes (" << query_count << " queries per point)..." << std::endl;
+    
+    std::vector<std::vector<SweepPoint>> series(structures.size());
+    for (size_t n : sizes) {
+        std::cout << "\n  ━━━ " << n << " keys ━━━" << std::endl;
+        
+        KeyVector sample(pool.begin(), pool.begin() + n);
+        auto queries = SOSDDataLoader::generate_queries(sample, query_count);
+        
+        for (size_t s = 0; s < structures.size(); ++s) {
+            std::string name = structures[s].substr(0, structures[s].find('/'));
+            size_t slots = (name.size() < structures[s].size()) ? std::stoul(structures[s].substr(name.size() + 1)) : 0;
+            
+            dispatch_matrix_index(name, slots, [&](auto tag) {
+                using Index = typename decltype(tag)::type;
+                series[s].push_back(measure_sweep_point<Index>(structures[s], sample, queries));
+            });
+        }
+    }
+    
+    for (auto& points : series) mark_cache_cliffs(points, cache);
+    
+    // 3. CSV
+    if (csv_path.empty()) csv_path = "sweep_" + dataset_name + ".csv";
+    std::ofstream csv(csv_path, std::ios::trunc);
+    if (csv) {
+        csv << "# dataset=" << dataset_name << " queries=" << query_count << "\n";
+        csv << "# l1d_bytes=" << cache.l1d << " l2_bytes=" << cache.l2 << " llc_bytes=" << cache.llc
+            << " tlb_reach_bytes=" << cache.tlb_reach() << "\n";
+        if (MemoryCalibration::current()) MemoryCalibration::current()->write_metadata(csv);
+        csv << "structure,keys,memory_bytes,fits,ns_per_query,mops,l1d_per_query,llc_per_query,"
+               "dtlb_per_query,dram_equiv,crossed,cliff\n";
+        csv << std::fixed << std::setprecision(4);
+        for (const auto& points : series) {
+            for (const auto& p : points) {
+                csv << p.structure << ',' << p.keys << ',' << p.memory_bytes << ',' << cache.fits(p.memory_bytes) << ','
+                    << p.ns_per_query << ',' << p.mops << ',';
+                if (p.has_l1d) csv << p.l1d_misses; else csv << "nan";
+                csv << ',';
+                if (p.has_llc) csv << p.llc_misses; else csv << "nan";
+                csv << ',';
+                if (p.has_dtlb) csv << p.dtlb_misses; else csv << "nan";
+                csv << ',' << dram_equivalent(p.ns_per_query) << ',' << p.crossed << ',' << (p.cliff ? 1 : 0) << '\n';
+            }
+        }
+    } else {
+        std::cerr << "  ✗ Error: Cannot create " << csv_path << std::endl;
+    }
+    
+    // 4. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Dataset Size Sweep Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Sizes: " << sizes.size()
+              << " | Query Count: " << query_count << " | CSV: " << csv_path << std::endl;
+    
+    std::cout << "\n  ╔═════════════════════════════════════════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Structure             Keys     Memory  Fits  ns/query  Mops/s  L1D/op  LLC/op  TLB/op  Crossed     ║" << std::endl;
+    std::cout << "  ╠═════════════════════════════════════════════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    auto counter = [](bool available, double value) {
+        std::ostringstream os;
+        os << std::fixed << std::setprecision(2);
+        if (available) os << value; else os << "n/a";
+        return os.str();
+    };
+    
+    for (const auto& points : series) {
+        for (const auto& p : points) {
+            std::cout << std::fixed << std::setprecision(2);
+            std::cout << "  ║  " << std::left << std::setw(15) << p.structure << std::right
+                      << std::setw(11) << p.keys
+                      << std::setw(11) << CacheInfo::format_bytes(p.memory_bytes)
+                      << std::setw(6) << cache.fits(p.memory_bytes)
+                      << std::setw(10) << p.ns_per_query
+                      << std::setw(8) << p.mops
+                      << std::setw(8) << counter(p.has_l1d, p.l1d_misses)
+                      << std::setw(8) << counter(p.has_llc, p.llc_misses)
+                      << std::setw(8) << counter(p.has_dtlb, p.dtlb_misses)
+                      << "  " << (p.cliff ? "* " : "  ") << std::left << std::setw(8) << p.crossed
+                      << std::right << "  ║" << std::endl;
+        }
+    }
+    
+    std::cout << "  ╚═════════════════════════════════════════════════════════════════════════════════════════════════════╝" << std::endl;
+    
+    // 断崖：延迟明显跳变的一步，以及这一步内存越过的缓存容量
+    std::cout << "\n  Detected Cliffs (* above):" << std::endl;
+    bool any = false;
+    for (const auto& points : series) {
+        for (size_t i = 1; i < points.size(); ++i) {
+            if (!points[i].cliff) continue;
+            any = true;
+            const auto& a = points[i - 1];
+            const auto& b = points[i];
+            std::cout << std::fixed << std::setprecision(0);
+            std::cout << "    " << b.structure << ": " << a.keys << " -> " << b.keys << " keys, "
+                      << "+" << (b.ns_per_query / a.ns_per_query - 1.0) * 100.0 << "% ns/query, memory "
+                      << CacheInfo::format_bytes(a.memory_bytes) << " -> " << CacheInfo::format_bytes(b.memory_bytes)
+                      << (b.crossed.empty() ? "  (no known capacity crossed)" : "  crosses " + b.crossed) << std::endl;
+        }
+    }
+    if (!any) std::cout << "    none" << std::endl;
+    std::cout << std::endl;
+}
+
+// ==================== 带宽干扰测试 ====================
+
+struct NoiseResult {
+    int level_pct;          // 目标干扰带宽占干扰线程最大带宽的百分比，0 为无干扰
+    double noise_gbs;       // 这一级实际达到的干扰带宽
+    std::string strategy;
+    double ns_per_query;
+    double mops;
+};
+
+/**
+ * 在后台带宽干扰下测试 B+ 树查找：先不限速运行干扰线程得到它们能占用的最大带宽，
+ * 再按 0% / 25% / 50% / 75% / 100% 的目标带宽逐级运行，
+ * 每一级在同一棵树上依次测试不预取和不同距离的叶子预取（软件流水查找）
+ * noise_threads 为 0 时使用硬件线程数 - 1（至少 1 个）
+ */
+void compare_bandwidth_noise(const std::string& dataset_name, unsigned noise_threads = 0,
+                             BandwidthNoise::Pattern pattern = BandwidthNoise::Pattern::Stream,
+                             size_t query_count = 5'000'000) {
+    OutputFormatter::print_header("Bandwidth Interference - " + dataset_name);
+    
+    if (noise_threads == 0) noise_threads = std::max(1u, hardware_threads() - 1);
+    if (noise_threads + 1 > hardware_threads()) {
+        std::cout << "\n  Warning: " << noise_threads << " noise thread(s) + 1 lookup thread > "
+                  << hardware_threads() << " hardware threads; results include CPU sharing" << std::endl;
+    }
+    
+    // 1. 加载数据
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    
+    // 2. 生成查询
+    std::cout << "\n[2] Generating Queries..." << std::endl;
+    query_count = std::min(query_count, keys.size());
+    auto queries = SOSDDataLoader::generate_queries(keys, query_count);
+    std::cout << "    ✓ Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+    
+    // 3. 构建树和干扰缓冲区
+    std::cout << "\n[3] Building Tree (16 slots, bulk_load)..." << std::endl;
+    using Tree = typename CustomBTree<uint64_t, uint64_t, 16, 16>::type;
+    Tree btree;
+    {
+        auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+        btree.bulk_load(pairs.begin(), pairs.end());
+    }
+    KeyVector().swap(keys);
+    
+    CacheInfo cache = CacheInfo::detect();
+    size_t llc = cache.llc ? cache.llc : (size_t(32) << 20);
+    size_t noise_bytes = std::min(std::max(llc * 4, size_t(256) << 20), size_t(1) << 30);
+    BandwidthNoise noise(noise_threads, noise_bytes, pattern);
+    
+    noise.start();
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    double max_gbs = noise.stop();
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "    Noise: " << noise_threads << " " << BandwidthNoise::name(pattern) << " thread(s) over "
+              << CacheInfo::format_bytes(noise.buffer_bytes()) << ", max " << max_gbs << " GB/s" << std::endl;
+    
+    // 4. 逐级干扰 × 预取策略
+    std::cout << "\n[4] Running Lookups under Interference..." << std::endl;
+    
+    const size_t distances[] = {0, 8, 16, 32};
+    const int levels[] = {0, 25, 50, 75, 100};
+    std::vector<NoiseResult> results;
+    
+    for (int level : levels) {
+        std::cout << "\n  ━━━ Interference " << level << "% ━━━" << std::endl;
+        if (level > 0) noise.start(max_gbs * level / 100.0);
+        
+        size_t begin = results.size();
+        for (size_t distance : distances) {
+            size_t found = 0;
+            double ns = run_pipelined_lookups(btree, queries, distance, found);
+            if (found != queries.size()) {
+                OutputFormatter::print_error("Missing keys: " + std::to_string(queries.size() - found));
+            }
+            
+            std::string strategy = distance ? "leaf D=" + std::to_string(distance) : "none";
+            results.push_back({level, 0.0, strategy, ns, 1e3 / ns});
+            std::cout << "    " << std::left << std::setw(12) << strategy << std::right
+                      << std::setw(10) << ns << " ns/query" << std::endl;
+        }
+        
+        double achieved = noise.stop();
+        for (size_t i = begin; i < results.size(); ++i) results[i].noise_gbs = achieved;
+        std::cout << "    Noise achieved: " << achieved << " GB/s" << std::endl;
+    }
+    
+    // 5. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Bandwidth Interference Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Query Count: " << queries.size()
+              << " | Noise: " << noise_threads << " x " << BandwidthNoise::name(pattern)
+              << " | Max " << max_gbs << " GB/s" << std::endl;
+    
+    std::cout << "\n  ╔══════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Level   Noise(GB/s)  Strategy      ns/query   Mops/s  Slowdown  ║" << std::endl;
+    std::cout << "  ╠══════════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    const size_t per_level = sizeof(distances) / sizeof(distances[0]);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        const auto& idle = results[i % per_level];     // 同一策略无干扰时的结果
+        
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::left << std::setw(7) << (std::to_string(r.level_pct) + "%") << std::right
+                  << std::setw(12) << r.noise_gbs
+                  << "  " << std::left << std::setw(12) << r.strategy << std::right
+                  << std::setw(10) << r.ns_per_query
+                  << std::setw(9) << r.mops
+                  << std::setw(9) << r.ns_per_query / idle.ns_per_query << "x  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚══════════════════════════════════════════════════════════════════╝" << std::endl;
+    
+    // 每一级最好的策略
+    std::cout << "\n  Best strategy per level:" << std::endl;
+    for (size_t begin = 0; begin < results.size(); begin += per_level) {
+        size_t best = begin;
+        for (size_t i = begin; i < begin + per_level; ++i) {
+            if (results[i].ns_per_query < results[best].ns_per_query) best = i;
+        }
+        std::cout << "    " << std::setw(4) << results[begin].level_pct << "%: " << results[best].strategy
+                  << "  (" << results[begin].ns_per_query / results[best].ns_per_query << "x vs none)" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// ==================== 查询间合成负载测试 ====================
+
+/**
+ * 每次查找之后执行一次合成负载，返回每个查询（查找 + 负载）的平均耗时
+ * 负载的输入依赖查找结果，查找和负载不能被编译器或乱序执行完全拆开
+ */
+template<typename Tree>
+double run_lookups_with_work(const Tree& btree, const KeyVector& queries, size_t distance,
+                             SyntheticWork& work, size_t& found) {
+    const size_t n = queries.size();
+    found = 0;
+    uint64_t acc = 0;
+    
+    Timer timer;
+    for (size_t i = 0; i < n; ++i) {
+        if (distance && i + distance < n) {
+            btree.prefetch_leaf(queries[i + distance]);
+        }
+        bool hit = btree.find(queries[i]) != btree.end();
+        found += hit;
+        acc = work.run(acc ^ queries[i] ^ hit);
+    }
+    double ns = (timer.elapsed_ms() * 1e6) / n;
+    
+    volatile uint64_t sink = acc;
+    (void)sink;
+    return ns;
+}
+
+/**
+ * 只执行合成负载（输入序列和查找时相同），返回每次负载的平均耗时
+ */
+double time_synthetic_work(SyntheticWork& work, const KeyVector& queries) {
+    uint64_t acc = 0;
+    
+    Timer timer;
+    for (uint64_t q : queries) acc = work.run(acc ^ q ^ 1);
+    double ns = (timer.elapsed_ms() * 1e6) / queries.size();
+    
+    volatile uint64_t sink = acc;
+    (void)sink;
+    return ns;
+}
+
+/**
+ * 有效查找开销 = 总耗时 - 负载单独执行的耗时。负载与查找缺失乱序重叠、
+ * 或单独执行反而更慢时差值可能 <= 0，无法扣除，返回 0（输出为 n/a）
+ */
+inline double effective_lookup_ns(double total_ns, double work_ns) {
+    return std::max(0.0, total_ns - work_ns);
+}
+
+struct WorkResult {
+    std::string work;
+    double work_ns;         // 单独执行负载的耗时
+    size_t distance;
+    double total_ns;        // 查找 + 负载
+    double lookup_ns;       // effective_lookup_ns()，0 表示无法扣除
+};
+
+/**
+ * 查询之间插入合成负载时的 B+ 树查找开销：
+ * 对每种负载（计算迭代次数[:每次污染字节数]）测量负载单独的耗时，
+ * 再在同一棵树上测试不预取和不同距离的叶子预取，有效查找开销 = 总耗时 - 负载耗时。
+ * 污染负载会把树的上层节点挤出缓存，计算负载给预取留出时间，最佳预取距离随之变化。
+ */
+void compare_synthetic_work(const std::string& dataset_name,
+                            std::vector<std::string> specs = {},
+                            size_t query_count = 2'000'000) {
+    OutputFormatter::print_header("Interleaved Synthetic Work - " + dataset_name);
+    
+    if (specs.empty()) specs = {"0", "50", "200", "800", "0:4k", "0:32k", "200:4k"};
+    std::vector<std::pair<unsigned, size_t>> configs;
+    for (const auto& s : specs) {
+        unsigned compute = 0;
+        size_t bytes = 0;
+        if (!SyntheticWork::parse(s, compute, bytes)) {
+            std::cerr << "  ✗ Error: Unknown work spec '" << s << "' (expected <compute>[:<bytes>])" << std::endl;
+            return;
+        }
+        configs.emplace_back(compute, bytes);
+    }
+    
+    // 1. 加载数据
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    
+    // 2. 生成查询
+    std::cout << "\n[2] Generating Queries..." << std::endl;
+    query_count = std::min(query_count, keys.size());
+    auto queries = SOSDDataLoader::generate_queries(keys, query_count);
+    std::cout << "    ✓ Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+    
+    // 3. 构建树
+    std::cout << "\n[3] Building Tree (16 slots, bulk_load)..." << std::endl;
+    using Tree = typename CustomBTree<uint64_t, uint64_t, 16, 16>::type;
+    Tree btree;
+    {
+        auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+        btree.bulk_load(pairs.begin(), pairs.end());
+    }
+    KeyVector().swap(keys);
+    
+    // 4. 负载 × 预取距离
+    std::cout << "\n[4] Running Lookups with Interleaved Work..." << std::endl;
+    
+    const size_t distances[] = {0, 4, 8, 16, 32};
+    std::vector<WorkResult> results;
+    
+    for (size_t c = 0; c < configs.size(); ++c) {
+        SyntheticWork work(configs[c].first, configs[c].second);
+        
+        time_synthetic_work(work, queries);     // 预热污染缓冲区
+        double work_ns = time_synthetic_work(work, queries);
+        
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "\n  ━━━ Work " << specs[c] << " (" << work.describe() << "): "
+                  << work_ns << " ns ━━━" << std::endl;
+        
+        for (size_t distance : distances) {
+            size_t found = 0;
+            double total = run_lookups_with_work(btree, queries, distance, work, found);
+            if (found != queries.size()) {
+                OutputFormatter::print_error("Missing keys: " + std::to_string(queries.size() - found));
+            }
+            
+            double lookup = effective_lookup_ns(total, work_ns);
+            results.push_back({specs[c], work_ns, distance, total, lookup});
+            std::cout << "    D=" << std::left << std::setw(4) << distance << std::right
+                      << std::setw(10) << total << " ns total";
+            if (lookup > 0) {
+                std::cout << std::setw(10) << lookup << " ns lookup" << std::endl;
+            } else {
+                std::cout << "       n/a lookup (work >= total)" << std::endl;
+            }
+        }
+    }
+    
+    // 5. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Interleaved Synthetic Work Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Query Count: " << queries.size()
+              << " | Work: <compute iters>[:<bytes polluted per lookup>]" << std::endl;
+    
+    std::cout << "\n  ╔═══════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Work          Work(ns)    D  Total(ns)  Lookup(ns)   vs D=0  ║" << std::endl;
+    std::cout << "  ╠═══════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    const size_t per_work = sizeof(distances) / sizeof(distances[0]);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        const auto& base = results[i - i % per_work];   // 同一负载不预取时的结果
+        
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::left << std::setw(12) << r.work << std::right
+                  << std::setw(10) << r.work_ns
+                  << std::setw(5) << r.distance
+                  << std::setw(11) << r.total_ns;
+        if (r.lookup_ns > 0) {
+            std::cout << std::setw(12) << r.lookup_ns;
+        } else {
+            std::cout << std::setw(12) << "n/a";
+        }
+        std::cout << std::setw(8) << base.total_ns / r.total_ns << "x  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚═══════════════════════════════════════════════════════════════╝" << std::endl;
+    
+    for (const auto& r : results) {
+        if (r.lookup_ns > 0) continue;
+        std::cout << "\n  Warning: some work ran at least as long alone as interleaved with lookups;"
+                  << "\n           their lookup cost cannot be separated (n/a)" << std::endl;
+        break;
+    }
+    
+    // 每种负载下最好的预取距离
+    std::cout << "\n  Best distance per work:" << std::endl;
+    for (size_t begin = 0; begin < results.size(); begin += per_work) {
+        size_t best = begin;
+        for (size_t i = begin; i < begin + per_work; ++i) {
+            if (results[i].total_ns < results[best].total_ns) best = i;
+        }
+        std::cout << "    " << std::left << std::setw(10) << results[begin].work << std::right
+                  << "D=" << results[best].distance << "  lookup ";
+        if (results[best].lookup_ns > 0) {
+            std::cout << results[best].lookup_ns << " ns";
+        } else {
+            std::cout << "n/a";
+        }
+        std::cout << "  (" << results[begin].total_ns / results[best].total_ns << "x vs D=0)" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// ==================== 缓存模拟测试 ====================
+
+struct CacheSimConfig {
+    int slot_size;
+    size_t depth;
+    size_t memory_bytes;
+    CacheSimulator::Result result;
+    double predicted_ns;    // 按校准的各级延迟串行累加，未校准时为 0
+};
+
+/**
+ * 各级命中次数 × 校准的各级延迟（不考虑访存重叠，是串行执行时的上界）
+ */
+double predict_lookup_ns(const CacheSimulator::Result& r) {
+    const auto& calibration = MemoryCalibration::current();
+    if (!calibration || calibration->levels.size() < 4 || r.queries == 0) return 0.0;
+    
+    const auto& lv = calibration->levels;     // L1 / L2 / LLC / DRAM
+    double l1_hits = double(r.line_accesses - r.misses[CacheSimulator::L1]);
+    double l2_hits = double(r.misses[CacheSimulator::L1] - r.misses[CacheSimulator::L2]);
+    double llc_hits = double(r.misses[CacheSimulator::L2] - r.misses[CacheSimulator::LLC]);
+    double dram = double(r.misses[CacheSimulator::LLC]);
+    return (l1_hits * lv[0].ns + l2_hits * lv[1].ns + llc_hits * lv[2].ns + dram * lv[3].ns) / r.queries;
+}
+
+/**
+ * 打印重用距离直方图：按 4 倍递增的字节区间合并桶，并标出各级缓存容量
+ */
+void print_reuse_histogram(const CacheSimulator::Result& r, const CacheSimulator& sim) {
+    std::cout << "    Reuse distance (distinct bytes between reuses of a line):" << std::endl;
+    
+    size_t k = 0;
+    double cumulative = 0.0;
+    for (size_t upper = 4096; k < r.reuse_histogram.size(); upper *= 4) {
+        uint64_t count = 0;
+        for (; k < r.reuse_histogram.size() &&
+               (size_t(1) << k) * CacheSimulator::line_bytes <= upper; ++k) {
+            count += r.reuse_histogram[k];
+        }
+        if (count == 0) continue;
+        
+        double pct = 100.0 * count / r.line_accesses;
+        cumulative += pct;
+        std::string marks;
+        for (auto level : {CacheSimulator::L1, CacheSimulator::L2, CacheSimulator::LLC}) {
+            if (sim.capacity(level) <= upper && sim.capacity(level) > upper / 4) {
+                marks += std::string(marks.empty() ? "  <- " : ", ") + CacheSimulator::name(level);
+            }
+        }
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "      < " << std::left << std::setw(9) << CacheInfo::format_bytes(upper) << std::right
+                  << std::setw(7) << pct << "%" << std::setw(9) << cumulative << "% cum" << marks << std::endl;
+    }
+    std::cout << "      cold     " << std::setw(8) << 100.0 * r.cold / r.line_accesses << "%" << std::endl;
+}
+
+/**
+ * 构建指定 slot size 的树，用 find_trace() 记录查找的访存轨迹并回放到缓存 / TLB 模拟器
+ * 不计时，也不需要硬件计数器；trace_prefix 非空时把轨迹写到 <prefix>_<slots>.trace
+ */
+template<int SlotSize>
+CacheSimConfig simulate_slot_size(const std::vector<std::pair<uint64_t, uint64_t>>& pairs,
+                                  const KeyVector& queries, size_t warmup,
+                                  const std::string& trace_prefix, const CacheInfo& cache) {
+    using Tree = typename CustomBTree<uint64_t, uint64_t, SlotSize, SlotSize>::type;
+    
+    std::cout << "\n  ━━━ Slot Size: " << SlotSize << " ━━━" << std::endl;
+    
+    Tree btree;
+    btree.bulk_load(pairs.begin(), pairs.end());
+    
+    NodeTrace trace;
+    size_t found = 0;
+    for (const auto& q : queries) {
+        if (btree.find_trace(q, trace) != btree.end()) found++;
+    }
+    if (found != queries.size()) {
+        OutputFormatter::print_error("Missing keys: " + std::to_string(queries.size() - found));
+    }
+    
+    if (!trace_prefix.empty()) {
+        std::string path = trace_prefix + "_" + std::to_string(SlotSize) + ".trace";
+        std::ofstream out(path);
+        trace.write(out);
+        std::cout << "    Trace: " << trace.accesses().size() << " reads -> " << path << std::endl;
+    }
+    
+    CacheSimulator sim(cache);
+    CacheSimConfig config{SlotSize, 0, index_memory_bytes(btree), sim.replay(trace, warmup), 0.0};
+    const auto& r = config.result;
+    config.depth = r.depth_misses.size();
+    config.predicted_ns = predict_lookup_ns(r);
+    
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "    Misses per query by level:      L1d       L2      LLC      TLB" << std::endl;
+    for (size_t d = 0; d < r.depth_misses.size(); ++d) {
+        std::cout << "      L" << d << (d + 1 == r.depth_misses.size() ? " (leaf)" : "       ")
+                  << std::string(17, ' ');
+        for (uint64_t m : r.depth_misses[d]) std::cout << std::setw(9) << double(m) / r.queries;
+        std::cout << std::endl;
+    }
+    std::cout << "      Total" << std::string(22, ' ');
+    for (auto level : {CacheSimulator::L1, CacheSimulator::L2, CacheSimulator::LLC, CacheSimulator::TLB}) {
+        std::cout << std::setw(9) << r.per_query(level);
+    }
+    std::cout << std::endl;
+    
+    print_reuse_histogram(r, sim);
+    return config;
+}
+
+/**
+ * 不实际计时，用缓存 / TLB 模拟器预测各 slot size 的查找缺失数并排序：
+ * 每个 slot size 只需 bulk_load 一次再跑少量插桩查找，不依赖硬件计数器，结果可复现。
+ * 前 20% 的查询只用来预热模拟的缓存。
+ */
+void compare_simulated_slot_sizes(const std::string& dataset_name, size_t query_count = 200'000,
+                                  const std::string& trace_prefix = "") {
+    OutputFormatter::print_header("Simulated Cache Misses - " + dataset_name);
+    
+    // 1. 加载数据
+    std::cout << "\n[1] Loading Data..." << std::endl;
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader::load_binary_file(data_file);
+    if (keys.empty()) {
+        std::cerr << "  ✗ Error: Failed to load " << data_file << std::endl;
+        return;
+    }
+    auto pairs = SOSDDataLoader::to_sorted_pairs(keys);
+    
+    // 2. 生成查询
+    std::cout << "\n[2] Generating Queries..." << std::endl;
+    query_count = std::min(query_count, keys.size());
+    auto queries = SOSDDataLoader::generate_queries(keys, query_count);
+    std::cout << "    ✓ Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+    KeyVector().swap(keys);
+    
+    CacheInfo cache = CacheInfo::detect();
+    CacheSimulator sim(cache);
+    std::cout << "    Simulated: ";
+    for (auto level : {CacheSimulator::L1, CacheSimulator::L2, CacheSimulator::LLC, CacheSimulator::TLB}) {
+        std::cout << CacheSimulator::name(level) << " " << CacheInfo::format_bytes(sim.capacity(level))
+                  << "/" << sim.ways(level) << "-way" << (level == CacheSimulator::TLB ? "" : ", ");
+    }
+    std::cout << " (4 KB pages)" << std::endl;
+    
+    // 3. 逐个 slot size 回放
+    std::cout << "\n[3] Replaying Lookup Traces..." << std::endl;
+    
+    size_t warmup = queries.size() / 5;
+    std::vector<CacheSimConfig> configs;
+    configs.push_back(simulate_slot_size<16>(pairs, queries, warmup, trace_prefix, cache));
+    configs.push_back(simulate_slot_size<24>(pairs, queries, warmup, trace_prefix, cache));
+    configs.push_back(simulate_slot_size<32>(pairs, queries, warmup, trace_prefix, cache));
+    configs.push_back(simulate_slot_size<40>(pairs, queries, warmup, trace_prefix, cache));
+    configs.push_back(simulate_slot_size<48>(pairs, queries, warmup, trace_prefix, cache));
+    configs.push_back(simulate_slot_size<56>(pairs, queries, warmup, trace_prefix, cache));
+    configs.push_back(simulate_slot_size<64>(pairs, queries, warmup, trace_prefix, cache));
+    configs.push_back(simulate_slot_size<80>(pairs, queries, warmup, trace_prefix, cache));
+    
+    // 4. 汇总对比
+    std::cout << "\n" << std::endl;
+    OutputFormatter::print_header("Simulated Cache Misses Summary");
+    
+    std::cout << "\n  Dataset: " << dataset_name << " | Traced Queries: " << queries.size()
+              << " (" << warmup << " warm-up) | Misses per query" << std::endl;
+    
+    std::cout << "\n  ╔══════════════════════════════════════════════════════════════════════════════╗" << std::endl;
+    std::cout << "  ║  Slots  Depth     Memory  Lines/q   L1d/q    L2/q   LLC/q   TLB/q  Pred(ns)  ║" << std::endl;
+    std::cout << "  ╠══════════════════════════════════════════════════════════════════════════════╣" << std::endl;
+    
+    for (const auto& c : configs) {
+        const auto& r = c.result;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "  ║  " << std::left << std::setw(6) << c.slot_size << std::right
+                  << std::setw(6) << c.depth
+                  << std::setw(11) << CacheInfo::format_bytes(c.memory_bytes)
+                  << std::setw(9) << double(r.line_accesses) / r.queries
+                  << std::setw(8) << r.per_query(CacheSimulator::L1)
+                  << std::setw(8) << r.per_query(CacheSimulator::L2)
+                  << std::setw(8) << r.per_query(CacheSimulator::LLC)
+                  << std::setw(8) << r.per_query(CacheSimulator::TLB);
+        if (c.predicted_ns > 0) std::cout << std::setw(10) << c.predicted_ns;
+        else std::cout << std::setw(10) << "-";
+        std::cout << "  ║" << std::endl;
+    }
+    
+    std::cout << "  ╚══════════════════════════════════════════════════════════════════════════════╝" << std::endl;
+    
+    // 排序：校准过时按预测延迟，否则依次按 LLC / TLB / L2 缺失
+    bool calibrated = configs.front().predicted_ns > 0;
+    std::vector<const CacheSimConfig*> ranking;
+    for (const auto& c : configs) ranking.push_back(&c);
+    std::stable_sort(ranking.begin(), ranking.end(), [calibrated](const CacheSimConfig* a, const CacheSimConfig* b) {
+        if (calibrated) return a->predicted_ns < b->predicted_ns;
+        const auto& x = a->result.misses;
+        const auto& y = b->result.misses;
+        return std::make_tuple(x[CacheSimulator::LLC], x[CacheSimulator::TLB], x[CacheSimulator::L2]) <
+               std::make_tuple(y[CacheSimulator::LLC], y[CacheSimulator::TLB], y[CacheSimulator::L2]);
+    });
+    
+    std::cout << "\n  Predicted ranking ("
+              << (calibrated ? "serial latency from --calibrate" : "LLC, then TLB, then L2 misses; use --calibrate for ns")
+              << "):" << std::endl;
+    for (size_t i = 0; i < ranking.size(); ++i) {
+        std::cout << "    " << i + 1 << ". " << std::setw(2) << ranking[i]->slot_size << " slots" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// ==================== 单个数据集测试 ====================
+
+/**
+ * 在已加载的数据和查询上构建并测试一个索引结构
+ */
+template<typename Index>
+void run_sosd_index(BenchmarkResult& result, const std::string& index_name,
+                    const KeyVector& keys,
+                    const KeyVector& queries) {
+    // 3. 构建索引
+    OutputFormatter::print_subheader("[3] Building " + index_name);
+    Index index;
+    
+    double build_time_ms = build_index(index, keys, &result.sort_time_ms);
+    
+    result.build_time_ms = build_time_ms;
+    result.insert_throughput = (keys.size() / build_time_ms) * 1000.0 / 1e6;
+    
+    std::cout << std::fixed << std::setprecision(2);
+    if constexpr (is_bulk_load_only<Index>::value) {
+        std::cout << "    Sort + Dedup: " << result.sort_time_ms << " ms" << std::endl;
+    }
+    std::cout << "    Build Time:  " << build_time_ms << " ms" << std::endl;
+    std::cout << "    Insert Throughput: " << result.insert_throughput << " M ops/s" << std::endl;
+    
+    // 4. 结构统计
+    OutputFormatter::print_subheader("[4] Index Structure");
+    if constexpr (has_tree_stats<Index>::value) {
+        auto tree_stats = TreeStatistics:: collect(index);
+        tree_stats.print();
+    } else {
+        auto index_stats = IndexStatistics::collect(index, index_name);
+        index_stats.print();
+    }
+    
+    // 5. 执行查询
+    OutputFormatter::print_subheader("[5] Running Queries");
+    
+    SyntheticWork work(WorkConfig::compute(), WorkConfig::pollute_bytes());
+    uint64_t acc = 0;
+    
+    Timer query_timer;
+    size_t found = 0;
+    
+    if (!work.enabled()) {
+        for (const auto& q :  queries) {
+            auto it = index.find(q);
+            if (it != index.end()) {
+                found++;
+            }
+        }
+    } else {
+        // --work：每次查找后执行合成负载，负载的输入依赖查找结果
+        for (const auto& q : queries) {
+            bool hit = index.find(q) != index.end();
+            found += hit;
+            acc = work.run(acc ^ q ^ hit);
+        }
+    }
+    
+    double query_time_ms = query_timer.elapsed_ms();
+    volatile uint64_t sink = acc;
+    (void)sink;
+    
+    // 负载单独计时（先预热污染缓冲区）后从总时间中扣除，吞吐和延迟都按扣除后的有效查找时间计算
+    double work_ns = 0.0;
+    if (work.enabled()) {
+        time_synthetic_work(work, queries);
+        work_ns = time_synthetic_work(work, queries);
+    }
+    double lookup_ns = effective_lookup_ns((query_time_ms * 1e6) / queries.size(), work_ns);
+    
+    // 无法扣除负载时吞吐、延迟都记为 0，输出 n/a
+    result.query_time_ms = query_time_ms;
+    result.search_throughput = (lookup_ns > 0) ? 1000.0 / lookup_ns : 0.0;
+    result.avg_latency_ns = lookup_ns;
+    result.work_ns = work_ns;
+    result.dram_equivalent = (lookup_ns > 0) ? dram_equivalent(lookup_ns) : 0.0;
+    result.hits = found;
+    result.hit_rate = (found * 100.0) / queries.size();
+    
+    std::cout << "\n  ┌─ Query Performance ─────────────────────" << std::endl;
+    std::cout << "  │ Total Time:       " << query_time_ms << " ms" << std::endl;
+    std::cout << "  │ Query Count:      " << queries.size() << std::endl;
+    if (lookup_ns > 0) {
+        std::cout << "  │ Throughput:       " << result.search_throughput << " M ops/s"
+                  << (work.enabled() ? " (total - work)" : "") << std::endl;
+    } else {
+        std::cout << "  │ Throughput:       n/a" << std::endl;
+    }
+    if (work.enabled()) {
+        std::cout << "  │ Work / Query:     " << result.work_ns << " ns (" << work.describe() << ")" << std::endl;
+        if (lookup_ns > 0) {
+            std::cout << "  │ Effective Lookup: " << result.avg_latency_ns << " ns/query (total - work)" << std::endl;
+        } else {
+            std::cout << "  │ Effective Lookup: n/a (work alone took at least the total time)" << std::endl;
+        }
+    } else {
+        std::cout << "  │ Avg Latency:      " << result.avg_latency_ns << " ns/query" << std::endl;
+    }
+    if (result.dram_equivalent > 0) {
+        std::cout << "  │ DRAM Misses Eq.:  " << result.dram_equivalent << " per lookup" << std::endl;
+    }
+    std::cout << "  │ Hit Rate:         " << result.hit_rate << " %" << std::endl;
+    std::cout << "  │ Hits:             " << found << " / " << queries.size() << std::endl;
+    std::cout << "  └─────────────────────────────────────────" << std::endl;
+    
+    std::cout << "\n  Verification:   " << (found > 0 ? "✓ PASSED" : "✗ FAILED") << std::endl;
+}
+
+/**
+ * 测试单个数据集，structures 中的每个结构共用同一份数据和查询
+ * 可选结构：stx（BTree64，默认 16 slots）、stree（静态 S-tree）、eytzinger、
+ *           rmi / rmi_prefetch、pgm / pgm_prefetch（学习索引）、
+ *           art（逐个插入构建）/ art_bulk（有序批量构建）、
+ *           cbtree（叶子差值压缩的静态 B+ 树）
+ */
+std::vector<BenchmarkResult> test_sosd_dataset(const std::string& dataset_name,
+                                               const std::vector<std::string>& structures = {"stx"},
+                                               size_t query_count = 10'000'000) {
+    std::vector<BenchmarkResult> results;
+    
+    OutputFormatter::print_header("Test:  SOSD Dataset - " + dataset_name);
+    
+    // 1. 加载数据
+    OutputFormatter::print_subheader("[1] Loading Data");
+    
+    std::string data_file = SOSDDataLoader::dataset_path(dataset_name);
+    auto keys = SOSDDataLoader:: load_binary_file(data_file);
+    
+    if (keys.empty()) {
+        OutputFormatter::print_error("Failed to load:   " + data_file);
+        return results;
+    }
+    
+    std::cout << "    Loaded " << keys.size() << " keys" << std::endl;
+    query_count = std::min(query_count, keys.size());
+    
+    // 2. 生成查询
+    OutputFormatter::print_subheader("[2] Generating Queries");
+    auto queries = SOSDDataLoader::generate_queries(keys, query_count);
+    std::cout << "    Generated " << queries.size() << " queries ("
+              << PageRegistry::instance().backing(queries.data()) << " pages)" << std::endl;
+    
+    for (const auto& structure : structures) {
+        BenchmarkResult result;
+        result.test_name = dataset_name + " [" + structure + "]";
+        result.data_size = keys.size();
+        result.query_count = queries.size();
+        
+        if (structure == "stx") {
+            run_sosd_index<BTree64>(result, "B+ Tree (Default:  16 slots)", keys, queries);
+        } else if (structure == "stree") {
+            run_sosd_index<STree64>(result, "S-Tree (64B nodes)", keys, queries);
+        } else if (structure == "eytzinger") {
+            run_sosd_index<Eytzinger64>(result, "Eytzinger Array (prefetch 4 levels)", keys, queries);
+        } else if (structure == "rmi") {
+            run_sosd_index<RMI64>(result, "Two-Stage RMI", keys, queries);
+        } else if (structure == "rmi_prefetch") {
+            run_sosd_index<RMI64Prefetch>(result, "Two-Stage RMI (prefetch)", keys, queries);
+        } else if (structure == "pgm") {
+            run_sosd_index<PGM64>(result, "PGM Index (eps=64)", keys, queries);
+        } else if (structure == "pgm_prefetch") {
+            run_sosd_index<PGM64Prefetch>(result, "PGM Index (eps=64, prefetch)", keys, queries);
+        } else if (structure == "art") {
+            run_sosd_index<ART64>(result, "Adaptive Radix Tree (insert)", keys, queries);
+        } else if (structure == "art_bulk") {
+            run_sosd_index<BulkART64>(result, "Adaptive Radix Tree (bulk)", keys, queries);
+        } else if (structure == "cbtree") {
+            run_sosd_index<CompressedBTree64>(result, "Compressed B+ Tree (delta leaves)", keys, queries);
+        } else {
+            OutputFormatter::print_error("Unknown structure: " + structure);
+            continue;
+        }
+        
+        results.push_back(result);
+    }
+    
+    return results;
+}
+
+// ==================== 主程序 ====================
+
+/**
+ * 命令行中逗号分隔的列表（数据集、结构、负载等），忽略空项
+ */
+std::vector<std::string> split_list(const std::string& list) {
+    std::vector<std::string> items;
+    for (size_t pos = 0; pos <= list.size(); ) {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) comma = list.size();
+        if (comma > pos) items.push_back(list.substr(pos, comma - pos));
+        pos = comma + 1;
+    }
+    return items;
+}
+
+int main(int argc, char* argv[]) {
+    OutputFormatter::print_header("B+ Tree Performance Benchmark Framework");
+    
+    std::cout << "\n  SOSD B+ Tree (STX) Performance Testing" << std::endl;
+    std::cout << "  Default Slot Size: 16" << std::endl;
+    
+    // 全局选项，解析后从参数中移除：
+    //   --pages=4k|thp|2m|1g  key / 查询缓冲区的页大小
+    //   --trace=<file>        查询负载改为回放 trace 中的点查
+    //   --record=<file>       把生成的查询负载录制成 trace
+    //   --calibrate           运行测试前先测量访存延迟 / MLP / 带宽
+    //   --work=<c>[:<bytes>]  单数据集测试中每次查找后执行合成负载（计算迭代次数[:污染字节数]）
+    std::vector<char*> args;
+    bool calibrate = false;
+    for (int i = 0; i < argc; ++i) {
+        std::string opt = argv[i];
+        if (opt.rfind("--pages=", 0) == 0) {
+            PageMode mode;
+            if (!PageConfig::parse(opt.substr(8), mode)) {
+                std::cerr << "  Unknown page size: " << opt.substr(8) << " (4k, thp, 2m, 1g)" << std::endl;
+                return 1;
+            }
+            PageConfig::mode() = mode;
+        } else if (opt.rfind("--trace=", 0) == 0) {
+            TraceConfig::replay_path() = opt.substr(8);
+        } else if (opt.rfind("--record=", 0) == 0) {
+            TraceConfig::record_path() = opt.substr(9);
+        } else if (opt == "--calibrate") {
+            calibrate = true;
+        } else if (opt.rfind("--work=", 0) == 0) {
+            if (!SyntheticWork::parse(opt.substr(7), WorkConfig::compute(), WorkConfig::pollute_bytes())) {
+                std::cerr << "  Unknown work spec: " << opt.substr(7) << " (<compute>[:<bytes>], e.g. 200:4k)" << std::endl;
+                return 1;
+            }
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+    argc = static_cast<int>(args.size());
+    argv = args.data();
+    
+    std::cout << "  Buffer Pages: " << PageConfig::name(PageConfig::mode()) << std::endl;
+    if (!TraceConfig::replay_path().empty()) {
+        std::cout << "  Query Trace:  " << TraceConfig::replay_path() << std::endl;
+    }
+    std::cout << "  ────────────────────────────────────────" << std::endl;
+    
+    if (calibrate || (argc > 1 && std::string(argv[1]) == "calibrate")) {
+        run_memory_calibration();
+    }
+    
+    if (argc > 1) {
+        std::string arg = argv[1];
+        
+        // 生成数据
+        if (arg == "generate") {
+            if (argc < 4) {
+                std::cout << "\n  Usage: ./prefetch_bench generate <size> <type> [seed]" << std::endl;
+                std::cout << "  Types: random, sorted, partial (1..N)" << std::endl;
+                std::cout << "         uniform, normal, lognormal, clustered, zipf, sosd (synthetic, seed default 42)" << std::endl;
+                std::cout << "  Example: ./prefetch_bench generate 200000000 random" << std::endl;
+                std::cout << "  Example: ./prefetch_bench generate 1000000000 sosd 7" << std::endl;
+                return 1;
+            }
+            
+            size_t size = std::stoull(argv[2]);
+            std::string type = argv[3];
+            std::string filename = "data/custom_" + type + "_" + std::to_string(size) + "_uint64";
+            
+            std:: cout << "\n  Generating custom dataset..." << std::endl;
+            
+            SyntheticGenerator::Distribution dist;
+            if (SyntheticGenerator::parse(type, dist)) {
+                uint64_t seed = (argc > 4) ? std::stoull(argv[4]) : 42;
+                SyntheticGenerator generator(dist, size, seed);
+                if (!generator.save(filename)) return 1;
+            } else if (type == "random") {
+                DataGenerator::generate_and_save_random(size, filename);
+            } else if (type == "sorted") {
+                DataGenerator::generate_and_save_sorted(size, filename);
+            } else if (type == "partial") {
+                DataGenerator::generate_and_save_partial(size, filename);
+            } else {
+                std::cerr << "  Unknown type: " << type << std:: endl;
+                return 1;
+            }
+            
+            std::cout << "  ✓ Dataset generated successfully!" << std::endl;
+            std::cout << "\n  To test it:" << std::endl;
+            std::cout << "    ./prefetch_bench custom_" << type << "_" << size << std::endl;
+            std::cout << "  To compare slot sizes:" << std::endl;
+            std::cout << "    ./prefetch_bench compare custom_" << type << "_" << size << std::endl;
+            
+            return 0;
         }
         
         // Slot size 对比测试
         if (arg == "compare") {
             if (argc < 3) {
-                std::cout << "\n  Usage: ./prefetch_bench compare <dataset>" << std::endl;
+                std::cout << "\n  Usage: ./prefetch_bench compare <dataset> [stx|csb]" << std::endl;
                 std::cout << "  Example: ./prefetch_bench compare books_200M" << std::endl;
                 std::cout << "           ./prefetch_bench compare custom_random_200000000" << std::endl;
                 return 1;
             }
             
             std::string dataset = argv[2];
-            compare_slot_sizes(dataset);
+            std::string structure = (argc > 3) ? argv[3] : "stx";
+            if (structure != "stx" && structure != "csb") {
+                std::cerr << "  Unknown structure: " << structure << std::endl;
+                return 1;
+            }
+            compare_slot_sizes(dataset, structure);
+            return 0;
+        }
+        
+        // 批量插入对比测试
+        if (arg == "batch") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench batch <dataset>" << std::endl;
+                std::cout << "  Example: ./prefetch_bench batch books_200M" << std::endl;
+                return 1;
+            }
+            
+            compare_batch_insert(argv[2]);
+            return 0;
+        }
+        
+        // 基数表下降对比测试
+        if (arg == "radix") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench radix <dataset>" << std::endl;
+                std::cout << "  Example: ./prefetch_bench radix books_200M" << std::endl;
+                return 1;
+            }
+            
+            compare_radix_table(argv[2]);
+            return 0;
+        }
+        
+        // 按层耗时分解测试
+        if (arg == "levels") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench levels <dataset>" << std::endl;
+                std::cout << "  Example: ./prefetch_bench levels books_200M" << std::endl;
+                return 1;
+            }
+            
+            compare_level_cycles(argv[2]);
+            return 0;
+        }
+        
+        // 插入构建 vs 批量构建对比测试
+        if (arg == "fill") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench fill <dataset>" << std::endl;
+                std::cout << "  Example: ./prefetch_bench fill books_200M" << std::endl;
+                return 1;
+            }
+            
+            compare_build_fill(argv[2]);
+            return 0;
+        }
+        
+        // 软件流水查找测试
+        if (arg == "pipeline") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench pipeline <dataset> [distance]" << std::endl;
+                std::cout << "  Example: ./prefetch_bench pipeline books_200M      # sweep distances" << std::endl;
+                std::cout << "           ./prefetch_bench pipeline books_200M 16" << std::endl;
+                return 1;
+            }
+            
+            size_t distance = (argc > 3) ? std::stoull(argv[3]) : 0;
+            compare_prefetch_distance(argv[2], distance);
+            return 0;
+        }
+        
+        // 预取策略对比测试
+        if (arg == "policy") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench policy <dataset> [distance]" << std::endl;
+                std::cout << "  Example: ./prefetch_bench policy books_200M" << std::endl;
+                std::cout << "           ./prefetch_bench policy books_200M 8" << std::endl;
+                return 1;
+            }
+            
+            size_t distance = (argc > 3) ? std::stoull(argv[3]) : 16;
+            compare_prefetch_policies(argv[2], distance);
+            return 0;
+        }
+        
+        // 叶子布局对比测试
+        if (arg == "layout") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench layout <dataset>" << std::endl;
+                std::cout << "  Example: ./prefetch_bench layout books_200M" << std::endl;
+                return 1;
+            }
+            
+            compare_leaf_layouts(argv[2]);
+            return 0;
+        }
+        
+        // 孩子指针压缩对比测试
+        if (arg == "childref") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench childref <dataset>" << std::endl;
+                std::cout << "  Example: ./prefetch_bench childref books_200M" << std::endl;
+                return 1;
+            }
+            
+            compare_child_pointers(argv[2]);
+            return 0;
+        }
+        
+        // 叶子差值压缩对比测试，可选逗号分隔的数据集列表
+        if (arg == "compress") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench compress <dataset>[,<dataset>...]" << std::endl;
+                std::cout << "  Example: ./prefetch_bench compress books_200M,fb_200M,osm_cellids_200M" << std::endl;
+                return 1;
+            }
+            
+            std::vector<std::string> datasets = split_list(argv[2]);
+            
+            compare_compressed_leaves(datasets);
+            return 0;
+        }
+        
+        // 快照启动对比测试
+        if (arg == "snapshot") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench snapshot <dataset> [img] [--rewrite]" << std::endl;
+                std::cout << "  Starts from an existing image; --rewrite (or a missing image) rebuilds and writes it" << std::endl;
+                std::cout << "  Example: ./prefetch_bench snapshot books_200M data/books_200M.snap" << std::endl;
+                return 1;
+            }
+            
+            std::string image;
+            bool rewrite = false;
+            for (int i = 3; i < argc; ++i) {
+                if (std::string(argv[i]) == "--rewrite") rewrite = true;
+                else image = argv[i];
+            }
+            compare_snapshot_startup(argv[2], image, rewrite);
+            return 0;
+        }
+        
+        // 排序 + 去重阶段对比测试
+        if (arg == "sort") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench sort <dataset> [threads]" << std::endl;
+                std::cout << "  Example: ./prefetch_bench sort books_200M 16" << std::endl;
+                return 1;
+            }
+            
+            compare_sort_pipeline(argv[2], argc > 3 ? std::stoul(argv[3]) : 0);
+            return 0;
+        }
+        
+        // 查询 trace 录制 / 回放
+        if (arg == "trace") {
+            if (argc < 4) {
+                std::cout << "\n  Usage: ./prefetch_bench trace <dataset> <file> [ops] [range%]" << std::endl;
+                std::cout << "  Example: ./prefetch_bench trace books_200M data/books_mixed.trace 10000000 5" << std::endl;
+                return 1;
+            }
+            
+            size_t ops = (argc > 4) ? std::stoull(argv[4]) : 10'000'000;
+            double range_pct = (argc > 5) ? std::stod(argv[5]) : 0.0;
+            record_query_trace(argv[2], argv[3], ops, range_pct);
+            return 0;
+        }
+        
+        if (arg == "replay") {
+            if (argc < 4) {
+                std::cout << "\n  Usage: ./prefetch_bench replay <dataset> <file>" << std::endl;
+                std::cout << "  Example: ./prefetch_bench replay books_200M data/books_mixed.trace" << std::endl;
+                return 1;
+            }
+            
+            replay_query_trace(argv[2], argv[3]);
+            return 0;
+        }
+        
+        // 实验矩阵
+        if (arg == "matrix") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench matrix <experiment.ini>" << std::endl;
+                std::cout << "  Example: ./prefetch_bench matrix experiments/slots.ini" << std::endl;
+                return 1;
+            }
+            
+            run_experiment_matrix(argv[2]);
+            return 0;
+        }
+        
+        // 数据规模扫描测试
+        if (arg == "sweep") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench sweep <dataset> [structures] [csv]" << std::endl;
+                std::cout << "  Structures: comma separated, btree / btree_bulk take a slot count (default btree_bulk/16,btree_bulk/64)" << std::endl;
+                std::cout << "  Example: ./prefetch_bench sweep books_200M btree_bulk/16,btree_bulk/64,stree sweep_books.csv" << std::endl;
+                return 1;
+            }
+            
+            std::vector<std::string> structures = split_list((argc > 3) ? argv[3] : "btree_bulk/16,btree_bulk/64");
+            
+            for (const auto& s : structures) {
+                std::string name = s.substr(0, s.find('/'));
+                std::string slots = (name.size() < s.size()) ? s.substr(name.size() + 1) : "";
+                if (!slots.empty() && slots.find_first_not_of("0123456789") != std::string::npos) slots.clear();
+                if (!dispatch_matrix_index(name, slots.empty() ? 0 : std::stoul(slots), [](auto) {})) {
+                    std::cerr << "  Unknown structure: " << s << std::endl;
+                    return 1;
+                }
+            }
+            
+            compare_size_sweep(argv[2], structures, argc > 4 ? argv[4] : "");
+            return 0;
+        }
+        
+        // 带宽干扰测试
+        if (arg == "noise") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench noise <dataset> [threads] [stream|random]" << std::endl;
+                std::cout << "  Example: ./prefetch_bench noise books_200M 8 stream" << std::endl;
+                return 1;
+            }
+            
+            BandwidthNoise::Pattern pattern = BandwidthNoise::Pattern::Stream;
+            if (argc > 4 && !BandwidthNoise::parse(argv[4], pattern)) {
+                std::cerr << "  Unknown noise pattern: " << argv[4] << " (stream, random)" << std::endl;
+                return 1;
+            }
+            compare_bandwidth_noise(argv[2], argc > 3 ? std::stoul(argv[3]) : 0, pattern);
+            return 0;
+        }
+        
+        // 查询间合成负载测试
+        if (arg == "work") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench work <dataset> [compute[:bytes],...]" << std::endl;
+                std::cout << "  Example: ./prefetch_bench work books_200M 0,100,400,0:4k,100:32k" << std::endl;
+                return 1;
+            }
+            
+            compare_synthetic_work(argv[2], split_list(argc > 3 ? argv[3] : ""));
+            return 0;
+        }
+        
+        // 缓存 / TLB 模拟：按 slot size 预测查找缺失数
+        if (arg == "cachesim") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench cachesim <dataset> [queries] [trace_prefix]" << std::endl;
+                std::cout << "  Example: ./prefetch_bench cachesim books_200M 200000 traces/books" << std::endl;
+                return 1;
+            }
+            
+            compare_simulated_slot_sizes(argv[2], argc > 3 ? std::stoull(argv[3]) : 200'000,
+                                         argc > 4 ? argv[4] : "");
+            return 0;
+        }
+        
+        // 访存校准（已在上面运行），可选把结果写成元数据文件
+        if (arg == "calibrate") {
+            if (argc > 2) {
+                std::ofstream out(argv[2], std::ios::trunc);
+                MemoryCalibration::current()->write_metadata(out, "");
+                std::cout << "\n  ✓ Calibration written to " << argv[2] << std::endl;
+            }
             return 0;
         }
         
-        // 测试单个数据集
-        auto result = test_sosd_dataset(arg);
-        if (result.data_size > 0) {
+        // 数组基线对比测试
+        if (arg == "eytzinger") {
+            if (argc < 3) {
+                std::cout << "\n  Usage: ./prefetch_bench eytzinger <dataset>" << std::endl;
+                std::cout << "  Example: ./prefetch_bench eytzinger books_200M" << std::endl;
+                return 1;
+            }
+            
+            compare_array_baselines(argv[2]);
+            return 0;
+        }
+        
+        // 测试单个数据集，可选逗号分隔的结构列表，如 stx,stree
+        std::vector<std::string> structures = split_list((argc > 2) ? argv[2] : "stx");
+        
+        auto results = test_sosd_dataset(arg, structures);
+        for (const auto& result : results) {
             result.print();
         }
     } else {
         // 默认帮助信息
         std::cout << "\n  Usage:" << std::endl;
-        std::cout << "    ./prefetch_bench generate <size> <type>   # Generate dataset" << std::endl;
-        std::cout << "    ./prefetch_bench <dataset>                # Test with default (16 slots)" << std::endl;
-        std::cout << "    ./prefetch_bench compare <dataset>        # Compare slot sizes (16-128)" << std::endl;
+        std::cout << "    ./prefetch_bench generate <size> <type>   # Generate dataset (random / sorted / partial," << std::endl;
+        std::cout << "                                              #   uniform / normal / lognormal / clustered / zipf / sosd)" << std::endl;
+        std::cout << "    ./prefetch_bench <dataset> [structures]   # Test structures, comma separated (default: stx)" << std::endl;
+        std::cout << "                                              #   stx, stree, eytzinger, rmi[_prefetch], pgm[_prefetch], art[_bulk], cbtree" << std::endl;
+        std::cout << "    ./prefetch_bench compare <dataset> [stx|csb]  # Compare slot sizes (16-80)" << std::endl;
+        std::cout << "    ./prefetch_bench batch <dataset>          # Batch insert vs per-key insert" << std::endl;
+        std::cout << "    ./prefetch_bench eytzinger <dataset>      # Eytzinger / lower_bound vs B+ tree slots" << std::endl;
+        std::cout << "    ./prefetch_bench radix <dataset>          # Radix table start node vs root descent" << std::endl;
+        std::cout << "    ./prefetch_bench levels <dataset>         # Cycles per tree level during find()" << std::endl;
+        std::cout << "    ./prefetch_bench fill <dataset>           # Fill factor / memory: insert-built vs bulk-loaded" << std::endl;
+        std::cout << "    ./prefetch_bench pipeline <dataset> [D]   # Prefetch leaf of query i+D (sweep D if omitted)" << std::endl;
+        std::cout << "    ./prefetch_bench policy <dataset> [D]     # Prefetch scope (keys/node) x hint (T0/T1/T2/NTA/W)" << std::endl;
+        std::cout << "    ./prefetch_bench layout <dataset>         # Leaf layout: split / interleaved / blocked key-value slots" << std::endl;
+        std::cout << "    ./prefetch_bench childref <dataset>       # 8-byte child pointers vs 32-bit node pool indices" << std::endl;
+        std::cout << "    ./prefetch_bench compress <dataset>[,...] # Delta-compressed leaves: width mix, ratio, latency" << std::endl;
+        std::cout << "    ./prefetch_bench snapshot <dataset> [img] [--rewrite]  # Startup from an mmap snapshot (vs rebuild / restore() when writing it)" << std::endl;
+        std::cout << "    ./prefetch_bench sort <dataset> [threads] # Sort + dedup stage: std::sort vs parallel LSD / MSD radix" << std::endl;
+        std::cout << "    ./prefetch_bench trace <dataset> <file> [ops] [range%]  # Record a lookup / range query trace" << std::endl;
+        std::cout << "    ./prefetch_bench replay <dataset> <file>  # Stream a query trace through the B+ tree" << std::endl;
+        std::cout << "    ./prefetch_bench matrix <experiment.ini>  # Run every cell of a dataset x structure x engine x thread matrix" << std::endl;
+        std::cout << "    ./prefetch_bench sweep <dataset> [structures] [csv]  # Log-spaced sampled sizes 1K..N, annotate cache cliffs" << std::endl;
+        std::cout << "    ./prefetch_bench calibrate [file]         # L1/L2/LLC/DRAM latency, MLP and bandwidth of this host" << std::endl;
+        std::cout << "    ./prefetch_bench noise <dataset> [threads] [stream|random]  # Lookups + leaf prefetch under background bandwidth load" << std::endl;
+        std::cout << "    ./prefetch_bench work <dataset> [compute[:bytes],...]  # Lookups interleaved with synthetic compute / cache-polluting work" << std::endl;
+        std::cout << "    ./prefetch_bench cachesim <dataset> [queries] [trace_prefix]  # Replay lookup traces in a cache/TLB simulator, rank slot sizes" << std::endl;
+        std::cout << "\n  Options (any mode):" << std::endl;
+        std::cout << "    --pages=4k|thp|2m|1g                      # Page size of key / query buffers (falls back if unavailable)" << std::endl;
+        std::cout << "    --trace=<file>                            # Replay the lookups of a query trace instead of generating queries" << std::endl;
+        std::cout << "    --record=<file>                           # Record the generated queries as a query trace" << std::endl;
+        std::cout << "    --calibrate                               # Calibrate memory first; report lookups as DRAM-miss equivalents" << std::endl;
+        std::cout << "    --work=<compute>[:<bytes>]                # Run synthetic work after each lookup; report cost minus the work" << std::endl;
         std::cout << "\n  Examples:" << std::endl;
         std::cout << "    ./prefetch_bench generate 200000000 random" << std::endl;
         std::cout << "    ./prefetch_bench books_200M" << std::endl;
+        std::cout << "    ./prefetch_bench books_200M stx,stree" << std::endl;
+        std::cout << "    ./prefetch_bench osm_cellids_200M stx,rmi,pgm,pgm_prefetch" << std::endl;
+        std::cout << "    ./prefetch_bench books_200M stx,art,art_bulk" << std::endl;
+        std::cout << "    ./prefetch_bench books_200M stx --pages=2m" << std::endl;
         std::cout << "    ./prefetch_bench compare books_200M" << std::endl;
         std::cout << "    ./prefetch_bench compare custom_random_200000000" << std::endl;
+        std::cout << "    ./prefetch_bench compare books_200M csb" << std::endl;
+        std::cout << "    ./prefetch_bench batch books_200M" << std::endl;
     }
     
     return 0;